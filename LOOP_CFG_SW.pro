@@ -1,6 +1,6 @@
 QT       += core gui
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets charts serialport
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets charts serialport concurrent qml network svg
 
 CONFIG += c++17
 
@@ -9,21 +9,124 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    calibrationdialog.cpp \
+    calibrationmonitor.cpp \
+    capturealign.cpp \
+    captureio.cpp \
+    chartcursor.cpp \
+    chartexport.cpp \
+    comparedialog.cpp \
     eepromdialog.cpp \
+    eventindex.cpp \
+    eventlistdialog.cpp \
+    exportdialog.cpp \
+    filterdialog.cpp \
+    framedecoder.cpp \
+    frameserver.cpp \
+    frametiming.cpp \
+    journalreplay.cpp \
+    liveframe.cpp \
+    loopfilter.cpp \
+    looptrace.cpp \
     main.cpp \
     mainwindow.cpp \
-    parametersdialog.cpp
+    messagebus.cpp \
+    metricsserver.cpp \
+    parametersdialog.cpp \
+    portscanner.cpp \
+    rollingstats.cpp \
+    samplestore.cpp \
+    scriptdialog.cpp \
+    scriptrunner.cpp \
+    serialjournal.cpp \
+    sessionsnapshot.cpp \
+    simdkernels.cpp \
+    statisticsdialog.cpp \
+    telemetrydock.cpp \
+    trafficcounter.cpp \
+    trafficdialog.cpp \
+    trendarchive.cpp \
+    trenddialog.cpp \
+    triggerdialog.cpp \
+    triggerengine.cpp \
+    waterfallview.cpp
 
 HEADERS += \
+    calibrationdialog.h \
+    calibrationmonitor.h \
+    capturealign.h \
+    captureio.h \
+    chartcursor.h \
+    chartexport.h \
+    comparedialog.h \
     eepromdialog.h \
+    eventindex.h \
+    eventlistdialog.h \
+    exportdialog.h \
+    filterdialog.h \
+    framedecoder.h \
+    frameserver.h \
+    frametiming.h \
+    journalreplay.h \
+    liveframe.h \
+    loopfilter.h \
+    looptrace.h \
     mainwindow.h \
-    parametersdialog.h
+    messagebus.h \
+    metricsserver.h \
+    parametersdialog.h \
+    portscanner.h \
+    rollingstats.h \
+    samplestore.h \
+    scriptdialog.h \
+    scriptrunner.h \
+    serialjournal.h \
+    sessionsnapshot.h \
+    simdkernels.h \
+    statisticsdialog.h \
+    telemetrydock.h \
+    trafficcounter.h \
+    trafficdialog.h \
+    trendarchive.h \
+    trenddialog.h \
+    triggerdialog.h \
+    triggerengine.h \
+    waterfallview.h
 
 FORMS += \
     eepromdialog.ui \
     mainwindow.ui \
     parametersdialog.ui
 
+# Soak test build: "qmake CONFIG+=soak" builds LOOP_CFG_SW_soak with the
+# --soak harness, the synthetic device and the allocation hook; the
+# regular application contains none of them.
+CONFIG(soak) {
+    TARGET = LOOP_CFG_SW_soak
+    DEFINES += LOOP_SOAK
+    CONFIG -= app_bundle
+
+    SOURCES += \
+        allocationhook.cpp \
+        soaktest.cpp \
+        syntheticdevice.cpp
+
+    HEADERS += \
+        allocationhook.h \
+        soaktest.h \
+        syntheticdevice.h
+
+    # Import table walk and RSS sampling
+    win32: LIBS += -lpsapi
+
+    # "make soak": one hour soak test of the built binary. DESTDIR is set
+    # so the binary is at the same place in debug_and_release builds.
+    DESTDIR = $$OUT_PWD
+    soak.commands = $$shell_path($$DESTDIR/$$TARGET) --soak --soak-minutes 60 --soak-report soak.csv
+    soak.depends = first
+    QMAKE_EXTRA_TARGETS += soak
+}
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
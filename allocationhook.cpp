@@ -0,0 +1,189 @@
+// allocationhook.cpp
+#include "allocationhook.h"
+#include <atomic>
+#include <cstdlib>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#include <cstring>
+#endif
+
+namespace {
+std::atomic<quint64> allocations{0};
+
+inline void countOne()
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+}
+}
+
+#if defined(Q_OS_WIN)
+
+namespace {
+using MallocFn = void *(__cdecl *)(size_t);
+using CallocFn = void *(__cdecl *)(size_t, size_t);
+using ReallocFn = void *(__cdecl *)(void *, size_t);
+
+// Modules may import from different C runtimes (msvcrt, ucrtbase, the
+// debug runtimes). A block has to go back to the runtime it came from,
+// so every runtime gets its own set of hooks forwarding to its own
+// functions.
+const int maxRuntimes = 4;
+MallocFn realMalloc[maxRuntimes];
+CallocFn realCalloc[maxRuntimes];
+ReallocFn realRealloc[maxRuntimes];
+
+template <int N> void *__cdecl countingMalloc(size_t size)
+{
+    countOne();
+    return realMalloc[N](size);
+}
+
+template <int N> void *__cdecl countingCalloc(size_t count, size_t size)
+{
+    countOne();
+    return realCalloc[N](count, size);
+}
+
+template <int N> void *__cdecl countingRealloc(void *p, size_t size)
+{
+    countOne();
+    return realRealloc[N](p, size);
+}
+
+const MallocFn mallocHooks[maxRuntimes] = {
+    countingMalloc<0>, countingMalloc<1>, countingMalloc<2>, countingMalloc<3>};
+const CallocFn callocHooks[maxRuntimes] = {
+    countingCalloc<0>, countingCalloc<1>, countingCalloc<2>, countingCalloc<3>};
+const ReallocFn reallocHooks[maxRuntimes] = {
+    countingRealloc<0>, countingRealloc<1>, countingRealloc<2>, countingRealloc<3>};
+
+// The hook for an imported function, taking a free slot for a runtime
+// not seen before. Returns the function itself when out of slots.
+template <typename Fn>
+Fn hookFor(Fn imported, Fn (&real)[maxRuntimes], const Fn (&hooks)[maxRuntimes])
+{
+    for (int i = 0; i < maxRuntimes; ++i) {
+        if (hooks[i] == imported || real[i] == imported)
+            return hooks[i];
+    }
+    for (int i = 0; i < maxRuntimes; ++i) {
+        if (!real[i]) {
+            real[i] = imported;
+            return hooks[i];
+        }
+    }
+    return imported;
+}
+
+bool isRuntime(const char *dll)
+{
+    return _strnicmp(dll, "msvcr", 5) == 0
+        || _strnicmp(dll, "ucrtbase", 8) == 0
+        || _strnicmp(dll, "api-ms-win-crt-heap", 19) == 0;
+}
+
+void patchSlot(ULONG_PTR *slot, ULONG_PTR function)
+{
+    if (*slot == function)
+        return;
+    DWORD protection;
+    if (!VirtualProtect(slot, sizeof(*slot), PAGE_READWRITE, &protection))
+        return;
+    *slot = function;
+    VirtualProtect(slot, sizeof(*slot), protection, &protection);
+}
+
+// Points the malloc, calloc and realloc entries of a module's import
+// table at the counting hooks
+void patchModule(HMODULE module)
+{
+    auto *base = reinterpret_cast<BYTE *>(module);
+    const auto *dos = reinterpret_cast<const IMAGE_DOS_HEADER *>(base);
+    const auto *nt = reinterpret_cast<const IMAGE_NT_HEADERS *>(base + dos->e_lfanew);
+    const IMAGE_DATA_DIRECTORY &imports = nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+    if (!imports.VirtualAddress)
+        return;
+
+    for (auto *desc = reinterpret_cast<IMAGE_IMPORT_DESCRIPTOR *>(base + imports.VirtualAddress);
+         desc->Name; ++desc) {
+        if (!desc->OriginalFirstThunk || !isRuntime(reinterpret_cast<const char *>(base + desc->Name)))
+            continue;
+        auto *names = reinterpret_cast<IMAGE_THUNK_DATA *>(base + desc->OriginalFirstThunk);
+        auto *slots = reinterpret_cast<IMAGE_THUNK_DATA *>(base + desc->FirstThunk);
+        for (; names->u1.AddressOfData; ++names, ++slots) {
+            if (IMAGE_SNAP_BY_ORDINAL(names->u1.Ordinal))
+                continue;
+            const char *name = reinterpret_cast<const IMAGE_IMPORT_BY_NAME *>(
+                                   base + names->u1.AddressOfData)->Name;
+            ULONG_PTR *slot = &slots->u1.Function;
+            if (std::strcmp(name, "malloc") == 0)
+                patchSlot(slot, ULONG_PTR(hookFor(MallocFn(*slot), realMalloc, mallocHooks)));
+            else if (std::strcmp(name, "calloc") == 0)
+                patchSlot(slot, ULONG_PTR(hookFor(CallocFn(*slot), realCalloc, callocHooks)));
+            else if (std::strcmp(name, "realloc") == 0)
+                patchSlot(slot, ULONG_PTR(hookFor(ReallocFn(*slot), realRealloc, reallocHooks)));
+        }
+    }
+}
+}
+
+bool AllocationHook::install()
+{
+    HMODULE modules[1024];
+    DWORD needed = 0;
+    if (!EnumProcessModules(GetCurrentProcess(), modules, sizeof(modules), &needed))
+        return false;
+    const DWORD count = qMin<DWORD>(needed, sizeof(modules)) / sizeof(HMODULE);
+    for (DWORD i = 0; i < count; ++i)
+        patchModule(modules[i]);
+    return true;
+}
+
+#elif defined(__GLIBC__)
+
+// Interposed for the executable and every shared library; operator new
+// in libstdc++ ends up here too
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *p, size_t size);
+
+void *malloc(size_t size) noexcept
+{
+    countOne();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept
+{
+    countOne();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *p, size_t size) noexcept
+{
+    countOne();
+    return __libc_realloc(p, size);
+}
+}
+
+bool AllocationHook::install()
+{
+    return true;
+}
+
+#else
+
+bool AllocationHook::install()
+{
+    return false;
+}
+
+#endif
+
+quint64 AllocationHook::count()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,23 @@
+// allocationhook.h
+#ifndef ALLOCATIONHOOK_H
+#define ALLOCATIONHOOK_H
+
+#include <QtGlobal>
+
+// Counts heap allocations of the whole process, the Qt libraries
+// included, at the C runtime level: malloc, calloc and realloc. Only
+// linked into the soak build (CONFIG+=soak).
+//
+// With glibc the three functions are interposed for every module from
+// process start. On Windows install() redirects the CRT imports of the
+// modules loaded so far (the executable, Qt and its plugins), so call it
+// once the main window exists.
+namespace AllocationHook {
+
+// False where allocations cannot be counted; count() then stays 0
+bool install();
+quint64 count();
+
+}
+
+#endif // ALLOCATIONHOOK_H
@@ -0,0 +1,129 @@
+// calibrationdialog.cpp
+#include "calibrationdialog.h"
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+CalibrationDialog::CalibrationDialog(CalibrationMonitor *monitor, QWidget *parent)
+    : QDialog(parent), monitor(monitor)
+{
+    setWindowTitle(tr("Calibration Monitor"));
+
+    const CalibrationCriteria &c = monitor->criteria();
+    auto makeSpin = [this](double min, double max, double value, const QString &suffix) {
+        auto *spin = new QDoubleSpinBox(this);
+        spin->setRange(min, max);
+        spin->setDecimals(1);
+        spin->setValue(value);
+        spin->setSuffix(suffix);
+        return spin;
+    };
+    windowSpin = makeSpin(0.5, 600.0, c.windowS, tr(" s"));
+    driftSpin = makeSpin(0.1, 100000.0, c.maxDrift, QString());
+    stdSpin = makeSpin(0.1, 100000.0, c.maxStd, QString());
+    timeoutSpin = makeSpin(5.0, 3600.0, c.timeoutS, tr(" s"));
+
+    loopCheck[0] = new QCheckBox(tr("Loop 1"), this);
+    loopCheck[1] = new QCheckBox(tr("Loop 2"), this);
+    loopCheck[0]->setChecked(true);
+    loopCheck[1]->setChecked(true);
+
+    startBtn = new QPushButton(tr("Start Calibration"), this);
+    connect(startBtn, &QPushButton::clicked, this, &CalibrationDialog::onStartClicked);
+    abortBtn = new QPushButton(tr("Abort"), this);
+    connect(abortBtn, &QPushButton::clicked, monitor, &CalibrationMonitor::abort);
+
+    table = new QTableWidget(2, ColumnCount, this);
+    table->setHorizontalHeaderLabels({tr("State"), tr("Elapsed"), tr("Converged After"),
+                                      tr("Baseline"), tr("Drift"), tr("Std"), tr("Note")});
+    table->setVerticalHeaderLabels({tr("Loop 1"), tr("Loop 2")});
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    for (int row = 0; row < 2; ++row) {
+        for (int col = 0; col < ColumnCount; ++col) {
+            auto *item = new QTableWidgetItem;
+            if (col != ColState && col != ColNote)
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            table->setItem(row, col, item);
+        }
+    }
+
+    auto *form = new QFormLayout;
+    form->addRow(tr("Stable for:"), windowSpin);
+    form->addRow(tr("Max baseline drift:"), driftSpin);
+    form->addRow(tr("Max std:"), stdSpin);
+    form->addRow(tr("Timeout:"), timeoutSpin);
+
+    auto *btnLayout = new QVBoxLayout;
+    btnLayout->addWidget(loopCheck[0]);
+    btnLayout->addWidget(loopCheck[1]);
+    btnLayout->addStretch();
+    btnLayout->addWidget(startBtn);
+    btnLayout->addWidget(abortBtn);
+
+    auto *top = new QHBoxLayout;
+    top->addLayout(form);
+    top->addStretch();
+    top->addLayout(btnLayout);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(top);
+    mainLayout->addWidget(table);
+
+    setMinimumSize(850, 300);
+
+    // Baseline and drift change every frame; repainted at a fixed rate
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(250);
+    connect(refreshTimer, &QTimer::timeout, this, &CalibrationDialog::refresh);
+    connect(monitor, &CalibrationMonitor::loopChanged, this, &CalibrationDialog::refresh);
+    refresh();
+}
+
+void CalibrationDialog::onStartClicked()
+{
+    CalibrationCriteria c = monitor->criteria();
+    c.windowS = windowSpin->value();
+    c.maxDrift = driftSpin->value();
+    c.maxStd = stdSpin->value();
+    c.timeoutS = timeoutSpin->value();
+    monitor->setCriteria(c);
+
+    const int mask = (loopCheck[0]->isChecked() ? 1 : 0) | (loopCheck[1]->isChecked() ? 2 : 0);
+    if (mask)
+        emit startRequested(mask);
+}
+
+void CalibrationDialog::refresh()
+{
+    const bool running = monitor->isRunning();
+    startBtn->setEnabled(!running);
+    abortBtn->setEnabled(running);
+    if (running && !refreshTimer->isActive())
+        refreshTimer->start();
+    else if (!running)
+        refreshTimer->stop();
+
+    for (int row = 0; row < 2; ++row) {
+        const CalibrationResult &r = monitor->result(row + 1);
+        const bool idle = r.state == CalIdle;
+        table->item(row, ColState)->setText(CalibrationMonitor::stateName(r.state));
+        table->item(row, ColElapsed)->setText(idle ? QString() : QString::number(r.elapsedS, 'f', 1));
+        table->item(row, ColConverge)->setText(r.convergeS >= 0.0 ? tr("%1 s").arg(r.convergeS, 0, 'f', 1)
+                                                                  : QString());
+        table->item(row, ColBaseline)->setText(idle ? QString() : QString::number(r.baseline, 'f', 1));
+        table->item(row, ColDrift)->setText(r.state >= CalSettling ? QString::number(r.drift, 'f', 1)
+                                                                    : QString());
+        table->item(row, ColStd)->setText(idle ? QString() : QString::number(r.std, 'f', 1));
+        table->item(row, ColNote)->setText(r.note);
+
+        QColor color;
+        if (r.state == CalConverged)
+            color = QColor(200, 255, 200);
+        else if (r.state == CalFailed)
+            color = QColor(255, 200, 200);
+        for (int col = 0; col < ColumnCount; ++col)
+            table->item(row, col)->setBackground(color);
+    }
+}
@@ -0,0 +1,48 @@
+// calibrationdialog.h
+#ifndef CALIBRATIONDIALOG_H
+#define CALIBRATIONDIALOG_H
+
+#include <QDialog>
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+
+#include "calibrationmonitor.h"
+
+// Starts calibration of the selected loops and shows how each converges
+class CalibrationDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit CalibrationDialog(CalibrationMonitor *monitor, QWidget *parent = nullptr);
+
+signals:
+    void startRequested(int loopMask);  // bit 0 loop 1, bit 1 loop 2
+
+public slots:
+    void refresh();
+
+private slots:
+    void onStartClicked();
+
+private:
+    enum Column {
+        ColState, ColElapsed, ColConverge, ColBaseline, ColDrift, ColStd, ColNote,
+        ColumnCount
+    };
+
+    CalibrationMonitor *monitor;
+    QCheckBox      *loopCheck[2];
+    QDoubleSpinBox *windowSpin;
+    QDoubleSpinBox *driftSpin;
+    QDoubleSpinBox *stdSpin;
+    QDoubleSpinBox *timeoutSpin;
+    QPushButton    *startBtn;
+    QPushButton    *abortBtn;
+    QTableWidget   *table;
+    QTimer         *refreshTimer;
+};
+
+#endif // CALIBRATIONDIALOG_H
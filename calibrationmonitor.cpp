@@ -0,0 +1,137 @@
+// calibrationmonitor.cpp
+#include "calibrationmonitor.h"
+
+CalibrationMonitor::CalibrationMonitor(QObject *parent)
+    : QObject(parent)
+{
+    clock.start();
+    timeoutTimer = new QTimer(this);
+    timeoutTimer->setInterval(500);
+    connect(timeoutTimer, &QTimer::timeout, this, &CalibrationMonitor::checkTimeouts);
+}
+
+QString CalibrationMonitor::stateName(CalibrationState state)
+{
+    switch (state) {
+    case CalIdle:      return tr("Idle");
+    case CalRequested: return tr("Requested");
+    case CalRunning:   return tr("Calibrating");
+    case CalSettling:  return tr("Settling");
+    case CalConverged: return tr("Converged");
+    case CalFailed:    return tr("Not settled");
+    }
+    return QString();
+}
+
+bool CalibrationMonitor::isRunning(int loop) const
+{
+    const CalibrationState s = results[loop - 1].state;
+    return s == CalRequested || s == CalRunning || s == CalSettling;
+}
+
+bool CalibrationMonitor::isRunning() const
+{
+    return isRunning(1) || isRunning(2);
+}
+
+void CalibrationMonitor::start(int loop)
+{
+    const int i = loop - 1;
+    results[i] = CalibrationResult();
+    results[i].state = CalRequested;
+    startUs[i] = clock.nsecsElapsed() / 1000;
+    baseStats[i].setWindow(qint64(crit.windowS * 1e6));
+    baseStats[i].reset();
+    timeoutTimer->start();
+    emit loopChanged(loop);
+}
+
+void CalibrationMonitor::abort()
+{
+    for (int i = 0; i < 2; ++i) {
+        if (isRunning(i + 1))
+            finish(i, CalFailed, tr("Aborted"));
+    }
+}
+
+void CalibrationMonitor::addFrame(const LiveFrame &frame)
+{
+    if (!isRunning())
+        return;
+    const qint64 now = clock.nsecsElapsed() / 1000;
+    const qint64 windowUs = qint64(crit.windowS * 1e6);
+
+    for (int i = 0; i < 2; ++i) {
+        if (!isRunning(i + 1))
+            continue;
+        const LiveField calField = i ? FieldCal1 : FieldCal0;
+        const LiveField baseField = i ? FieldBase1 : FieldBase0;
+        const LiveField stdField = i ? FieldStd1 : FieldStd0;
+        if (!frame.isValid(calField) || !frame.isValid(baseField) || !frame.isValid(stdField))
+            continue;
+        const bool cal = frame.value(calField) != 0.0;
+        CalibrationResult &r = results[i];
+        r.elapsedS = (now - startUs[i]) / 1e6;
+        r.baseline = frame.value(baseField);
+        r.std = frame.value(stdField);
+
+        const CalibrationState before = r.state;
+        if (cal) {
+            r.state = CalRunning;
+        } else if (r.state == CalRunning
+                   || (r.state == CalRequested && r.elapsedS >= crit.startTimeoutS)) {
+            // A calibration quicker than one frame never shows the flag
+            if (r.state == CalRequested)
+                r.note = tr("cal flag not seen");
+            r.state = CalSettling;
+            settleUs[i] = now;
+            stdOkUs[i] = now;
+            baseStats[i].reset();
+        }
+
+        if (r.state == CalSettling) {
+            baseStats[i].add(r.baseline, now);
+            r.drift = baseStats[i].windowMax() - baseStats[i].windowMin();
+            if (r.std > crit.maxStd)
+                stdOkUs[i] = now;
+            if (now - settleUs[i] >= windowUs && now - stdOkUs[i] >= windowUs
+                && r.drift <= crit.maxDrift) {
+                r.convergeS = (now - windowUs - startUs[i]) / 1e6;
+                finish(i, CalConverged, r.note);
+                continue;
+            }
+        }
+        if (r.state != before)
+            emit loopChanged(i + 1);
+    }
+    checkTimeouts();
+}
+
+void CalibrationMonitor::checkTimeouts()
+{
+    const qint64 now = clock.nsecsElapsed() / 1000;
+    for (int i = 0; i < 2; ++i) {
+        if (!isRunning(i + 1) || now - startUs[i] < qint64(crit.timeoutS * 1e6))
+            continue;
+        CalibrationResult &r = results[i];
+        r.elapsedS = (now - startUs[i]) / 1e6;
+        QString note;
+        if (r.state == CalRequested)
+            note = tr("no LIVE frames");
+        else if (r.state == CalRunning)
+            note = tr("still calibrating");
+        else
+            note = tr("drift %1, std %2").arg(r.drift, 0, 'f', 1).arg(r.std, 0, 'f', 1);
+        finish(i, CalFailed, note);
+    }
+    if (!isRunning())
+        timeoutTimer->stop();
+}
+
+void CalibrationMonitor::finish(int index, CalibrationState state, const QString &note)
+{
+    results[index].state = state;
+    results[index].note = note;
+    emit loopChanged(index + 1);
+    emit loopFinished(index + 1);
+}
@@ -0,0 +1,84 @@
+// calibrationmonitor.h
+#ifndef CALIBRATIONMONITOR_H
+#define CALIBRATIONMONITOR_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include "liveframe.h"
+#include "rollingstats.h"
+
+// When a calibrating loop counts as settled
+struct CalibrationCriteria {
+    double windowS = 3.0;       // baseline and std must hold this long
+    double maxDrift = 5.0;      // max - min of base* over the window
+    double maxStd = 20.0;       // std* limit over the window
+    double startTimeoutS = 3.0; // cal* flag expected to rise within this
+    double timeoutS = 60.0;     // give up after this
+};
+
+enum CalibrationState {
+    CalIdle,
+    CalRequested,   // cal command sent, cal* flag not seen yet
+    CalRunning,     // cal* flag set
+    CalSettling,    // cal* flag cleared, waiting for a stable baseline
+    CalConverged,
+    CalFailed
+};
+
+struct CalibrationResult {
+    CalibrationState state = CalIdle;
+    double elapsedS = 0.0;
+    double convergeS = -1.0;    // start of the stable window, from the cal command
+    double baseline = 0.0;      // last base* value
+    double drift = 0.0;         // base* max - min over the window
+    double std = 0.0;           // last std* value
+    QString note;
+};
+
+// Follows the cal*, base* and std* LIVE fields of loops being
+// calibrated. A loop converges once its cal flag has cleared and the
+// baseline has stayed within maxDrift, with std* at or below maxStd, for
+// windowS; it fails when that does not happen within timeoutS.
+class CalibrationMonitor : public QObject {
+    Q_OBJECT
+
+public:
+    explicit CalibrationMonitor(QObject *parent = nullptr);
+
+    void setCriteria(const CalibrationCriteria &criteria) { crit = criteria; }
+    const CalibrationCriteria &criteria() const { return crit; }
+
+    void start(int loop);       // 1 or 2, after the cal command was sent
+    void abort();
+    void addFrame(const LiveFrame &frame);
+
+    bool isRunning() const;
+    bool isRunning(int loop) const;
+    const CalibrationResult &result(int loop) const { return results[loop - 1]; }
+
+    static QString stateName(CalibrationState state);
+
+signals:
+    void loopChanged(int loop);
+    void loopFinished(int loop);
+
+private slots:
+    void checkTimeouts();
+
+private:
+    void finish(int index, CalibrationState state, const QString &note);
+
+    CalibrationCriteria crit;
+    CalibrationResult results[2];
+    RollingStats baseStats[2];  // window min/max of base* while settling
+    qint64 startUs[2] = {};
+    qint64 settleUs[2] = {};    // cal* flag cleared
+    qint64 stdOkUs[2] = {};     // std* continuously within limit since
+    QElapsedTimer clock;
+    QTimer *timeoutTimer;       // frames may stop arriving altogether
+};
+
+#endif // CALIBRATIONMONITOR_H
@@ -0,0 +1,139 @@
+// capturealign.cpp
+#include "capturealign.h"
+#include "simdkernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const int coarsestSize = 4096;   // full lag search happens at this length
+const int refineRadius = 6;      // lags searched around the coarser result
+
+QVector<float> normalized(const QVector<float> &v)
+{
+    double sum = 0.0, sumSq = 0.0;
+    for (float x : v) {
+        sum += x;
+        sumSq += double(x) * x;
+    }
+    const double mean = sum / v.size();
+    const double var = sumSq / v.size() - mean * mean;
+    const float scale = var > 0.0 ? float(1.0 / std::sqrt(var)) : 0.0f;
+    QVector<float> out(v.size());
+    for (int i = 0; i < v.size(); ++i)
+        out[i] = float(v[i] - mean) * scale;
+    return out;
+}
+
+// Mean product over the overlap, -inf when it is shorter than minCount
+double correlation(const QVector<float> &a, const QVector<float> &b, int lag, int minCount)
+{
+    const int start = qMax(0, -lag);
+    const int end = qMin(int(b.size()), int(a.size()) - lag);
+    const int count = end - start;
+    if (count < qMax(1, minCount))
+        return -std::numeric_limits<double>::infinity();
+    return SimdKernels::dot(a.constData() + start + lag, b.constData() + start, count) / count;
+}
+
+int bestLag(const QVector<float> &a, const QVector<float> &b, int from, int to,
+            int minCount, double &best)
+{
+    int lag = from;
+    best = -std::numeric_limits<double>::infinity();
+    for (int l = from; l <= to; ++l) {
+        const double c = correlation(a, b, l, minCount);
+        if (c > best) {
+            best = c;
+            lag = l;
+        }
+    }
+    return lag;
+}
+
+} // namespace
+
+bool alignByCorrelation(const QVector<float> &a, const QVector<float> &b,
+                        int &lag, double *score, double minOverlap)
+{
+    if (a.size() < 2 || b.size() < 2)
+        return false;
+
+    QList<QVector<float>> pyramidA{normalized(a)};
+    QList<QVector<float>> pyramidB{normalized(b)};
+    while (qMax(pyramidA.last().size(), pyramidB.last().size()) > coarsestSize
+           && qMin(pyramidA.last().size(), pyramidB.last().size()) >= 64) {
+        const QVector<float> &la = pyramidA.last();
+        const QVector<float> &lb = pyramidB.last();
+        QVector<float> da(la.size() / 4), db(lb.size() / 4);
+        SimdKernels::decimate(la.constData(), la.size(), 4, da.data());
+        SimdKernels::decimate(lb.constData(), lb.size(), 4, db.data());
+        pyramidA.append(da);
+        pyramidB.append(db);
+    }
+
+    // Every lag with enough overlap at the coarsest level...
+    int level = pyramidA.size() - 1;
+    const QVector<float> &ca = pyramidA[level];
+    const QVector<float> &cb = pyramidB[level];
+    int minCount = int(qMin(ca.size(), cb.size()) * minOverlap);
+    double best;
+    int l = bestLag(ca, cb, minCount - int(cb.size()), int(ca.size()) - minCount, minCount, best);
+
+    // ...then a few around it on each finer level
+    while (--level >= 0) {
+        const QVector<float> &fa = pyramidA[level];
+        const QVector<float> &fb = pyramidB[level];
+        minCount = int(qMin(fa.size(), fb.size()) * minOverlap);
+        l = bestLag(fa, fb, l * 4 - refineRadius, l * 4 + refineRadius, minCount, best);
+    }
+    if (!std::isfinite(best))
+        return false;
+    lag = l;
+    if (score)
+        *score = best;
+    return true;
+}
+
+bool alignByEvents(const EventIndex &a, const EventIndex &b, int &lag,
+                   int *matched, int toleranceSamples)
+{
+    // Every pairing of an event of b with one of the same kind in a votes
+    // for a lag; the densest cluster of votes wins. The first events of b
+    // are enough voters and keep this linear in the events of a.
+    const int maxVoters = 64;
+    QVector<int> startsA[EventKindCount];
+    QVector<int> startsB[EventKindCount];
+    for (int i = 0; i < a.size(); ++i)
+        startsA[a.at(i).kind].append(a.at(i).firstSample);
+    for (int i = 0; i < b.size(); ++i)
+        startsB[b.at(i).kind].append(b.at(i).firstSample);
+
+    QVector<int> votes;
+    for (int k = 0; k < EventKindCount; ++k) {
+        const int voters = qMin(maxVoters, int(startsB[k].size()));
+        for (int v = 0; v < voters; ++v) {
+            for (int anchor : startsA[k])
+                votes.append(anchor - startsB[k][v]);
+        }
+    }
+    if (votes.isEmpty())
+        return false;
+    std::sort(votes.begin(), votes.end());
+
+    int bestCount = 0;
+    int bestLag = 0;
+    for (int i = 0, j = 0; i < votes.size(); ++i) {
+        while (votes[i] - votes[j] > 2 * toleranceSamples)
+            ++j;
+        if (i - j + 1 > bestCount) {
+            bestCount = i - j + 1;
+            bestLag = votes[(i + j) / 2];
+        }
+    }
+    lag = bestLag;
+    if (matched)
+        *matched = bestCount;
+    return true;
+}
@@ -0,0 +1,23 @@
+// capturealign.h
+#ifndef CAPTUREALIGN_H
+#define CAPTUREALIGN_H
+
+#include <QVector>
+
+#include "eventindex.h"
+
+// Sample lag that lines capture b up with capture a: b[i] matches
+// a[i + lag]. Both functions return false when no lag is found.
+
+// Normalized cross-correlation, searched coarse to fine on a pyramid of
+// 4x decimated copies. Only lags leaving at least minOverlap of the
+// shorter capture overlapping are considered; score is in [-1, 1].
+bool alignByCorrelation(const QVector<float> &a, const QVector<float> &b,
+                        int &lag, double *score = nullptr, double minOverlap = 0.25);
+
+// Lag that makes the most events of the same kind start within
+// toleranceSamples of each other; matched counts the agreeing pairs.
+bool alignByEvents(const EventIndex &a, const EventIndex &b, int &lag,
+                   int *matched = nullptr, int toleranceSamples = 5);
+
+#endif // CAPTUREALIGN_H
@@ -0,0 +1,205 @@
+// captureio.cpp
+#include "captureio.h"
+#include <charconv>
+
+namespace {
+
+const qsizetype blockSize = 1 << 20;
+
+const char *skipSpace(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    return p;
+}
+
+const char *trimEnd(const char *begin, const char *end)
+{
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+        --end;
+    return end;
+}
+
+bool parseDouble(const char *begin, const char *end, double &value)
+{
+    begin = skipSpace(begin, end);
+    end = trimEnd(begin, end);
+    if (begin < end && *begin == '+')
+        ++begin;
+    if (begin == end)
+        return false;
+    const std::from_chars_result r = std::from_chars(begin, end, value);
+    return r.ec == std::errc() && r.ptr == end;
+}
+
+bool isOne(const char *begin, const char *end)
+{
+    begin = skipSpace(begin, end);
+    end = trimEnd(begin, end);
+    return end - begin == 1 && *begin == '1';
+}
+
+} // namespace
+
+CaptureStatus CaptureReader::open(const QString &fileName)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return CaptureOpenFailed;
+    buffer.clear();
+    pos = 0;
+    atEnd = false;
+    skipped = 0;
+    readBytes = 0;
+
+    const char *begin, *end;
+    if (!readLine(begin, end))
+        return CaptureBadHeader;
+    headerLine = QString::fromLatin1(begin, end - begin).trimmed();
+    headerLoop = 0;
+    if (headerLine.startsWith(QLatin1String("#Loop")))
+        headerLoop = headerLine.mid(5).trimmed().toInt();
+    return CaptureOk;
+}
+
+bool CaptureReader::readLine(const char *&begin, const char *&end)
+{
+    for (;;) {
+        const qsizetype nl = buffer.indexOf('\n', pos);
+        if (nl >= 0 || (atEnd && pos < buffer.size())) {
+            const qsizetype stop = nl >= 0 ? nl : buffer.size();
+            begin = buffer.constData() + pos;
+            end = trimEnd(begin, buffer.constData() + stop);
+            pos = stop + 1;
+            return true;
+        }
+        if (atEnd)
+            return false;
+        // Keep the partial line and append the next block behind it
+        buffer.remove(0, pos);
+        pos = 0;
+        const qsizetype kept = buffer.size();
+        buffer.resize(kept + blockSize);
+        const qint64 n = file.read(buffer.data() + kept, blockSize);
+        buffer.resize(kept + qMax<qint64>(0, n));
+        readBytes += qMax<qint64>(0, n);
+        if (n <= 0)
+            atEnd = true;
+    }
+}
+
+bool CaptureReader::next(CaptureRow &row)
+{
+    const char *begin, *end;
+    while (readLine(begin, end)) {
+        // Split into at most 8 columns
+        const char *fields[9];
+        int count = 0;
+        fields[count++] = begin;
+        for (const char *p = begin; p < end && count < 9; ++p) {
+            if (*p == ',')
+                fields[count++] = p + 1;
+        }
+        auto fieldEnd = [&](int i) { return i + 1 < count ? fields[i + 1] - 1 : end; };
+        if (begin == end)
+            continue;
+
+        double index;
+        if (count < 2 || !parseDouble(fields[0], fieldEnd(0), index)
+            || !parseDouble(fields[1], fieldEnd(1), row.value)) {
+            ++skipped;
+            continue;
+        }
+        row.hasTime = count >= 3 && parseDouble(fields[2], fieldEnd(2), row.timeS);
+        row.gap = count >= 4 && isOne(fields[3], fieldEnd(3));
+        row.flags = 0;
+        if (count >= 4 + EventKindCount) {
+            for (int k = 0; k < EventKindCount; ++k) {
+                if (isOne(fields[4 + k], fieldEnd(4 + k)))
+                    row.flags |= 1 << k;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool CaptureWriter::open(const QString &fileName, int loop)
+{
+    file.setFileName(fileName);
+    ok = file.open(QIODevice::WriteOnly | QIODevice::Text);
+    buffer.clear();
+    buffer.reserve(blockSize + 256);
+    buffer += "#Loop " + QByteArray::number(loop) + "\n";
+    return ok;
+}
+
+void CaptureWriter::write(qint64 index, const CaptureRow &row)
+{
+    buffer += QByteArray::number(index);
+    buffer += ',';
+    buffer += QByteArray::number(row.value, 'g', 12);
+    buffer += ',';
+    buffer += QByteArray::number(row.timeS, 'f', 6);
+    buffer += row.gap ? ",1" : ",0";
+    for (int k = 0; k < EventKindCount; ++k)
+        buffer += ((row.flags >> k) & 1) ? ",1" : ",0";
+    buffer += '\n';
+    if (buffer.size() >= blockSize)
+        flush();
+}
+
+void CaptureWriter::flush()
+{
+    if (ok && !buffer.isEmpty())
+        ok = file.write(buffer) == buffer.size();
+    buffer.clear();
+}
+
+bool CaptureWriter::close()
+{
+    if (!file.isOpen())
+        return false;
+    flush();
+    if (!ok)
+        file.cancelWriting();
+    return file.commit() && ok;
+}
+
+bool saveLoopCsv(const QString &fileName, int loop, const LoopTrace &trace)
+{
+    CaptureWriter writer;
+    if (!writer.open(fileName, loop))
+        return false;
+    const QVector<int> &breaks = trace.breaks();
+    int nextBreak = 0;
+    CaptureRow row;
+    for (int i = 0; i < trace.size(); ++i) {
+        row.gap = nextBreak < breaks.size() && breaks[nextBreak] == i;
+        if (row.gap)
+            ++nextBreak;
+        row.value = trace.value(i);
+        row.timeS = trace.time(i);
+        row.flags = trace.events().flagsAt(i);
+        writer.write(i, row);
+    }
+    return writer.close();
+}
+
+CaptureStatus loadLoopCsv(const QString &fileName, int loop, LoopTrace &trace,
+                          double defaultIntervalS)
+{
+    CaptureReader reader;
+    CaptureStatus status = reader.open(fileName);
+    if (status != CaptureOk)
+        return status;
+    if (!reader.header().contains(QString::number(loop)))
+        return CaptureBadHeader;
+
+    trace.clear();
+    CaptureRow row;
+    while (reader.next(row))
+        trace.append(row.value, row.hasTime ? row.timeS : trace.size() * defaultIntervalS,
+                     row.gap, row.flags);
+    return CaptureOk;
+}
@@ -0,0 +1,79 @@
+// captureio.h
+#ifndef CAPTUREIO_H
+#define CAPTUREIO_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QSaveFile>
+#include <QString>
+#include "looptrace.h"
+
+// Per-loop capture files:
+//   #Loop <n>
+//   <index>,<frequency>[,<time_s>[,<gap>[,<state>,<cal>,<open>,<short>]]]
+// Files written before timestamps existed only have the first two
+// columns; their samples get evenly spaced times. The last four columns
+// are 0/1 event flags and rebuild the trace's event index.
+
+enum CaptureStatus {
+    CaptureOk,
+    CaptureOpenFailed,
+    CaptureBadHeader
+};
+
+struct CaptureRow {
+    double value = 0.0;
+    double timeS = 0.0;
+    bool   hasTime = false;     // third column present
+    bool   gap = false;
+    quint8 flags = 0;           // bit k: EventKind k
+};
+
+// Streaming capture reader. The file is read in large blocks and the
+// fields parsed in place, without a QString per line.
+class CaptureReader {
+public:
+    CaptureStatus open(const QString &fileName);
+    const QString &header() const { return headerLine; }
+    int loop() const { return headerLoop; }     // 0 without "#Loop <n>"
+
+    // Next well-formed row; false at the end of the file
+    bool next(CaptureRow &row);
+    qint64 badLines() const { return skipped; }
+    qint64 bytesRead() const { return readBytes; }
+
+private:
+    bool readLine(const char *&begin, const char *&end);
+
+    QFile      file;
+    QByteArray buffer;
+    qsizetype  pos = 0;
+    bool       atEnd = false;
+    QString    headerLine;
+    int        headerLoop = 0;
+    qint64     skipped = 0;
+    qint64     readBytes = 0;
+};
+
+// Streaming capture writer, the format saveLoopCsv produces. Rows go to
+// a temporary file that replaces fileName on a successful close(), so a
+// failed write leaves an existing file untouched.
+class CaptureWriter {
+public:
+    bool open(const QString &fileName, int loop);
+    void write(qint64 index, const CaptureRow &row);
+    bool close();
+
+private:
+    void flush();
+
+    QSaveFile  file;
+    QByteArray buffer;
+    bool       ok = false;
+};
+
+bool saveLoopCsv(const QString &fileName, int loop, const LoopTrace &trace);
+CaptureStatus loadLoopCsv(const QString &fileName, int loop, LoopTrace &trace,
+                          double defaultIntervalS);
+
+#endif // CAPTUREIO_H
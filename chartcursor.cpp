@@ -0,0 +1,219 @@
+// chartcursor.cpp
+#include "chartcursor.h"
+#include <QBrush>
+#include <QPen>
+#include <QStringList>
+
+namespace {
+const char *const markerNames[2] = {"A", "B"};
+const QColor markerColors[2] = {QColor(0, 130, 0), QColor(200, 100, 0)};
+}
+
+ChartCursor::ChartCursor(QChart *chart, const LoopTrace *trace, QValueAxis *axisX, QValueAxis *axisY)
+    : chart(chart), trace(trace), axisX(axisX), axisY(axisY)
+{
+    // Above the series (z 0) and the event overlays
+    line = new QGraphicsLineItem(chart);
+    line->setPen(QPen(QColor(80, 80, 80), 0, Qt::DashLine));
+    line->setZValue(10);
+    dot = new QGraphicsEllipseItem(-3, -3, 6, 6, chart);
+    dot->setPen(QPen(Qt::black, 0));
+    dot->setBrush(Qt::yellow);
+    dot->setZValue(11);
+    hoverLabel = makeLabel(QColor(80, 80, 80));
+    for (int m = 0; m < 2; ++m) {
+        markerLine[m] = new QGraphicsLineItem(chart);
+        markerLine[m]->setPen(QPen(markerColors[m], 1.5));
+        markerLine[m]->setZValue(10);
+    }
+    measureLabel = makeLabel(Qt::black);
+    clear();
+    leave();
+}
+
+ChartCursor::Label ChartCursor::makeLabel(const QColor &border)
+{
+    Label label;
+    label.box = new QGraphicsRectItem(chart);
+    label.box->setPen(QPen(border, 0));
+    label.box->setBrush(QColor(255, 255, 255, 230));
+    label.box->setZValue(12);
+    label.text = new QGraphicsSimpleTextItem(label.box);
+    label.box->hide();
+    return label;
+}
+
+void ChartCursor::showLabel(Label &label, const QString &text, QPointF at)
+{
+    label.text->setText(text);
+    const QRectF r = label.text->boundingRect().adjusted(-4, -2, 4, 2);
+    // Keep the box inside the plot area
+    const QRectF area = chart->plotArea();
+    at.setX(qBound(area.left(), at.x(), qMax(area.left(), area.right() - r.width())));
+    at.setY(qBound(area.top(), at.y(), qMax(area.top(), area.bottom() - r.height())));
+    label.box->setRect(r);
+    label.box->setPos(at - r.topLeft());
+    label.box->show();
+}
+
+void ChartCursor::setCrosshairEnabled(bool on)
+{
+    crosshair = on;
+    if (!on)
+        leave();
+}
+
+void ChartCursor::setMeasureEnabled(bool on)
+{
+    measuring = on;
+    if (!on)
+        clear();
+}
+
+double ChartCursor::toPixelX(double x) const
+{
+    const QRectF area = chart->plotArea();
+    const double span = axisX->max() - axisX->min();
+    return area.left() + (span > 0.0 ? (x - axisX->min()) / span * area.width() : 0.0);
+}
+
+double ChartCursor::toPixelY(double y) const
+{
+    const QRectF area = chart->plotArea();
+    const double span = axisY->max() - axisY->min();
+    return area.bottom() - (span > 0.0 ? (y - axisY->min()) / span * area.height() : 0.0);
+}
+
+int ChartCursor::sampleAt(const QPointF &pos, bool timeAxis) const
+{
+    const QRectF area = chart->plotArea();
+    if (!area.contains(pos) || area.width() <= 0.0)
+        return -1;
+    const double x = axisX->min() + (pos.x() - area.left()) / area.width() * (axisX->max() - axisX->min());
+    return trace->nearest(x, timeAxis);
+}
+
+QString ChartCursor::sampleText(int i) const
+{
+    QString text = QString("#%1  t=%2 s  f=%3")
+                       .arg(i)
+                       .arg(trace->time(i), 0, 'f', 3)
+                       .arg(trace->value(i), 0, 'f', 1);
+    QStringList flags;
+    const quint8 bits = trace->events().flagsAt(i);
+    for (int k = 0; k < EventKindCount; ++k) {
+        if (bits & (1 << k))
+            flags << eventKindName(k);
+    }
+    if (trace->gapBefore(i))
+        flags << "gap before";
+    if (!flags.isEmpty())
+        text += "  [" + flags.join(", ") + "]";
+    return text;
+}
+
+QString ChartCursor::measureText() const
+{
+    QStringList lines;
+    for (int m = 0; m < 2; ++m) {
+        if (marker[m] >= 0)
+            lines << QString("%1: %2").arg(markerNames[m]).arg(sampleText(marker[m]));
+    }
+    if (marker[0] >= 0 && marker[1] >= 0) {
+        const int a = qMin(marker[0], marker[1]);
+        const int b = qMax(marker[0], marker[1]);
+        const double dt = trace->time(marker[1]) - trace->time(marker[0]);
+        const double df = trace->value(marker[1]) - trace->value(marker[0]);
+        double min, max, sum;
+        trace->summarize(a, b + 1, min, max, sum);
+        lines << QString("Δn=%1  Δt=%2 s  Δf=%3  slope=%4 /s")
+                     .arg(marker[1] - marker[0])
+                     .arg(dt, 0, 'f', 3)
+                     .arg(df, 0, 'f', 1)
+                     .arg(dt != 0.0 ? QString::number(df / dt, 'f', 2) : QString("-"));
+        lines << QString("min=%1  max=%2  mean=%3")
+                     .arg(min, 0, 'f', 1)
+                     .arg(max, 0, 'f', 1)
+                     .arg(sum / (b - a + 1), 0, 'f', 2);
+    }
+    return lines.join('\n');
+}
+
+void ChartCursor::hover(const QPointF &pos, bool timeAxis)
+{
+    if (!crosshair)
+        return;
+    hovered = sampleAt(pos, timeAxis);
+    update(timeAxis);
+}
+
+void ChartCursor::leave()
+{
+    hovered = -1;
+    line->hide();
+    dot->hide();
+    hoverLabel.box->hide();
+}
+
+void ChartCursor::placeMarker(const QPointF &pos, bool timeAxis)
+{
+    const int i = sampleAt(pos, timeAxis);
+    if (i < 0)
+        return;
+    marker[nextMarker] = i;
+    nextMarker ^= 1;
+    update(timeAxis);
+}
+
+void ChartCursor::clear()
+{
+    marker[0] = marker[1] = -1;
+    nextMarker = 0;
+    markerLine[0]->hide();
+    markerLine[1]->hide();
+    measureLabel.box->hide();
+}
+
+void ChartCursor::update(bool timeAxis)
+{
+    const QRectF area = chart->plotArea();
+    const double minX = axisX->min();
+    const double maxX = axisX->max();
+    auto inView = [&](int i) {
+        if (i < 0 || i >= trace->size())
+            return false;
+        const double x = trace->x(i, timeAxis);
+        return x >= minX && x <= maxX;
+    };
+
+    if (inView(hovered)) {
+        const double px = toPixelX(trace->x(hovered, timeAxis));
+        const double py = toPixelY(trace->value(hovered));
+        line->setLine(px, area.top(), px, area.bottom());
+        dot->setPos(px, qBound(area.top(), py, area.bottom()));
+        line->show();
+        dot->show();
+        showLabel(hoverLabel, sampleText(hovered), QPointF(px + 8, area.top() + 4));
+    } else {
+        line->hide();
+        dot->hide();
+        hoverLabel.box->hide();
+    }
+
+    // A capture replaced by a shorter one drops markers past its end
+    for (int m = 0; m < 2; ++m) {
+        if (marker[m] >= trace->size())
+            marker[m] = -1;
+        if (inView(marker[m])) {
+            const double px = toPixelX(trace->x(marker[m], timeAxis));
+            markerLine[m]->setLine(px, area.top(), px, area.bottom());
+            markerLine[m]->show();
+        } else {
+            markerLine[m]->hide();
+        }
+    }
+    if (measuring && (marker[0] >= 0 || marker[1] >= 0))
+        showLabel(measureLabel, measureText(), QPointF(area.left() + 4, area.bottom()));
+    else
+        measureLabel.box->hide();
+}
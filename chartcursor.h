@@ -0,0 +1,65 @@
+// chartcursor.h
+#ifndef CHARTCURSOR_H
+#define CHARTCURSOR_H
+
+#include <QGraphicsLineItem>
+#include <QGraphicsEllipseItem>
+#include <QGraphicsRectItem>
+#include <QGraphicsSimpleTextItem>
+#include <QtCharts/QChart>
+#include <QtCharts/QValueAxis>
+
+#include "looptrace.h"
+
+// Crosshair and two-marker measurement on a loop chart. The crosshair
+// snaps to the sample nearest the mouse (binary search on the trace's
+// timestamps); between markers A and B it shows Δt, Δf, slope and the
+// min/max/mean of the samples from the trace's block summaries, so both
+// stay O(log n) on any capture length. Items belong to the chart and are
+// repositioned on update(), after the axes or the data changed.
+class ChartCursor {
+public:
+    ChartCursor(QChart *chart, const LoopTrace *trace, QValueAxis *axisX, QValueAxis *axisY);
+
+    void setCrosshairEnabled(bool on);
+    void setMeasureEnabled(bool on);
+    bool measureEnabled() const { return measuring; }
+
+    void hover(const QPointF &pos, bool timeAxis);
+    void leave();
+    void placeMarker(const QPointF &pos, bool timeAxis);    // A, B, A, ...
+    void clear();
+    void update(bool timeAxis);
+
+private:
+    struct Label {
+        QGraphicsRectItem *box;
+        QGraphicsSimpleTextItem *text;
+    };
+    Label makeLabel(const QColor &border);
+    void showLabel(Label &label, const QString &text, QPointF at);
+    int sampleAt(const QPointF &pos, bool timeAxis) const;
+    double toPixelX(double x) const;
+    double toPixelY(double y) const;
+    QString sampleText(int i) const;
+    QString measureText() const;
+
+    QChart *chart;
+    const LoopTrace *trace;
+    QValueAxis *axisX;
+    QValueAxis *axisY;
+
+    QGraphicsLineItem *line;
+    QGraphicsEllipseItem *dot;
+    Label hoverLabel;
+    QGraphicsLineItem *markerLine[2];
+    Label measureLabel;
+
+    bool crosshair = false;
+    bool measuring = false;
+    int hovered = -1;
+    int marker[2] = {-1, -1};
+    int nextMarker = 0;
+};
+
+#endif // CHARTCURSOR_H
@@ -0,0 +1,159 @@
+// chartexport.cpp
+#include "chartexport.h"
+#include <QFileInfo>
+#include <QImage>
+#include <QObject>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QSvgGenerator>
+#include <cmath>
+
+namespace {
+
+// Tick spacing of 1, 2 or 5 times a power of ten, about 'count' ticks
+double tickStep(double span, int count)
+{
+    if (span <= 0.0)
+        return 1.0;
+    const double raw = span / count;
+    const double magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+    const double norm = raw / magnitude;
+    return (norm < 1.5 ? 1.0 : norm < 3.5 ? 2.0 : norm < 7.5 ? 5.0 : 10.0) * magnitude;
+}
+
+QString tickLabel(double v, double step)
+{
+    const int decimals = qMax(0, -int(std::floor(std::log10(step))));
+    return QString::number(v, 'f', decimals);
+}
+
+void drawPlot(QPainter &p, const QRectF &area, const ChartExportPlot &plot,
+              const QString &xTitle, const QString &yTitle)
+{
+    const QFontMetricsF fm(p.font());
+    const double margin = fm.height() * 0.5;
+    const QRectF frame = area.adjusted(fm.horizontalAdvance("-000000.0") + fm.height() * 2,
+                                       fm.height() * 1.8, -margin * 2, -fm.height() * 3);
+    if (frame.width() < 10 || frame.height() < 10)
+        return;
+
+    const double spanX = plot.maxX > plot.minX ? plot.maxX - plot.minX : 1.0;
+    const double spanY = plot.maxY > plot.minY ? plot.maxY - plot.minY : 1.0;
+    auto mapX = [&](double x) { return frame.left() + (x - plot.minX) / spanX * frame.width(); };
+    auto mapY = [&](double y) { return frame.bottom() - (y - plot.minY) / spanY * frame.height(); };
+
+    p.setPen(Qt::black);
+    p.drawText(QRectF(frame.left(), area.top(), frame.width(), fm.height() * 1.5),
+               Qt::AlignCenter, plot.title);
+
+    // Grid and tick labels
+    const QPen gridPen(QColor(220, 220, 220), 0);
+    const double stepX = tickStep(spanX, 8);
+    for (double x = std::ceil(plot.minX / stepX) * stepX; x <= plot.maxX + stepX * 1e-9; x += stepX) {
+        const double px = mapX(x);
+        p.setPen(gridPen);
+        p.drawLine(QPointF(px, frame.top()), QPointF(px, frame.bottom()));
+        p.setPen(Qt::black);
+        p.drawText(QRectF(px - 100, frame.bottom() + margin * 0.5, 200, fm.height()),
+                   Qt::AlignHCenter | Qt::AlignTop, tickLabel(x, stepX));
+    }
+    const double stepY = tickStep(spanY, 6);
+    for (double y = std::ceil(plot.minY / stepY) * stepY; y <= plot.maxY + stepY * 1e-9; y += stepY) {
+        const double py = mapY(y);
+        p.setPen(gridPen);
+        p.drawLine(QPointF(frame.left(), py), QPointF(frame.right(), py));
+        p.setPen(Qt::black);
+        p.drawText(QRectF(area.left(), py - fm.height() / 2, frame.left() - area.left() - margin,
+                          fm.height()),
+                   Qt::AlignRight | Qt::AlignVCenter, tickLabel(y, stepY));
+    }
+    p.drawText(QRectF(frame.left(), frame.bottom() + fm.height() * 1.5, frame.width(), fm.height() * 1.2),
+               Qt::AlignCenter, xTitle);
+    p.save();
+    p.translate(area.left() + fm.height() * 0.2, frame.center().y());
+    p.rotate(-90);
+    p.drawText(QRectF(-frame.height() / 2, 0, frame.height(), fm.height()), Qt::AlignCenter, yTitle);
+    p.restore();
+
+    p.save();
+    p.setClipRect(frame);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(QPen(plot.color, qMax(1.0, fm.height() / 12.0)));
+    for (const QVector<QPointF> &run : plot.runs) {
+        QPolygonF line;
+        line.reserve(run.size());
+        for (const QPointF &pt : run)
+            line.append(QPointF(mapX(pt.x()), mapY(pt.y())));
+        p.drawPolyline(line);
+    }
+    p.restore();
+
+    p.setPen(QPen(Qt::black, 0));
+    p.setBrush(Qt::NoBrush);
+    p.drawRect(frame);
+}
+
+void drawChart(QPainter &p, const QRectF &page, const ChartExport &chart)
+{
+    QFont font = p.font();
+    font.setPixelSize(qMax(10, int(page.height() / (28 * qMax(1, int(chart.plots.size()))) + 8)));
+    p.setFont(font);
+    p.fillRect(page, Qt::white);
+    const double h = page.height() / qMax(1, int(chart.plots.size()));
+    for (int i = 0; i < chart.plots.size(); ++i) {
+        drawPlot(p, QRectF(page.left(), page.top() + i * h, page.width(), h), chart.plots[i],
+                 chart.xTitle, chart.yTitle);
+    }
+}
+
+} // namespace
+
+bool renderChartExport(const ChartExport &chart, QString *error)
+{
+    const QString suffix = QFileInfo(chart.fileName).suffix().toLower();
+    const QRectF page(QPointF(0, 0), QSizeF(chart.size));
+
+    if (suffix == "svg") {
+        QSvgGenerator svg;
+        svg.setFileName(chart.fileName);
+        svg.setSize(chart.size);
+        svg.setViewBox(page);
+        svg.setTitle(chart.plots.isEmpty() ? QString() : chart.plots.first().title);
+        QPainter p;
+        if (!p.begin(&svg)) {
+            if (error)
+                *error = QObject::tr("cannot write %1").arg(chart.fileName);
+            return false;
+        }
+        drawChart(p, page, chart);
+        return p.end();
+    }
+
+    if (suffix == "pdf") {
+        // One page of the chart's aspect; 96 dpi keeps pixel sizes meaningful
+        QPdfWriter pdf(chart.fileName);
+        pdf.setResolution(96);
+        pdf.setPageSize(QPageSize(QSizeF(chart.size) / 96.0 * 25.4, QPageSize::Millimeter));
+        pdf.setPageMargins(QMarginsF());
+        QPainter p;
+        if (!p.begin(&pdf)) {
+            if (error)
+                *error = QObject::tr("cannot write %1").arg(chart.fileName);
+            return false;
+        }
+        drawChart(p, QRectF(QPointF(0, 0), QSizeF(pdf.width(), pdf.height())), chart);
+        return p.end();
+    }
+
+    QImage image(chart.size, QImage::Format_RGB32);
+    QPainter p(&image);
+    drawChart(p, page, chart);
+    p.end();
+    if (!image.save(chart.fileName)) {
+        if (error)
+            *error = QObject::tr("cannot write %1").arg(chart.fileName);
+        return false;
+    }
+    return true;
+}
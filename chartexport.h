@@ -0,0 +1,38 @@
+// chartexport.h
+#ifndef CHARTEXPORT_H
+#define CHARTEXPORT_H
+
+#include <QColor>
+#include <QList>
+#include <QPointF>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+// A chart to render into a file, detached from the live traces: the
+// points are already decimated to about two per output pixel, so the
+// render cost does not depend on the capture length and the job can run
+// on a worker thread while the traces keep growing.
+struct ChartExportPlot {
+    QString title;
+    QColor  color;
+    QVector<QVector<QPointF>> runs;     // one polyline per gap-free run
+    double  minX = 0.0;
+    double  maxX = 1.0;
+    double  minY = 0.0;
+    double  maxY = 1.0;
+};
+
+struct ChartExport {
+    QString fileName;           // .png, .svg or .pdf
+    QSize   size{1920, 1080};   // pixels; PDF and SVG use them as 96 dpi units
+    QString xTitle;
+    QString yTitle;
+    QList<ChartExportPlot> plots;   // stacked top to bottom
+};
+
+// Renders with QPainter into a QImage, QSvgGenerator or QPdfWriter as
+// chosen by the file suffix. Safe to call from any thread.
+bool renderChartExport(const ChartExport &chart, QString *error = nullptr);
+
+#endif // CHARTEXPORT_H
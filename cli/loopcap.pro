@@ -0,0 +1,31 @@
+QT       = core concurrent
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = loopcap
+
+# Capture I/O and the filters are shared with the GUI, compiled from the parent directory
+INCLUDEPATH += ..
+
+SOURCES += \
+    ../captureio.cpp \
+    ../eventindex.cpp \
+    ../loopfilter.cpp \
+    ../looptrace.cpp \
+    ../samplestore.cpp \
+    ../simdkernels.cpp \
+    main.cpp
+
+HEADERS += \
+    ../captureio.h \
+    ../eventindex.h \
+    ../loopfilter.h \
+    ../looptrace.h \
+    ../samplestore.h \
+    ../simdkernels.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,375 @@
+// main.cpp
+// loopcap: batch summary, validation, conversion, decimation and filtering
+// of loop capture files. Files are processed in parallel on the global thread
+// pool; results are printed in input order as they complete.
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <cmath>
+#include <limits>
+
+#include "captureio.h"
+#include "loopfilter.h"
+
+namespace {
+
+enum Command { CmdSummary, CmdValidate, CmdConvert, CmdDecimate, CmdFilter };
+
+struct Job {
+    QString path;       // input file
+    QString relative;   // path below the input root, kept under --out-dir
+};
+
+struct Options {
+    Command command = CmdSummary;
+    QString outDir;
+    int     factor = 10;
+    double  intervalS = 0.1;
+    FilterSettings filter;
+};
+
+struct FileResult {
+    QString path;
+    QString error;
+    int     loop = 0;
+    qint64  samples = 0;
+    qint64  badLines = 0;
+    qint64  gaps = 0;
+    qint64  backwardTimes = 0;  // timestamps earlier than the previous one
+    qint64  events[EventKindCount] = {};
+    qint64  bytes = 0;
+    double  min = std::numeric_limits<double>::quiet_NaN();
+    double  max = std::numeric_limits<double>::quiet_NaN();
+    double  mean = std::numeric_limits<double>::quiet_NaN();
+    double  durationS = 0.0;
+
+    bool valid() const { return error.isEmpty() && badLines == 0 && backwardTimes == 0; }
+};
+
+FileResult processFile(const Job &job, const Options &opt)
+{
+    FileResult r;
+    r.path = job.path;
+    CaptureReader reader;
+    CaptureStatus status = reader.open(job.path);
+    if (status == CaptureOpenFailed) {
+        r.error = QStringLiteral("cannot open");
+        return r;
+    }
+    r.loop = reader.loop();
+    if (status == CaptureBadHeader || r.loop == 0) {
+        r.error = QStringLiteral("bad header");
+        return r;
+    }
+
+    CaptureWriter writer;
+    const bool writing = opt.command != CmdSummary && opt.command != CmdValidate;
+    if (writing) {
+        const QString out = QDir(opt.outDir).filePath(job.relative);
+        QDir().mkpath(QFileInfo(out).absolutePath());
+        if (!writer.open(out, r.loop)) {
+            r.error = QStringLiteral("cannot write %1").arg(out);
+            return r;
+        }
+    }
+
+    // Decimation keeps the mean of each group, the first time and any
+    // gap or event flag inside the group
+    CaptureRow row, group;
+    int inGroup = 0;
+    qint64 written = 0;
+    double sum = 0.0, firstTime = 0.0, lastTime = 0.0;
+    double lo = std::numeric_limits<double>::max();
+    double hi = std::numeric_limits<double>::lowest();
+    quint8 prevFlags = 0;
+
+    // Filtering runs the GUI's filter stage over blocks of rows. Outputs
+    // refer back to their source row, up to the filter delay into the
+    // previous block, so that many rows are kept in front of the next one.
+    LoopFilter filter(opt.filter);
+    QVector<CaptureRow> pending;
+    int carried = 0;
+    bool restart = true;
+    QVector<double> in, filtered;
+    QVector<int> source;
+    auto flushFilter = [&]() {
+        const int n = int(pending.size()) - carried;
+        in.resize(n);
+        filtered.resize(n);
+        source.resize(n);
+        for (int k = 0; k < n; ++k)
+            in[k] = pending[carried + k].value;
+        const int m = filter.process(in.constData(), n, filtered.data(), source.data());
+        for (int k = 0; k < m; ++k) {
+            CaptureRow out = pending[carried + source[k]];
+            out.value = filtered[k];
+            out.gap = restart && written > 0;
+            restart = false;
+            writer.write(written++, out);
+        }
+        carried = qMin(int(pending.size()), filter.delay());
+        pending.remove(0, pending.size() - carried);
+    };
+
+    while (reader.next(row)) {
+        if (!row.hasTime)
+            row.timeS = r.samples * opt.intervalS;
+        if (r.samples == 0)
+            firstTime = row.timeS;
+        else if (row.timeS < lastTime)
+            ++r.backwardTimes;
+        lastTime = row.timeS;
+        lo = qMin(lo, row.value);
+        hi = qMax(hi, row.value);
+        sum += row.value;
+        if (row.gap)
+            ++r.gaps;
+        // Events are counted by their rising edge
+        const quint8 rising = row.flags & ~prevFlags;
+        for (int k = 0; k < EventKindCount; ++k)
+            r.events[k] += (rising >> k) & 1;
+        prevFlags = row.flags;
+        ++r.samples;
+
+        if (opt.command == CmdConvert) {
+            writer.write(written++, row);
+        } else if (opt.command == CmdDecimate) {
+            if (inGroup == 0) {
+                group = row;
+                group.value = 0.0;
+            }
+            group.value += row.value;
+            group.gap |= row.gap;
+            group.flags |= row.flags;
+            if (++inGroup == opt.factor) {
+                group.value /= inGroup;
+                writer.write(written++, group);
+                inGroup = 0;
+            }
+        } else if (opt.command == CmdFilter) {
+            // A gap restarts the filter
+            if (row.gap && !pending.isEmpty()) {
+                flushFilter();
+                filter.reset();
+                pending.clear();
+                carried = 0;
+                restart = true;
+            }
+            pending.append(row);
+            if (pending.size() - carried == 4096)
+                flushFilter();
+        }
+    }
+    if (opt.command == CmdFilter && pending.size() > carried)
+        flushFilter();
+    if (opt.command == CmdDecimate && inGroup > 0) {
+        group.value /= inGroup;
+        writer.write(written++, group);
+    }
+    if (writing && !writer.close())
+        r.error = QStringLiteral("write failed");
+
+    r.badLines = reader.badLines();
+    r.bytes = reader.bytesRead();
+    if (r.samples > 0) {
+        r.min = lo;
+        r.max = hi;
+        r.mean = sum / r.samples;
+        r.durationS = lastTime - firstTime;
+    }
+    return r;
+}
+
+QList<Job> collectJobs(const QStringList &paths, const QStringList &patterns)
+{
+    QList<Job> jobs;
+    for (const QString &path : paths) {
+        QFileInfo info(path);
+        if (info.isDir()) {
+            QDir root(path);
+            QDirIterator it(path, patterns, QDir::Files, QDirIterator::Subdirectories);
+            QStringList found;
+            while (it.hasNext())
+                found.append(it.next());
+            found.sort();
+            for (const QString &file : found)
+                jobs.append({file, root.relativeFilePath(file)});
+        } else {
+            // Relative to the working directory, so a/x.csv and b/x.csv
+            // stay apart under --out-dir; the bare name for files elsewhere
+            const QString relative = QDir::current().relativeFilePath(info.absoluteFilePath());
+            const bool outside = relative.startsWith("..") || QDir::isAbsolutePath(relative);
+            jobs.append({path, outside ? info.fileName() : relative});
+        }
+    }
+    return jobs;
+}
+
+// Empty if every job writes its own file and none of them is an input
+QString checkOutputs(const QList<Job> &jobs, const QString &outDir)
+{
+    QSet<QString> inputs;
+    for (const Job &job : jobs)
+        inputs.insert(QFileInfo(job.path).canonicalFilePath());
+    QHash<QString, QString> outputs;    // output -> input writing it
+    for (const Job &job : jobs) {
+        const QFileInfo out(QDir(outDir).filePath(job.relative));
+        // Empty while the output does not exist, and then it is no input
+        const QString canonical = out.canonicalFilePath();
+        if (!canonical.isEmpty() && inputs.contains(canonical))
+            return QStringLiteral("%1 would overwrite an input").arg(out.filePath());
+        const QString key = QDir::cleanPath(out.absoluteFilePath());
+        if (outputs.contains(key)) {
+            return QStringLiteral("%1 and %2 would both write %3")
+                .arg(outputs.value(key), job.path, out.filePath());
+        }
+        outputs.insert(key, job.path);
+    }
+    return QString();
+}
+
+QString number(double v)
+{
+    return std::isnan(v) ? QString() : QString::number(v, 'g', 10);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("loopcap");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Batch processing of loop capture files (#Loop <n> CSV).\n"
+        "Commands:\n"
+        "  summary   per-file samples, min/max/mean, duration, gaps and events\n"
+        "  validate  report files with bad headers, malformed lines or time going back\n"
+        "  convert   rewrite files in the current format under --out-dir\n"
+        "  decimate  keep the mean of every --factor samples under --out-dir\n"
+        "  filter    apply the GUI's --filter to every file under --out-dir");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "summary, validate, convert, decimate or filter");
+    parser.addPositionalArgument("paths", "Capture files or directories (searched recursively)",
+                                 "<paths...>");
+    QCommandLineOption outDirOpt({"o", "out-dir"}, "Output directory for convert/decimate/filter.", "dir");
+    QCommandLineOption factorOpt({"f", "factor"}, "Decimation factor, also of the fir filter (default 10).",
+                                 "n", "10");
+    QCommandLineOption filterOpt("filter", "Filter: average, median, lowpass, notch or fir (default average).",
+                                 "kind", "average");
+    QCommandLineOption lengthOpt("length", "Window of average/median, taps of fir (default 5).", "n", "5");
+    QCommandLineOption cutoffOpt("cutoff", "Corner frequency of lowpass/fir (default 1 Hz).", "hz", "1");
+    QCommandLineOption notchOpt("notch", "Centre frequency of notch (default 1 Hz).", "hz", "1");
+    QCommandLineOption qOpt("q", "Quality factor of lowpass/notch (default 0.707).", "q", "0.707");
+    QCommandLineOption intervalOpt("interval",
+                                   "Sample interval of files without timestamps (default 0.1 s).",
+                                   "s", "0.1");
+    QCommandLineOption patternOpt("pattern", "File name pattern in directories (default *.csv).",
+                                  "glob", "*.csv");
+    QCommandLineOption jobsOpt({"j", "jobs"}, "Worker threads (default: all cores).", "n");
+    parser.addOptions({outDirOpt, factorOpt, filterOpt, lengthOpt, cutoffOpt, notchOpt, qOpt,
+                       intervalOpt, patternOpt, jobsOpt});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    const QStringList args = parser.positionalArguments();
+    const QStringList commands = {"summary", "validate", "convert", "decimate", "filter"};
+    if (args.size() < 2 || !commands.contains(args.first()))
+        parser.showHelp(2);
+
+    Options opt;
+    opt.command = Command(commands.indexOf(args.first()));
+    opt.outDir = parser.value(outDirOpt);
+    opt.factor = qMax(1, parser.value(factorOpt).toInt());
+    opt.intervalS = parser.value(intervalOpt).toDouble();
+    const QStringList filters = {"average", "median", "lowpass", "notch", "fir"};
+    const int filterIndex = filters.indexOf(parser.value(filterOpt));
+    if (opt.command == CmdFilter && filterIndex < 0) {
+        err << "loopcap: unknown filter " << parser.value(filterOpt) << '\n';
+        return 2;
+    }
+    opt.filter.kind = FilterKind(FilterMovingAverage + filterIndex);
+    opt.filter.length = parser.value(lengthOpt).toInt();
+    opt.filter.cutoffHz = parser.value(cutoffOpt).toDouble();
+    opt.filter.notchHz = parser.value(notchOpt).toDouble();
+    opt.filter.q = parser.value(qOpt).toDouble();
+    opt.filter.decimation = opt.factor;
+    opt.filter.sampleRateHz = 1.0 / qMax(1e-6, opt.intervalS);
+    if (opt.command != CmdSummary && opt.command != CmdValidate && opt.outDir.isEmpty()) {
+        err << "loopcap: " << args.first() << " needs --out-dir\n";
+        return 2;
+    }
+    if (parser.isSet(jobsOpt))
+        QThreadPool::globalInstance()->setMaxThreadCount(qMax(1, parser.value(jobsOpt).toInt()));
+
+    const QList<Job> jobs = collectJobs(args.mid(1), {parser.value(patternOpt)});
+    if (opt.command != CmdSummary && opt.command != CmdValidate) {
+        const QString conflict = checkOutputs(jobs, opt.outDir);
+        if (!conflict.isEmpty()) {
+            err << "loopcap: " << conflict << '\n';
+            return 2;
+        }
+    }
+    QElapsedTimer timer;
+    timer.start();
+    QFuture<FileResult> future = QtConcurrent::mapped(jobs, [opt](const Job &job) {
+        return processFile(job, opt);
+    });
+
+    if (opt.command == CmdSummary) {
+        out << "file,loop,samples,min,max,mean,duration_s,gaps,"
+            << "presence,calibration,open,short,bad_lines,error\n";
+    }
+    int failed = 0;
+    qint64 bytes = 0, samples = 0;
+    for (int i = 0; i < jobs.size(); ++i) {
+        // resultAt() blocks until file i is done; later files keep running
+        const FileResult r = future.resultAt(i);
+        bytes += r.bytes;
+        samples += r.samples;
+        if (!r.valid())
+            ++failed;
+        switch (opt.command) {
+        case CmdSummary:
+            out << r.path << ',' << r.loop << ',' << r.samples << ',' << number(r.min) << ','
+                << number(r.max) << ',' << number(r.mean) << ',' << number(r.durationS) << ','
+                << r.gaps;
+            for (qint64 n : r.events)
+                out << ',' << n;
+            out << ',' << r.badLines << ',' << r.error << '\n';
+            break;
+        case CmdValidate:
+            if (!r.valid()) {
+                out << r.path << ": "
+                    << (r.error.isEmpty() ? QStringLiteral("%1 malformed lines, %2 backward timestamps")
+                                                .arg(r.badLines).arg(r.backwardTimes)
+                                          : r.error)
+                    << '\n';
+            }
+            break;
+        case CmdConvert:
+        case CmdDecimate:
+        case CmdFilter:
+            if (!r.error.isEmpty())
+                out << r.path << ": " << r.error << '\n';
+            break;
+        }
+    }
+    out.flush();
+
+    const double seconds = qMax<qint64>(1, timer.elapsed()) / 1000.0;
+    err << QString("loopcap: %1 files, %2 samples, %3 MB in %4 s (%5 MB/s), %6 with problems\n")
+               .arg(jobs.size()).arg(samples).arg(bytes / 1e6, 0, 'f', 1)
+               .arg(seconds, 0, 'f', 2).arg(bytes / 1e6 / seconds, 0, 'f', 1).arg(failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,376 @@
+// comparedialog.cpp
+#include "comparedialog.h"
+#include "capturealign.h"
+#include "captureio.h"
+#include "simdkernels.h"
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QSplitter>
+#include <QVBoxLayout>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+namespace {
+
+enum Column { ColName, ColSamples, ColOffset, ColumnCount };
+
+const QColor captureColors[] = {
+    Qt::red, Qt::blue, QColor(0, 140, 0), QColor(200, 120, 0),
+    Qt::magenta, Qt::darkCyan, Qt::darkGray, Qt::black
+};
+
+const int maxPoints = 2000;     // per series and redraw
+
+} // namespace
+
+CompareDialog::CompareDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Compare Captures"));
+
+    table = new QTableWidget(0, ColumnCount, this);
+    table->setHorizontalHeaderLabels({tr("Capture"), tr("Samples"), tr("Offset")});
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(ColName, QHeaderView::Stretch);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    connect(table, &QTableWidget::itemSelectionChanged, this, &CompareDialog::onSelectionChanged);
+
+    addBtn = new QPushButton(tr("Add..."), this);
+    connect(addBtn, &QPushButton::clicked, this, &CompareDialog::onAddClicked);
+    removeBtn = new QPushButton(tr("Remove"), this);
+    connect(removeBtn, &QPushButton::clicked, this, &CompareDialog::onRemoveClicked);
+
+    alignCombo = new QComboBox(this);
+    alignCombo->addItem(tr("Cross-correlation"));
+    alignCombo->addItem(tr("Event matching"));
+    alignBtn = new QPushButton(tr("Align to Reference"), this);
+    connect(alignBtn, &QPushButton::clicked, this, &CompareDialog::onAlignClicked);
+
+    offsetSpin = new QSpinBox(this);
+    offsetSpin->setRange(-100000000, 100000000);
+    offsetSpin->setSuffix(tr(" samples"));
+    connect(offsetSpin, &QSpinBox::valueChanged, this, &CompareDialog::onOffsetChanged);
+
+    derivedCombo = new QComboBox(this);
+    derivedCombo->addItem(tr("None"));
+    derivedCombo->addItem(tr("Difference (selected - reference)"));
+    derivedCombo->addItem(tr("Ratio (selected / reference)"));
+    connect(derivedCombo, &QComboBox::currentIndexChanged, this, &CompareDialog::updateDerived);
+
+    fitBtn = new QPushButton(tr("Fit"), this);
+    connect(fitBtn, &QPushButton::clicked, this, &CompareDialog::onFitClicked);
+
+    infoLabel = new QLabel(tr("The first capture is the reference."), this);
+    infoLabel->setWordWrap(true);
+
+    auto *addRemove = new QHBoxLayout;
+    addRemove->addWidget(addBtn);
+    addRemove->addWidget(removeBtn);
+
+    auto *form = new QFormLayout;
+    form->addRow(tr("Offset:"), offsetSpin);
+    form->addRow(tr("Align:"), alignCombo);
+    form->addRow(QString(), alignBtn);
+    form->addRow(tr("Derived:"), derivedCombo);
+
+    auto *side = new QWidget(this);
+    auto *sideLayout = new QVBoxLayout(side);
+    sideLayout->setContentsMargins(0, 0, 0, 0);
+    sideLayout->addWidget(table);
+    sideLayout->addLayout(addRemove);
+    sideLayout->addLayout(form);
+    sideLayout->addWidget(fitBtn);
+    sideLayout->addWidget(infoLabel);
+
+    chart = new QChart;
+    axisX = new QValueAxis;
+    axisX->setTitleText("Sample Count");
+    axisX->setLabelFormat("%d");
+    axisY = new QValueAxis;
+    axisY->setTitleText("Frequency");
+    chart->addAxis(axisX, Qt::AlignBottom);
+    chart->addAxis(axisY, Qt::AlignLeft);
+    auto *chartView = new QChartView(chart, this);
+    chartView->setRubberBand(QChartView::HorizontalRubberBand);
+
+    // The derived chart follows the overlay's X range
+    derivedChart = new QChart;
+    derivedChart->legend()->hide();
+    derivedSeries = new QLineSeries;
+    derivedChart->addSeries(derivedSeries);
+    derivedAxisX = new QValueAxis;
+    derivedAxisX->setLabelFormat("%d");
+    derivedAxisY = new QValueAxis;
+    derivedChart->addAxis(derivedAxisX, Qt::AlignBottom);
+    derivedChart->addAxis(derivedAxisY, Qt::AlignLeft);
+    derivedSeries->attachAxis(derivedAxisX);
+    derivedSeries->attachAxis(derivedAxisY);
+    auto *derivedView = new QChartView(derivedChart, this);
+    derivedView->setVisible(false);
+    connect(derivedCombo, &QComboBox::currentIndexChanged, derivedView,
+            [derivedView](int index) { derivedView->setVisible(index != DerivedNone); });
+
+    auto *charts = new QSplitter(Qt::Vertical, this);
+    charts->addWidget(chartView);
+    charts->addWidget(derivedView);
+
+    auto *splitter = new QSplitter(Qt::Horizontal, this);
+    splitter->addWidget(side);
+    splitter->addWidget(charts);
+    splitter->setStretchFactor(1, 1);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(splitter);
+
+    setMinimumSize(1100, 650);
+
+    renderTimer = new QTimer(this);
+    renderTimer->setSingleShot(true);
+    renderTimer->setInterval(0);
+    connect(renderTimer, &QTimer::timeout, this, &CompareDialog::render);
+    connect(axisX, &QValueAxis::rangeChanged, this, &CompareDialog::scheduleRender);
+    connect(chart, &QChart::plotAreaChanged, this, &CompareDialog::scheduleRender);
+
+    onSelectionChanged();
+}
+
+void CompareDialog::onAddClicked()
+{
+    const QStringList files = QFileDialog::getOpenFileNames(this, tr("Add Captures"), QString(),
+                                                            tr("CSV Files (*.csv)"));
+    for (const QString &fn : files) {
+        Capture capture;
+        capture.name = QFileInfo(fn).fileName();
+        // Either loop's files can be compared; the header says which
+        CaptureStatus status = loadLoopCsv(fn, 1, capture.trace, 0.1);
+        if (status == CaptureBadHeader)
+            status = loadLoopCsv(fn, 2, capture.trace, 0.1);
+        if (status != CaptureOk || capture.trace.isEmpty()) {
+            infoLabel->setText(tr("Failed to load %1").arg(fn));
+            continue;
+        }
+        QVector<double> values;
+        capture.trace.read(0, capture.trace.size(), values);
+        capture.values.resize(values.size());
+        for (int i = 0; i < values.size(); ++i)
+            capture.values[i] = float(values[i]);
+
+        capture.series = new QLineSeries;
+        capture.series->setName(capture.name);
+        capture.series->setColor(captureColors[captures.size() % int(std::size(captureColors))]);
+        chart->addSeries(capture.series);
+        capture.series->attachAxis(axisX);
+        capture.series->attachAxis(axisY);
+        captures.append(capture);
+
+        table->insertRow(table->rowCount());
+        updateRow(table->rowCount() - 1);
+    }
+    if (!files.isEmpty()) {
+        fitRange();
+        updateDerived();
+    }
+}
+
+void CompareDialog::onRemoveClicked()
+{
+    const int row = table->currentRow();
+    if (row < 0)
+        return;
+    chart->removeSeries(captures[row].series);
+    delete captures[row].series;
+    captures.removeAt(row);
+    table->removeRow(row);
+    updateDerived();
+    scheduleRender();
+}
+
+void CompareDialog::onAlignClicked()
+{
+    const int row = table->currentRow();
+    if (row <= 0 || captures.size() < 2) {
+        infoLabel->setText(tr("Select a capture other than the reference."));
+        return;
+    }
+    const Capture &ref = captures.first();
+    Capture &capture = captures[row];
+
+    QElapsedTimer timer;
+    timer.start();
+    int lag = 0;
+    bool found;
+    QString quality;
+    if (alignCombo->currentIndex() == 0) {
+        double score = 0.0;
+        found = alignByCorrelation(ref.values, capture.values, lag, &score);
+        quality = tr("correlation %1").arg(score, 0, 'f', 3);
+    } else {
+        int matched = 0;
+        found = alignByEvents(ref.trace.events(), capture.trace.events(), lag, &matched);
+        quality = tr("%1 matching events").arg(matched);
+    }
+    if (!found) {
+        infoLabel->setText(tr("No alignment found."));
+        return;
+    }
+    // capture[i] lines up with ref[i + lag]
+    offsetSpin->setValue(ref.offset + lag);
+    infoLabel->setText(tr("Aligned at %1 samples, %2, %3 ms")
+                           .arg(lag).arg(quality).arg(timer.elapsed()));
+}
+
+void CompareDialog::onFitClicked()
+{
+    fitRange();
+}
+
+void CompareDialog::onOffsetChanged(int offset)
+{
+    const int row = table->currentRow();
+    if (row < 0 || captures[row].offset == offset)
+        return;
+    captures[row].offset = offset;
+    updateRow(row);
+    updateDerived();
+    scheduleRender();
+}
+
+void CompareDialog::onSelectionChanged()
+{
+    const int row = table->currentRow();
+    const bool selected = row >= 0 && row < captures.size();
+    removeBtn->setEnabled(selected);
+    offsetSpin->setEnabled(selected);
+    alignBtn->setEnabled(selected && row > 0);
+    if (selected) {
+        QSignalBlocker block(offsetSpin);
+        offsetSpin->setValue(captures[row].offset);
+    }
+    updateDerived();
+}
+
+void CompareDialog::updateRow(int row)
+{
+    const Capture &capture = captures[row];
+    const QString texts[ColumnCount] = {
+        capture.name, QString::number(capture.trace.size()), QString::number(capture.offset)
+    };
+    for (int col = 0; col < ColumnCount; ++col) {
+        QTableWidgetItem *item = table->item(row, col);
+        if (!item) {
+            item = new QTableWidgetItem;
+            table->setItem(row, col, item);
+        }
+        item->setText(texts[col]);
+    }
+    table->item(row, ColName)->setForeground(capture.series->color());
+}
+
+void CompareDialog::fitRange()
+{
+    if (captures.isEmpty())
+        return;
+    int minX = std::numeric_limits<int>::max();
+    int maxX = std::numeric_limits<int>::min();
+    for (const Capture &c : captures) {
+        minX = qMin(minX, c.offset);
+        maxX = qMax(maxX, c.offset + c.trace.size());
+    }
+    axisX->setRange(minX, maxX);
+}
+
+void CompareDialog::updateDerived()
+{
+    derived.clear();
+    const int row = table->currentRow();
+    const int mode = derivedCombo->currentIndex();
+    if (mode != DerivedNone && row > 0 && row < captures.size()) {
+        // Overlap in shared x, then both captures' indices of it
+        const Capture &ref = captures.first();
+        const Capture &sel = captures[row];
+        const int x0 = qMax(ref.offset, sel.offset);
+        const int x1 = qMin(ref.offset + int(ref.values.size()), sel.offset + int(sel.values.size()));
+        if (x1 > x0) {
+            derived.resize(x1 - x0);
+            const float *a = sel.values.constData() + (x0 - sel.offset);
+            const float *b = ref.values.constData() + (x0 - ref.offset);
+            if (mode == DerivedDifference)
+                SimdKernels::subtract(a, b, derived.data(), derived.size());
+            else
+                SimdKernels::divide(a, b, derived.data(), derived.size());
+            derivedX0 = x0;
+        }
+    }
+    scheduleRender();
+}
+
+void CompareDialog::scheduleRender()
+{
+    if (!renderTimer->isActive())
+        renderTimer->start();
+}
+
+void CompareDialog::render()
+{
+    const double minX = axisX->min();
+    const double maxX = axisX->max();
+    double lo = std::numeric_limits<double>::max();
+    double hi = std::numeric_limits<double>::lowest();
+
+    // Gaps are not split here; the overlay is for comparing shapes
+    for (const Capture &c : captures) {
+        int first, last;
+        c.trace.visibleRange(minX - c.offset, maxX - c.offset, false, first, last);
+        QList<QPointF> points;
+        for (const QVector<QPointF> &run : c.trace.points(first - 1, last + 1, false, maxPoints)) {
+            for (const QPointF &p : run) {
+                points.append(QPointF(p.x() + c.offset, p.y()));
+                lo = qMin(lo, p.y());
+                hi = qMax(hi, p.y());
+            }
+        }
+        c.series->replace(points);
+    }
+    if (lo <= hi) {
+        const double pad = qMax(1e-6, (hi - lo) * 0.05);
+        axisY->setRange(lo - pad, hi + pad);
+    }
+
+    // Derived trace: min/max per bucket of the visible part
+    QList<QPointF> points;
+    double dlo = std::numeric_limits<double>::max();
+    double dhi = std::numeric_limits<double>::lowest();
+    const int first = qBound(0, int(std::floor(minX)) - derivedX0, int(derived.size()));
+    const int last = qBound(0, int(std::ceil(maxX)) - derivedX0 + 1, int(derived.size()));
+    const int count = last - first;
+    const int buckets = qMin(count, maxPoints / 2);
+    for (int b = 0; b < buckets; ++b) {
+        const int from = first + int(qint64(count) * b / buckets);
+        const int to = first + int(qint64(count) * (b + 1) / buckets);
+        float bmin = derived[from], bmax = derived[from];
+        for (int i = from + 1; i < to; ++i) {
+            bmin = qMin(bmin, derived[i]);
+            bmax = qMax(bmax, derived[i]);
+        }
+        points.append(QPointF(derivedX0 + from, bmin));
+        if (to - from > 1)
+            points.append(QPointF(derivedX0 + from, bmax));
+        if (std::isfinite(bmin))
+            dlo = qMin(dlo, double(bmin));
+        if (std::isfinite(bmax))
+            dhi = qMax(dhi, double(bmax));
+    }
+    derivedSeries->replace(points);
+    derivedAxisX->setRange(minX, maxX);
+    if (dlo <= dhi) {
+        const double pad = qMax(1e-6, (dhi - dlo) * 0.05);
+        derivedAxisY->setRange(dlo - pad, dhi + pad);
+    }
+}
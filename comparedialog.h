@@ -0,0 +1,76 @@
+// comparedialog.h
+#ifndef COMPAREDIALOG_H
+#define COMPAREDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTimer>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
+
+#include "looptrace.h"
+
+// Several loop captures overlaid on one sample axis. Each capture has a
+// sample offset, set by hand or aligned to the first (reference)
+// capture; the difference or ratio of one capture against the reference
+// is computed over their overlap when selected.
+class CompareDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit CompareDialog(QWidget *parent = nullptr);
+
+private slots:
+    void onAddClicked();
+    void onRemoveClicked();
+    void onAlignClicked();
+    void onFitClicked();
+    void onOffsetChanged(int offset);
+    void onSelectionChanged();
+    void updateDerived();
+    void scheduleRender();
+    void render();
+
+private:
+    struct Capture {
+        QString name;
+        LoopTrace trace;
+        QVector<float> values;  // flat copy for the alignment kernels
+        int offset = 0;         // x of sample i is i + offset
+        QLineSeries *series = nullptr;
+    };
+    enum Derived { DerivedNone, DerivedDifference, DerivedRatio };
+
+    void updateRow(int row);
+    void fitRange();
+
+    QList<Capture> captures;
+    QVector<float> derived;     // selected capture against the reference
+    int derivedX0 = 0;
+
+    QTableWidget *table;
+    QPushButton  *addBtn;
+    QPushButton  *removeBtn;
+    QComboBox    *alignCombo;
+    QPushButton  *alignBtn;
+    QSpinBox     *offsetSpin;
+    QComboBox    *derivedCombo;
+    QPushButton  *fitBtn;
+    QLabel       *infoLabel;
+
+    QChart       *chart;
+    QValueAxis   *axisX;
+    QValueAxis   *axisY;
+    QChart       *derivedChart;
+    QLineSeries  *derivedSeries;
+    QValueAxis   *derivedAxisX;
+    QValueAxis   *derivedAxisY;
+    QTimer       *renderTimer;
+};
+
+#endif // COMPAREDIALOG_H
@@ -2,7 +2,6 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
-#include <QRegularExpression>
 
 EEPROMDialog::EEPROMDialog(QSerialPort* port, QWidget* parent)
     : QDialog(parent), serialPort(port)
@@ -66,27 +65,15 @@ void EEPROMDialog::onRefreshClicked()
     requestData();
 }
 
-void EEPROMDialog::appendLine(const QString &line)
+void EEPROMDialog::setRow(int address, const QString &addressText, const QStringList &bytes)
 {
-    // Only handle lines starting with the hex address "0x"
-    if (!line.startsWith("0x"))
-        return;
-
-    // Split on any whitespace
-    QStringList parts = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-    if (parts.size() < 17)
-        return;  // must have addr + 16 bytes
-
-    bool ok;
-    int addr = parts.at(0).mid(2).toInt(&ok, 16);
-    if (!ok) return;
-    int row = addr / 16;
+    int row = address / 16;
 
     // Fill the address column
-    table->setItem(row, 0, new QTableWidgetItem(parts.at(0)));
+    table->setItem(row, 0, new QTableWidgetItem(addressText));
     // Fill the 16 byte columns, center-aligned
     for (int i = 1; i <= 16; ++i) {
-        QString byteStr = parts.value(i, "--");
+        QString byteStr = bytes.value(i - 1, "--");
         auto *item = new QTableWidgetItem(byteStr);
         item->setTextAlignment(Qt::AlignCenter);
         table->setItem(row, i, item);
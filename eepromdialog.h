@@ -14,7 +14,7 @@ public:
 
 public slots:
     void requestData();            // Send the “eeprom” command
-    void appendLine(const QString &line);
+    void setRow(int address, const QString &addressText, const QStringList &bytes);
 
 private slots:
     void onRefreshClicked();
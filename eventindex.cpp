@@ -0,0 +1,132 @@
+// eventindex.cpp
+#include "eventindex.h"
+#include <QObject>
+#include <algorithm>
+
+QString eventKindName(int kind)
+{
+    switch (kind) {
+    case EventPresence:    return QObject::tr("Presence");
+    case EventCalibration: return QObject::tr("Calibration");
+    case EventOpen:        return QObject::tr("Open loop");
+    case EventShort:       return QObject::tr("Short");
+    }
+    return QString();
+}
+
+quint8 loopEventFlags(const LiveFrame &frame, int loop)
+{
+    const bool second = loop == 2;
+    quint8 flags = 0;
+    if (frame.value(second ? FieldState1 : FieldState0) != 0
+        || (second && frame.value(FieldLoop2Event) != 0))
+        flags |= 1 << EventPresence;
+    if (frame.value(second ? FieldCal1 : FieldCal0) != 0)
+        flags |= 1 << EventCalibration;
+    if (frame.value(second ? FieldOpen1 : FieldOpen0) != 0)
+        flags |= 1 << EventOpen;
+    if (frame.value(second ? FieldShort1 : FieldShort0) != 0)
+        flags |= 1 << EventShort;
+    return flags;
+}
+
+void EventIndex::clear()
+{
+    list.clear();
+    for (int k = 0; k < EventKindCount; ++k) {
+        byKind[k].clear();
+        open[k] = -1;
+    }
+    sampleCount = 0;
+}
+
+void EventIndex::addSample(int sample, double timeS, quint8 flags)
+{
+    for (int k = 0; k < EventKindCount; ++k) {
+        const bool active = flags & (1 << k);
+        if (active && open[k] < 0) {
+            open[k] = list.size();
+            byKind[k].append(list.size());
+            list.append({ EventKind(k), sample, -1, timeS, timeS });
+        } else if (active) {
+            list[open[k]].endS = timeS;
+        } else if (open[k] >= 0) {
+            list[open[k]].lastSample = sample;
+            open[k] = -1;
+        }
+    }
+    sampleCount = sample + 1;
+}
+
+void EventIndex::restore(const QVector<DetectionEvent> &events, int samples)
+{
+    clear();
+    list = events;
+    for (int i = 0; i < list.size(); ++i) {
+        const int k = list[i].kind;
+        byKind[k].append(i);
+        if (list[i].lastSample < 0)
+            open[k] = i;
+    }
+    sampleCount = samples;
+}
+
+int EventIndex::endSample(int i) const
+{
+    return list[i].lastSample < 0 ? sampleCount : list[i].lastSample;
+}
+
+int EventIndex::nextEvent(int sample) const
+{
+    auto it = std::upper_bound(list.cbegin(), list.cend(), sample,
+                               [](int s, const DetectionEvent &e) { return s < e.firstSample; });
+    return it == list.cend() ? -1 : int(it - list.cbegin());
+}
+
+int EventIndex::previousEvent(int sample) const
+{
+    auto it = std::lower_bound(list.cbegin(), list.cend(), sample,
+                               [](const DetectionEvent &e, int s) { return e.firstSample < s; });
+    return it == list.cbegin() ? -1 : int(it - list.cbegin()) - 1;
+}
+
+int EventIndex::lowerBoundTime(double timeS) const
+{
+    auto it = std::lower_bound(list.cbegin(), list.cend(), timeS,
+                               [](const DetectionEvent &e, double t) { return e.startS < t; });
+    return int(it - list.cbegin());
+}
+
+int EventIndex::upperBoundTime(double timeS) const
+{
+    auto it = std::upper_bound(list.cbegin(), list.cend(), timeS,
+                               [](double t, const DetectionEvent &e) { return t < e.startS; });
+    return int(it - list.cbegin());
+}
+
+QVector<int> EventIndex::overlapping(int first, int last) const
+{
+    QVector<int> result;
+    for (int k = 0; k < EventKindCount; ++k) {
+        const QVector<int> &idx = byKind[k];
+        // First interval of this kind that ends after 'first'
+        auto it = std::upper_bound(idx.cbegin(), idx.cend(), first,
+                                   [this](int s, int i) { return s < endSample(i); });
+        for (; it != idx.cend() && list[*it].firstSample < last; ++it)
+            result.append(*it);
+    }
+    return result;
+}
+
+quint8 EventIndex::flagsAt(int sample) const
+{
+    quint8 flags = 0;
+    for (int k = 0; k < EventKindCount; ++k) {
+        const QVector<int> &idx = byKind[k];
+        auto it = std::upper_bound(idx.cbegin(), idx.cend(), sample,
+                                   [this](int s, int i) { return s < endSample(i); });
+        if (it != idx.cend() && list[*it].firstSample <= sample)
+            flags |= 1 << k;
+    }
+    return flags;
+}
@@ -0,0 +1,68 @@
+// eventindex.h
+#ifndef EVENTINDEX_H
+#define EVENTINDEX_H
+
+#include <QVector>
+#include <QString>
+
+#include "liveframe.h"
+
+// Kinds of intervals derived from the per-loop LIVE flags
+enum EventKind {
+    EventPresence,      // state (and loop2Event on loop 2) non-zero
+    EventCalibration,   // cal flag set
+    EventOpen,          // open loop error
+    EventShort,         // shorted loop error
+    EventKindCount
+};
+
+struct DetectionEvent {
+    EventKind kind;
+    int       firstSample;
+    int       lastSample;   // exclusive; -1 while the interval is still open
+    double    startS;
+    double    endS;         // time of the last sample inside the interval
+};
+
+QString eventKindName(int kind);
+
+// Bit (1 << EventKind) per active condition of one loop in one frame
+quint8 loopEventFlags(const LiveFrame &frame, int loop);
+
+// Sorted intervals of one loop, built sample by sample. Intervals of one
+// kind never overlap, so per kind both starts and ends are sorted and
+// every lookup is a binary search.
+class EventIndex {
+public:
+    void clear();
+    void addSample(int sample, double timeS, quint8 flags);
+    // Replace the contents with intervals saved from another index of
+    // sampleCount samples; those without an end are still open
+    void restore(const QVector<DetectionEvent> &events, int sampleCount);
+
+    // All intervals in order of their first sample
+    int size() const { return list.size(); }
+    const DetectionEvent &at(int i) const { return list[i]; }
+    int endSample(int i) const;
+
+    // Index of the first event starting after / last event starting
+    // before the given sample, -1 if there is none
+    int nextEvent(int sample) const;
+    int previousEvent(int sample) const;
+
+    // First event starting at or after / strictly after timeS
+    int lowerBoundTime(double timeS) const;
+    int upperBoundTime(double timeS) const;
+
+    // Events overlapping samples [first, last), by kind
+    QVector<int> overlapping(int first, int last) const;
+    quint8 flagsAt(int sample) const;
+
+private:
+    QVector<DetectionEvent> list;
+    QVector<int> byKind[EventKindCount];    // indices into list
+    int    open[EventKindCount] = { -1, -1, -1, -1 };
+    int    sampleCount = 0;
+};
+
+#endif // EVENTINDEX_H
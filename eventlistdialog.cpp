@@ -0,0 +1,144 @@
+// eventlistdialog.cpp
+#include "eventlistdialog.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QVBoxLayout>
+
+EventListDialog::EventListDialog(const LoopTrace *loop1, const LoopTrace *loop2, QWidget *parent)
+    : QDialog(parent), traces{loop1, loop2}
+{
+    setWindowTitle(tr("Events"));
+
+    table = new QTableWidget(0, ColumnCount, this);
+    table->setHorizontalHeaderLabels({tr("Loop"), tr("Kind"), tr("Start (s)"),
+                                      tr("Duration (s)"), tr("Samples")});
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    connect(table, &QTableWidget::cellDoubleClicked,
+            this, &EventListDialog::onCellDoubleClicked);
+
+    searchEdit = new QLineEdit(this);
+    searchEdit->setPlaceholderText(tr("Search"));
+    searchEdit->setClearButtonEnabled(true);
+    connect(searchEdit, &QLineEdit::textChanged, this, &EventListDialog::applyFilter);
+
+    kindCombo = new QComboBox(this);
+    kindCombo->addItem(tr("All kinds"), -1);
+    for (int k = 0; k < EventKindCount; ++k)
+        kindCombo->addItem(eventKindName(k), k);
+    connect(kindCombo, &QComboBox::currentIndexChanged, this, &EventListDialog::applyFilter);
+
+    auto *filterLayout = new QHBoxLayout;
+    filterLayout->addWidget(new QLabel(tr("Filter:"), this));
+    filterLayout->addWidget(searchEdit);
+    filterLayout->addWidget(kindCombo);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(filterLayout);
+    mainLayout->addWidget(table);
+
+    setMinimumSize(600, 500);
+
+    // New events are picked up while the dialog is open
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(1000);
+    connect(refreshTimer, &QTimer::timeout, this, &EventListDialog::refresh);
+}
+
+void EventListDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    shownCount[0] = shownCount[1] = -1;
+    refresh();
+    refreshTimer->start();
+}
+
+void EventListDialog::hideEvent(QHideEvent *event)
+{
+    refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
+
+void EventListDialog::fillRow(int row, int loop, const EventIndex &events, int i)
+{
+    const DetectionEvent &e = events.at(i);
+    const QString texts[ColumnCount] = {
+        QString::number(loop + 1),
+        eventKindName(e.kind),
+        QString::number(e.startS, 'f', 3),
+        QString::number(e.endS - e.startS, 'f', 3),
+        QString::number(events.endSample(i) - e.firstSample)
+    };
+    for (int col = 0; col < ColumnCount; ++col) {
+        QTableWidgetItem *item = table->item(row, col);
+        if (!item) {
+            item = new QTableWidgetItem;
+            if (col != ColKind)
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            table->setItem(row, col, item);
+        }
+        item->setText(texts[col]);
+    }
+    table->item(row, ColLoop)->setData(Qt::UserRole, loop + 1);
+    table->item(row, ColLoop)->setData(Qt::UserRole + 1, i);
+    table->item(row, ColKind)->setData(Qt::UserRole, int(e.kind));
+}
+
+void EventListDialog::refresh()
+{
+    const EventIndex &a = traces[0]->events();
+    const EventIndex &b = traces[1]->events();
+
+    if (a.size() == shownCount[0] && b.size() == shownCount[1]) {
+        // Only the open intervals can have changed
+        for (int row : openRows) {
+            const QTableWidgetItem *item = table->item(row, ColLoop);
+            const int loop = item->data(Qt::UserRole).toInt() - 1;
+            fillRow(row, loop, traces[loop]->events(), item->data(Qt::UserRole + 1).toInt());
+        }
+        return;
+    }
+    shownCount[0] = a.size();
+    shownCount[1] = b.size();
+
+    // Both lists are sorted by start; merge them by time
+    table->setUpdatesEnabled(false);
+    table->setRowCount(a.size() + b.size());
+    openRows.clear();
+    int i = 0, j = 0;
+    for (int row = 0; row < table->rowCount(); ++row) {
+        const bool takeA = j >= b.size() || (i < a.size() && a.at(i).startS <= b.at(j).startS);
+        const EventIndex &events = takeA ? a : b;
+        const int k = takeA ? i++ : j++;
+        fillRow(row, takeA ? 0 : 1, events, k);
+        if (events.at(k).lastSample < 0)
+            openRows.append(row);
+    }
+    table->setUpdatesEnabled(true);
+    applyFilter();
+}
+
+void EventListDialog::applyFilter()
+{
+    const QString text = searchEdit->text().trimmed();
+    const int kind = kindCombo->currentData().toInt();
+    for (int row = 0; row < table->rowCount(); ++row) {
+        bool match = kind < 0 || table->item(row, ColKind)->data(Qt::UserRole).toInt() == kind;
+        if (match && !text.isEmpty()) {
+            match = false;
+            for (int col = 0; col < ColumnCount && !match; ++col)
+                match = table->item(row, col)->text().contains(text, Qt::CaseInsensitive);
+        }
+        table->setRowHidden(row, !match);
+    }
+}
+
+void EventListDialog::onCellDoubleClicked(int row, int)
+{
+    QTableWidgetItem *item = table->item(row, ColLoop);
+    emit eventActivated(item->data(Qt::UserRole).toInt(),
+                        item->data(Qt::UserRole + 1).toInt());
+}
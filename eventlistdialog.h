@@ -0,0 +1,48 @@
+// eventlistdialog.h
+#ifndef EVENTLISTDIALOG_H
+#define EVENTLISTDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QTimer>
+
+#include "looptrace.h"
+
+// Detection and error intervals of both loops, filterable by kind and
+// text. Double-clicking a row jumps the charts to that event.
+class EventListDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    EventListDialog(const LoopTrace *loop1, const LoopTrace *loop2, QWidget *parent = nullptr);
+
+signals:
+    void eventActivated(int loop, int index);
+
+public slots:
+    void refresh();
+
+private slots:
+    void applyFilter();
+    void onCellDoubleClicked(int row, int column);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    enum Column { ColLoop, ColKind, ColStart, ColDuration, ColSamples, ColumnCount };
+    void fillRow(int row, int loop, const EventIndex &events, int i);
+
+    const LoopTrace *traces[2];
+    QTableWidget *table;
+    QLineEdit    *searchEdit;
+    QComboBox    *kindCombo;
+    QTimer       *refreshTimer;
+    int           shownCount[2] = { -1, -1 };
+    QVector<int>  openRows;     // rows whose interval is still growing
+};
+
+#endif // EVENTLISTDIALOG_H
@@ -0,0 +1,47 @@
+// exportdialog.cpp
+#include "exportdialog.h"
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QVBoxLayout>
+
+ExportDialog::ExportDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Export Chart"));
+
+    loopCombo = new QComboBox(this);
+    loopCombo->addItems({tr("Loop 1"), tr("Loop 2"), tr("Both loops")});
+    loopCombo->setCurrentIndex(2);
+
+    rangeCombo = new QComboBox(this);
+    rangeCombo->addItems({tr("Visible range"), tr("Whole capture")});
+
+    widthSpin = new QSpinBox(this);
+    widthSpin->setRange(200, 16000);
+    widthSpin->setValue(1920);
+    widthSpin->setSuffix(tr(" px"));
+    heightSpin = new QSpinBox(this);
+    heightSpin->setRange(200, 16000);
+    heightSpin->setValue(1080);
+    heightSpin->setSuffix(tr(" px"));
+
+    auto *sizeLayout = new QHBoxLayout;
+    sizeLayout->addWidget(widthSpin);
+    sizeLayout->addWidget(new QLabel(QStringLiteral("x"), this));
+    sizeLayout->addWidget(heightSpin);
+
+    auto *form = new QFormLayout;
+    form->addRow(tr("Loops:"), loopCombo);
+    form->addRow(tr("Range:"), rangeCombo);
+    form->addRow(tr("Size:"), sizeLayout);
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(form);
+    mainLayout->addWidget(buttons);
+}
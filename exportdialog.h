@@ -0,0 +1,28 @@
+// exportdialog.h
+#ifndef EXPORTDIALOG_H
+#define EXPORTDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QSpinBox>
+
+// Options of a chart export: which loops, which range and the size
+class ExportDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit ExportDialog(QWidget *parent = nullptr);
+
+    bool loop1() const { return loopCombo->currentIndex() != 1; }
+    bool loop2() const { return loopCombo->currentIndex() != 0; }
+    bool wholeCapture() const { return rangeCombo->currentIndex() == 1; }
+    QSize size() const { return QSize(widthSpin->value(), heightSpin->value()); }
+
+private:
+    QComboBox *loopCombo;
+    QComboBox *rangeCombo;
+    QSpinBox  *widthSpin;
+    QSpinBox  *heightSpin;
+};
+
+#endif // EXPORTDIALOG_H
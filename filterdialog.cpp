@@ -0,0 +1,139 @@
+// filterdialog.cpp
+#include "filterdialog.h"
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+FilterDialog::FilterDialog(const FilterSettings &loop1, const FilterSettings &loop2,
+                           bool showRaw, bool showFiltered, QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Filters"));
+
+    auto *loopLayout = new QHBoxLayout;
+    loopLayout->addWidget(createLoopBox(0, loop1));
+    loopLayout->addWidget(createLoopBox(1, loop2));
+
+    rateSpin = new QDoubleSpinBox(this);
+    rateSpin->setRange(0.1, 100000.0);
+    rateSpin->setDecimals(1);
+    rateSpin->setSuffix(tr(" Hz"));
+    rateSpin->setValue(loop1.sampleRateHz);
+
+    rawCheck = new QCheckBox(tr("Show raw"), this);
+    rawCheck->setChecked(showRaw);
+    filteredCheck = new QCheckBox(tr("Show filtered"), this);
+    filteredCheck->setChecked(showFiltered);
+    auto emitDisplay = [this]() {
+        emit displayChanged(rawCheck->isChecked(), filteredCheck->isChecked());
+    };
+    connect(rawCheck, &QCheckBox::toggled, this, emitDisplay);
+    connect(filteredCheck, &QCheckBox::toggled, this, emitDisplay);
+
+    applyBtn = new QPushButton(tr("Apply"), this);
+    applyBtn->setDefault(true);
+    connect(applyBtn, &QPushButton::clicked, this, &FilterDialog::onApplyClicked);
+
+    auto *form = new QFormLayout;
+    form->addRow(tr("Sample rate:"), rateSpin);
+
+    auto *btnLayout = new QHBoxLayout;
+    btnLayout->addWidget(rawCheck);
+    btnLayout->addWidget(filteredCheck);
+    btnLayout->addStretch();
+    btnLayout->addWidget(applyBtn);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(loopLayout);
+    mainLayout->addLayout(form);
+    mainLayout->addLayout(btnLayout);
+
+    updateEnabled();
+}
+
+QWidget *FilterDialog::createLoopBox(int loop, const FilterSettings &s)
+{
+    LoopWidgets &w = loops[loop];
+    auto *box = new QGroupBox(tr("Loop %1").arg(loop + 1), this);
+
+    w.kind = new QComboBox(box);
+    for (int i = 0; i < FilterKindCount; ++i)
+        w.kind->addItem(filterKindName(i));
+    w.kind->setCurrentIndex(s.kind);
+    connect(w.kind, &QComboBox::currentIndexChanged, this, &FilterDialog::updateEnabled);
+
+    w.length = new QSpinBox(box);
+    w.length->setRange(1, 1023);
+    w.length->setValue(s.length);
+    w.length->setSuffix(tr(" samples"));
+
+    w.cutoff = new QDoubleSpinBox(box);
+    w.cutoff->setRange(0.001, 50000.0);
+    w.cutoff->setDecimals(3);
+    w.cutoff->setSuffix(tr(" Hz"));
+    w.cutoff->setValue(s.cutoffHz);
+
+    w.notch = new QDoubleSpinBox(box);
+    w.notch->setRange(0.001, 50000.0);
+    w.notch->setDecimals(3);
+    w.notch->setSuffix(tr(" Hz"));
+    w.notch->setValue(s.notchHz);
+
+    w.q = new QDoubleSpinBox(box);
+    w.q->setRange(0.1, 100.0);
+    w.q->setDecimals(3);
+    w.q->setValue(s.q);
+
+    w.decimation = new QSpinBox(box);
+    w.decimation->setRange(1, 1000);
+    w.decimation->setValue(s.decimation);
+
+    w.saveBtn = new QPushButton(tr("Save Filtered..."), box);
+    connect(w.saveBtn, &QPushButton::clicked, this, [this, loop]() { emit saveRequested(loop + 1); });
+
+    auto *form = new QFormLayout(box);
+    form->addRow(tr("Filter:"), w.kind);
+    form->addRow(tr("Window / taps:"), w.length);
+    form->addRow(tr("Cutoff:"), w.cutoff);
+    form->addRow(tr("Notch:"), w.notch);
+    form->addRow(tr("Q:"), w.q);
+    form->addRow(tr("Decimation:"), w.decimation);
+    form->addRow(w.saveBtn);
+    return box;
+}
+
+FilterSettings FilterDialog::settings(int loop) const
+{
+    const LoopWidgets &w = loops[loop];
+    FilterSettings s;
+    s.kind = FilterKind(w.kind->currentIndex());
+    s.length = w.length->value();
+    s.cutoffHz = w.cutoff->value();
+    s.notchHz = w.notch->value();
+    s.q = w.q->value();
+    s.decimation = w.decimation->value();
+    s.sampleRateHz = rateSpin->value();
+    return s;
+}
+
+void FilterDialog::updateEnabled()
+{
+    // Only the parameters the chosen filter uses
+    for (LoopWidgets &w : loops) {
+        const int kind = w.kind->currentIndex();
+        w.length->setEnabled(kind == FilterMovingAverage || kind == FilterMedian
+                             || kind == FilterDecimatingFir);
+        w.cutoff->setEnabled(kind == FilterLowPass || kind == FilterDecimatingFir);
+        w.notch->setEnabled(kind == FilterNotch);
+        w.q->setEnabled(kind == FilterLowPass || kind == FilterNotch);
+        w.decimation->setEnabled(kind == FilterDecimatingFir);
+        w.saveBtn->setEnabled(kind != FilterOff);
+    }
+}
+
+void FilterDialog::onApplyClicked()
+{
+    for (int loop = 0; loop < 2; ++loop)
+        emit filterChanged(loop + 1, settings(loop));
+}
@@ -0,0 +1,52 @@
+// filterdialog.h
+#ifndef FILTERDIALOG_H
+#define FILTERDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QCheckBox>
+#include <QPushButton>
+
+#include "loopfilter.h"
+
+// Per-loop filter settings and the choice of raw and/or filtered traces
+// on the charts. Apply refilters everything recorded or loaded so far.
+class FilterDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    FilterDialog(const FilterSettings &loop1, const FilterSettings &loop2,
+                 bool showRaw, bool showFiltered, QWidget *parent = nullptr);
+
+signals:
+    void filterChanged(int loop, const FilterSettings &settings);
+    void displayChanged(bool showRaw, bool showFiltered);
+    void saveRequested(int loop);
+
+private slots:
+    void onApplyClicked();
+    void updateEnabled();
+
+private:
+    struct LoopWidgets {
+        QComboBox      *kind;
+        QSpinBox       *length;
+        QDoubleSpinBox *cutoff;
+        QDoubleSpinBox *notch;
+        QDoubleSpinBox *q;
+        QSpinBox       *decimation;
+        QPushButton    *saveBtn;
+    };
+    QWidget *createLoopBox(int loop, const FilterSettings &settings);
+    FilterSettings settings(int loop) const;
+
+    LoopWidgets     loops[2];
+    QDoubleSpinBox *rateSpin;
+    QCheckBox      *rawCheck;
+    QCheckBox      *filteredCheck;
+    QPushButton    *applyBtn;
+};
+
+#endif // FILTERDIALOG_H
@@ -0,0 +1,168 @@
+// framedecoder.cpp
+#include "framedecoder.h"
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+// Fields sent as float32; all others are a single byte
+bool isAnalog(int field)
+{
+    return field == FieldFreq0 || field == FieldFreq1
+           || (field >= FieldBase0 && field <= FieldShort1);
+}
+
+struct CrcTable {
+    quint16 t[256];
+    CrcTable()
+    {
+        for (int i = 0; i < 256; ++i) {
+            quint16 c = quint16(i << 8);
+            for (int b = 0; b < 8; ++b)
+                c = (c & 0x8000) ? quint16((c << 1) ^ 0x1021) : quint16(c << 1);
+            t[i] = c;
+        }
+    }
+};
+
+const CrcTable crcTable;
+
+} // namespace
+
+int BinaryFrame::payloadSize()
+{
+    static const int size = [] {
+        int n = 4;  // sequence number
+        for (int i = 0; i < LiveFieldCount; ++i)
+            n += isAnalog(i) ? 4 : 1;
+        return n;
+    }();
+    return size;
+}
+
+int BinaryFrame::frameSize()
+{
+    return headerSize + payloadSize() + crcSize;
+}
+
+quint16 BinaryFrame::crc16(const char *data, int size, quint16 crc)
+{
+    for (int i = 0; i < size; ++i)
+        crc = quint16(crc << 8) ^ crcTable.t[(crc >> 8) ^ quint8(data[i])];
+    return crc;
+}
+
+QByteArray BinaryFrame::encode(const LiveFrame &frame, quint32 seq)
+{
+    QByteArray out(frameSize(), Qt::Uninitialized);
+    uchar *p = reinterpret_cast<uchar *>(out.data());
+    *p++ = sync0;
+    *p++ = sync1;
+    *p++ = quint8(payloadSize());
+    for (int i = 0; i < LiveFieldCount; ++i) {
+        if (isAnalog(i)) {
+            const float f = float(frame.values[i]);
+            quint32 bits;
+            std::memcpy(&bits, &f, 4);
+            qToLittleEndian(bits, p);
+            p += 4;
+        } else {
+            *p++ = quint8(qBound(0.0, frame.values[i], 255.0));
+        }
+    }
+    qToLittleEndian(seq, p);
+    p += 4;
+    qToLittleEndian(crc16(out.constData() + 2, 1 + payloadSize()), p);
+    return out;
+}
+
+void FrameDecoder::clear()
+{
+    buffer.clear();
+    frames = badCrc = dropped = 0;
+}
+
+int FrameDecoder::frameAt(int pos) const
+{
+    const int avail = buffer.size() - pos;
+    if (avail < 2)
+        return 0;
+    if (quint8(buffer[pos + 1]) != BinaryFrame::sync1)
+        return -1;
+    if (avail < 3)
+        return 0;
+    if (quint8(buffer[pos + 2]) != BinaryFrame::payloadSize())
+        return -1;
+    const int size = BinaryFrame::frameSize();
+    if (avail < size)
+        return 0;
+    const int crcPos = pos + BinaryFrame::headerSize + BinaryFrame::payloadSize();
+    const quint16 crc = qFromLittleEndian<quint16>(buffer.constData() + crcPos);
+    if (BinaryFrame::crc16(buffer.constData() + pos + 2, crcPos - pos - 2) != crc)
+        return -2;
+    return size;
+}
+
+void FrameDecoder::feed(const QByteArray &chunk, QList<DecodedItem> &out)
+{
+    buffer.append(chunk);
+
+    int start = 0;      // first byte not yet handed out
+    int pos = 0;
+    const char *data = buffer.constData();
+    while (pos < buffer.size()) {
+        const char c = data[pos];
+        if (c == '\n') {
+            DecodedItem item;
+            item.line = buffer.mid(start, pos + 1 - start);
+            out.append(item);
+            start = ++pos;
+            continue;
+        }
+        if (quint8(c) != BinaryFrame::sync0) {
+            ++pos;
+            continue;
+        }
+
+        const int size = frameAt(pos);
+        if (size == 0)
+            break;          // wait for the rest of a possible frame
+        if (size < 0) {
+            // Plain byte after all; a corrupted frame falls through here
+            // and the scan resynchronises on the next sync word
+            if (size == -2)
+                ++badCrc;
+            ++pos;
+            continue;
+        }
+
+        // Bytes before a frame are the remains of a broken frame or line
+        dropped += pos - start;
+        DecodedItem item;
+        item.binary = true;
+        LiveFrame &frame = item.frame;
+        const uchar *p = reinterpret_cast<const uchar *>(data + pos + BinaryFrame::headerSize);
+        for (int i = 0; i < LiveFieldCount; ++i) {
+            if (isAnalog(i)) {
+                const quint32 bits = qFromLittleEndian<quint32>(p);
+                float f;
+                std::memcpy(&f, &bits, 4);
+                frame.values[i] = f;
+                p += 4;
+            } else {
+                frame.values[i] = *p++;
+            }
+        }
+        frame.validMask = (1u << LiveFieldCount) - 1;
+        frame.deviceSeq = qFromLittleEndian<quint32>(p);
+        out.append(item);
+        ++frames;
+        start = pos += size;
+    }
+
+    buffer.remove(0, start);
+    if (buffer.size() > maxLineLength) {
+        dropped += buffer.size();
+        buffer.clear();     // garbage without line breaks or frames
+    }
+}
@@ -0,0 +1,59 @@
+// framedecoder.h
+#ifndef FRAMEDECODER_H
+#define FRAMEDECODER_H
+
+#include <QByteArray>
+#include <QList>
+
+#include "liveframe.h"
+
+// Binary LIVE frame, negotiated with the "binary" command:
+//   A5 5A | len (u8) | payload (len bytes) | CRC16 (u16 LE)
+// The payload holds the LIVE fields in LiveField order, little-endian:
+// analog fields (freq, base, std, jump, open, short) as float32, flags
+// and modes as u8, followed by a u32 frame sequence number. The CRC is
+// CRC-16/CCITT-FALSE over len and payload.
+namespace BinaryFrame {
+const quint8 sync0 = 0xA5;
+const quint8 sync1 = 0x5A;
+const int headerSize = 3;
+const int crcSize = 2;
+int payloadSize();
+int frameSize();
+quint16 crc16(const char *data, int size, quint16 crc = 0xFFFF);
+QByteArray encode(const LiveFrame &frame, quint32 seq);
+}
+
+struct DecodedItem {
+    bool       binary = false;
+    QByteArray line;        // ASCII line including its terminator
+    LiveFrame  frame;       // decoded binary frame
+};
+
+// Splits the serial byte stream into ASCII lines and binary frames.
+// Both may arrive on the same stream, so firmware without binary
+// support keeps working. A sync word only counts as a frame when the
+// length matches and the CRC checks out; otherwise its bytes are
+// treated as text and scanning resumes at the next byte.
+class FrameDecoder {
+public:
+    void clear();
+    void feed(const QByteArray &chunk, QList<DecodedItem> &out);
+
+    qint64 binaryFrames() const { return frames; }
+    qint64 crcErrors() const { return badCrc; }
+    qint64 droppedBytes() const { return dropped; }
+
+    static const int maxLineLength = 64 * 1024;
+
+private:
+    // > 0: frame length, 0: need more bytes, -1: not a frame, -2: bad CRC
+    int frameAt(int pos) const;
+
+    QByteArray buffer;      // partial line or frame carried between chunks
+    qint64 frames = 0;
+    qint64 badCrc = 0;
+    qint64 dropped = 0;
+};
+
+#endif // FRAMEDECODER_H
@@ -0,0 +1,128 @@
+// frameserver.cpp
+#include "frameserver.h"
+#include "framedecoder.h"
+#include <cmath>
+
+FrameServer::FrameServer(QObject *parent)
+    : QObject(parent)
+{
+    connect(&server, &QTcpServer::newConnection, this, &FrameServer::onNewConnection);
+}
+
+FrameServer::~FrameServer()
+{
+    close();
+}
+
+bool FrameServer::listen(quint16 port, const QHostAddress &address)
+{
+    close();
+    return server.listen(address, port);
+}
+
+void FrameServer::close()
+{
+    server.close();
+    while (!clients.isEmpty())
+        removeClient(clients.first());
+}
+
+void FrameServer::onNewConnection()
+{
+    while (QTcpSocket *socket = server.nextPendingConnection()) {
+        auto *client = new Client;
+        client->socket = socket;
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(socket, &QTcpSocket::bytesWritten, this, [this, client]() { flush(client); });
+        connect(socket, &QTcpSocket::readyRead, this, [this, client]() { readCommands(client); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, client]() { removeClient(client); });
+        clients.append(client);
+    }
+    emit clientsChanged(clients.size());
+}
+
+void FrameServer::removeClient(Client *client)
+{
+    if (!clients.removeOne(client))
+        return;
+    client->socket->disconnect(this);
+    client->socket->abort();
+    client->socket->deleteLater();
+    delete client;
+    emit clientsChanged(clients.size());
+}
+
+void FrameServer::readCommands(Client *client)
+{
+    client->command.append(client->socket->readAll());
+    qsizetype newline;
+    while ((newline = client->command.indexOf('\n')) >= 0) {
+        const QByteArray cmd = client->command.left(newline).trimmed().toLower();
+        client->command.remove(0, newline + 1);
+        if (cmd == "binary")
+            client->binary = true;
+        else if (cmd == "json")
+            client->binary = false;
+    }
+    if (client->command.size() > 256)
+        client->command.clear();
+}
+
+void FrameServer::flush(Client *client)
+{
+    // Hand frames to the socket only while its own buffer is small, so the
+    // backlog stays in our bounded queue where it can be dropped
+    while (!client->queue.isEmpty() && client->socket->bytesToWrite() < socketHighWater)
+        client->socket->write(client->queue.dequeue());
+}
+
+QByteArray FrameServer::encodeJson(const LiveFrame &frame)
+{
+    QByteArray out;
+    out.reserve(512);
+    out += "{\"t\":";
+    out += QByteArray::number(frame.hostTimeUs / 1e6, 'f', 6);
+    if (frame.deviceSeq >= 0) {
+        out += ",\"seq\":";
+        out += QByteArray::number(frame.deviceSeq);
+    }
+    for (int i = 0; i < LiveFieldCount; ++i) {
+        if (!frame.isValid(LiveField(i)))
+            continue;
+        out += ",\"";
+        out += liveFieldName(i).toLatin1();
+        out += "\":";
+        // JSON has no nan or inf
+        if (std::isfinite(frame.values[i]))
+            out += QByteArray::number(frame.values[i], 'g', 10);
+        else
+            out += "null";
+    }
+    out += "}\n";
+    return out;
+}
+
+void FrameServer::publish(const LiveFrame &frame)
+{
+    ++sequence;
+    if (clients.isEmpty())
+        return;
+
+    // Encoded lazily, once per format; every queue shares the same data
+    QByteArray json, binary;
+    for (Client *client : clients) {
+        QByteArray &encoded = client->binary ? binary : json;
+        if (encoded.isNull()) {
+            encoded = client->binary ? BinaryFrame::encode(frame, frame.deviceSeq >= 0
+                                                                    ? quint32(frame.deviceSeq)
+                                                                    : sequence)
+                                     : encodeJson(frame);
+        }
+        if (client->queue.size() >= maxQueued) {
+            client->queue.dequeue();    // drop oldest
+            ++dropped;
+        }
+        client->queue.enqueue(encoded);
+        flush(client);
+    }
+}
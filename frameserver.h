@@ -0,0 +1,64 @@
+// frameserver.h
+#ifndef FRAMESERVER_H
+#define FRAMESERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QQueue>
+#include <QList>
+
+#include "liveframe.h"
+
+// Publishes every parsed LIVE frame to any number of TCP clients.
+// Clients get JSON lines by default and may send "binary\n" to switch to
+// the binary frame format (see framedecoder.h) or "json\n" to switch
+// back. Each frame is encoded at most once per format; clients queue
+// references to the same buffer. A client that cannot keep up loses its
+// oldest queued frames, never stalling acquisition. Only local clients
+// can connect unless listen() is given a wider address.
+class FrameServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FrameServer(QObject *parent = nullptr);
+    ~FrameServer() override;
+
+    bool listen(quint16 port, const QHostAddress &address = QHostAddress::LocalHost);
+    void close();
+    bool isListening() const { return server.isListening(); }
+    quint16 port() const { return server.serverPort(); }
+    int clientCount() const { return clients.size(); }
+    qint64 droppedFrames() const { return dropped; }
+
+    void setMaxQueuedFrames(int frames) { maxQueued = qMax(1, frames); }
+    void publish(const LiveFrame &frame);
+
+signals:
+    void clientsChanged(int count);
+
+private slots:
+    void onNewConnection();
+
+private:
+    struct Client {
+        QTcpSocket *socket = nullptr;
+        bool binary = false;
+        QQueue<QByteArray> queue;   // shared, already encoded frames
+        QByteArray command;         // partial command line
+    };
+    void flush(Client *client);
+    void readCommands(Client *client);
+    void removeClient(Client *client);
+    static QByteArray encodeJson(const LiveFrame &frame);
+
+    static const qint64 socketHighWater = 64 * 1024;
+
+    QTcpServer server;
+    QList<Client*> clients;
+    int maxQueued = 256;
+    qint64 dropped = 0;
+    quint32 sequence = 0;
+};
+
+#endif // FRAMESERVER_H
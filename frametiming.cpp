@@ -0,0 +1,74 @@
+// frametiming.cpp
+#include "frametiming.h"
+#include <cmath>
+
+FrameTiming::FrameTiming() : nominalUs(100000), gapFactor(2.5) { reset(); }
+
+void FrameTiming::reset()
+{
+    frameCount = 0;
+    gapCount = 0;
+    lostCount = 0;
+    lastHostUs = -1;
+    lastSeq = -1;
+    ewmaInterval = 0.0;
+    intervalCount = 0;
+    intervalMean = 0.0;
+    intervalM2 = 0.0;
+    intervalMin = 0.0;
+    intervalMax = 0.0;
+}
+
+bool FrameTiming::addFrame(qint64 hostUs, qint64 deviceSeq)
+{
+    ++frameCount;
+    bool gap = false;
+
+    if (lastHostUs >= 0) {
+        const double interval = double(hostUs - lastHostUs);
+
+        // Sequence numbers from the device are authoritative when present
+        if (deviceSeq >= 0 && lastSeq >= 0) {
+            qint64 missed = deviceSeq - lastSeq - 1;
+            if (missed > 0) {
+                gap = true;
+                lostCount += missed;
+            }
+        } else {
+            // Otherwise compare against the expected poll interval
+            const double expected = qMax(double(nominalUs), ewmaInterval);
+            if (interval > gapFactor * expected) {
+                gap = true;
+                lostCount += qMax<qint64>(0, qRound64(interval / expected) - 1);
+            }
+        }
+
+        if (gap) {
+            ++gapCount;
+        } else {
+            ewmaInterval = (intervalCount == 0) ? interval
+                                                : ewmaInterval + 0.1 * (interval - ewmaInterval);
+            ++intervalCount;
+            double delta = interval - intervalMean;
+            intervalMean += delta / intervalCount;
+            intervalM2 += delta * (interval - intervalMean);
+            intervalMin = (intervalCount == 1) ? interval : qMin(intervalMin, interval);
+            intervalMax = (intervalCount == 1) ? interval : qMax(intervalMax, interval);
+        }
+    }
+
+    lastHostUs = hostUs;
+    if (deviceSeq >= 0)
+        lastSeq = deviceSeq;
+    return gap;
+}
+
+double FrameTiming::rateHz() const
+{
+    return ewmaInterval > 0 ? 1e6 / ewmaInterval : 0.0;
+}
+
+double FrameTiming::jitterMs() const
+{
+    return intervalCount > 1 ? std::sqrt(intervalM2 / (intervalCount - 1)) / 1000.0 : 0.0;
+}
@@ -0,0 +1,49 @@
+// frametiming.h
+#ifndef FRAMETIMING_H
+#define FRAMETIMING_H
+
+#include <QtGlobal>
+
+// Measures the real arrival rate of LIVE frames from their host timestamps
+// (and optional device sequence numbers) and flags gaps where frames were
+// lost or delayed, e.g. while the GUI was stalled.
+class FrameTiming {
+public:
+    FrameTiming();
+
+    void setNominalInterval(qint64 us) { nominalUs = qMax<qint64>(1, us); }
+    void setGapFactor(double factor) { gapFactor = factor; }
+    void reset();
+
+    // Returns true if a gap precedes this frame
+    bool addFrame(qint64 hostUs, qint64 deviceSeq = -1);
+
+    qint64 frames() const { return frameCount; }
+    qint64 gaps() const { return gapCount; }
+    qint64 lostFrames() const { return lostCount; }
+    double rateHz() const;
+    double meanIntervalMs() const { return intervalMean / 1000.0; }
+    double jitterMs() const;      // std deviation of the regular intervals
+    double minIntervalMs() const { return intervalMin / 1000.0; }
+    double maxIntervalMs() const { return intervalMax / 1000.0; }
+
+private:
+    qint64 nominalUs;
+    double gapFactor;
+
+    qint64 frameCount;
+    qint64 gapCount;
+    qint64 lostCount;
+    qint64 lastHostUs;
+    qint64 lastSeq;
+
+    double ewmaInterval;
+    // Welford over gap-free intervals
+    qint64 intervalCount;
+    double intervalMean;
+    double intervalM2;
+    double intervalMin;
+    double intervalMax;
+};
+
+#endif // FRAMETIMING_H
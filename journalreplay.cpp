@@ -0,0 +1,94 @@
+// journalreplay.cpp
+#include "journalreplay.h"
+#include "serialjournal.h"
+#include <QtEndian>
+#include <cstring>
+
+// Chunks delivered per timer slice, so the GUI keeps repainting even
+// when replaying as fast as possible or catching up
+static const int maxBatch = 256;
+
+JournalReplay::JournalReplay(QObject *parent) : QObject(parent)
+{
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &JournalReplay::deliver);
+}
+
+bool JournalReplay::open(const QString &fileName)
+{
+    stop();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    char header[JournalFormat::headerSize];
+    if (file.read(header, sizeof(header)) != sizeof(header)
+        || std::memcmp(header, JournalFormat::magic, 8) != 0
+        || qFromLittleEndian<quint32>(header + 8) != JournalFormat::version) {
+        file.close();
+        return false;
+    }
+    firstTimeUs = -1;
+    chunkCount = 0;
+    havePending = readNext();
+    if (havePending)
+        firstTimeUs = pendingTimeUs;
+    return true;
+}
+
+void JournalReplay::start(double replaySpeed)
+{
+    if (!file.isOpen())
+        return;
+    speed = replaySpeed;
+    wallClock.start();
+    timer->start(0);
+}
+
+void JournalReplay::stop()
+{
+    timer->stop();
+    if (file.isOpen())
+        file.close();
+    havePending = false;
+}
+
+bool JournalReplay::readNext()
+{
+    char header[JournalFormat::recordHeaderSize];
+    if (file.read(header, sizeof(header)) != sizeof(header))
+        return false;
+    pendingTimeUs = qint64(qFromLittleEndian<quint64>(header));
+    pendingDirection = quint8(header[8]);
+    quint32 length = qFromLittleEndian<quint32>(header + 9);
+    pendingData = file.read(length);
+    return pendingData.size() == qsizetype(length);
+}
+
+void JournalReplay::deliver()
+{
+    int batch = 0;
+    while (havePending) {
+        if (batch >= maxBatch) {
+            timer->start(0);
+            return;
+        }
+        if (speed > 0) {
+            qint64 dueUs = qint64((pendingTimeUs - firstTimeUs) / speed);
+            qint64 nowUs = wallClock.nsecsElapsed() / 1000;
+            if (dueUs > nowUs) {
+                timer->start(int(qMax<qint64>(0, (dueUs - nowUs) / 1000)));
+                return;
+            }
+        }
+        if (pendingDirection == SerialJournal::Inbound) {
+            ++chunkCount;
+            ++batch;
+            emit chunkReady(pendingData, pendingTimeUs);
+        }
+        havePending = readNext();
+    }
+    file.close();
+    emit finished();
+}
@@ -0,0 +1,50 @@
+// journalreplay.h
+#ifndef JOURNALREPLAY_H
+#define JOURNALREPLAY_H
+
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QByteArray>
+
+// Plays the inbound chunks of a serial journal back with their original
+// timing, scaled by speed (0 = as fast as possible).
+class JournalReplay : public QObject {
+    Q_OBJECT
+
+public:
+    explicit JournalReplay(QObject *parent = nullptr);
+
+    bool open(const QString &fileName);
+    void start(double speed);
+    void stop();
+    bool isRunning() const { return file.isOpen(); }
+    qint64 chunksReplayed() const { return chunkCount; }
+
+signals:
+    // timeUs is the original arrival time from the journal
+    void chunkReady(const QByteArray &chunk, qint64 timeUs);
+    void finished();
+
+private slots:
+    void deliver();
+
+private:
+    bool readNext();
+
+    QFile file;
+    QTimer *timer;
+    QElapsedTimer wallClock;
+    double speed = 1.0;
+    qint64 firstTimeUs = -1;
+    qint64 chunkCount = 0;
+
+    // Record read ahead, not yet delivered
+    bool havePending = false;
+    qint64 pendingTimeUs = 0;
+    quint8 pendingDirection = 0;
+    QByteArray pendingData;
+};
+
+#endif // JOURNALREPLAY_H
@@ -0,0 +1,54 @@
+// liveframe.cpp
+#include "liveframe.h"
+#include <QStringList>
+
+static const char *const fieldNames[LiveFieldCount] = {
+    "freq0", "freq1",
+    "state0", "state1",
+    "base0", "base1",
+    "std0", "std1",
+    "jump0", "jump1",
+    "open0", "open1",
+    "short0", "short1",
+    "cal0", "cal1",
+    "sens1", "sens2",
+    "boost",
+    "freq_change",
+    "loop2_event",
+    "detect_mode"
+};
+
+bool parseLiveFrame(const QString &line, LiveFrame &frame)
+{
+    static const QString prefix = QStringLiteral("LIVE:");
+    if (!line.startsWith(prefix))
+        return false;
+
+    QStringList parts = line.mid(prefix.length()).split(',', Qt::KeepEmptyParts);
+    if (parts.size() != LiveFieldCount && parts.size() != LiveFieldCount + 1)
+        return false;
+
+    frame.validMask = 0;
+    for (int i = 0; i < LiveFieldCount; ++i) {
+        bool ok;
+        frame.values[i] = parts[i].toDouble(&ok);
+        if (ok)
+            frame.validMask |= (1u << i);
+    }
+
+    frame.deviceSeq = -1;
+    if (parts.size() > LiveFieldCount) {
+        bool ok;
+        qint64 seq = parts[LiveFieldCount].toLongLong(&ok);
+        if (ok)
+            frame.deviceSeq = seq;
+    }
+    return true;
+}
+
+QString liveFieldName(int field)
+{
+    if (field < 0 || field >= LiveFieldCount)
+        return QString();
+    return QString::fromLatin1(fieldNames[field]);
+}
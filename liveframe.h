@@ -0,0 +1,44 @@
+// liveframe.h
+#ifndef LIVEFRAME_H
+#define LIVEFRAME_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Field order of the comma separated payload of a "LIVE:" line
+enum LiveField {
+    FieldFreq0, FieldFreq1,
+    FieldState0, FieldState1,
+    FieldBase0, FieldBase1,
+    FieldStd0, FieldStd1,
+    FieldJump0, FieldJump1,
+    FieldOpen0, FieldOpen1,
+    FieldShort0, FieldShort1,
+    FieldCal0, FieldCal1,
+    FieldSens1, FieldSens2,
+    FieldBoost,
+    FieldFreqChange,
+    FieldLoop2Event,
+    FieldDetectMode,
+    LiveFieldCount
+};
+
+struct LiveFrame {
+    double  values[LiveFieldCount] = {};
+    quint32 validMask = 0;      // bit n set when field n parsed cleanly
+    qint64  hostTimeUs = 0;     // host clock when the frame's bytes arrived
+    qint64  deviceSeq = -1;     // optional trailing sequence number / tick
+
+    double value(LiveField field) const { return values[field]; }
+    bool isValid(LiveField field) const { return validMask & (1u << field); }
+};
+
+// Parse a complete "LIVE:..." line. Returns false if the prefix or the
+// number of fields does not match; fields that fail to convert are left
+// at 0 and cleared in validMask. Firmware that appends a 23rd field gets
+// it stored as deviceSeq.
+bool parseLiveFrame(const QString &line, LiveFrame &frame);
+
+QString liveFieldName(int field);
+
+#endif // LIVEFRAME_H
@@ -0,0 +1,234 @@
+// loopfilter.cpp
+#include "loopfilter.h"
+#include "looptrace.h"
+#include "simdkernels.h"
+#include <QObject>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+const double pi = 3.14159265358979323846;
+}
+
+QString filterKindName(int kind)
+{
+    switch (kind) {
+    case FilterOff:           return QObject::tr("Off");
+    case FilterMovingAverage: return QObject::tr("Moving average");
+    case FilterMedian:        return QObject::tr("Median");
+    case FilterLowPass:       return QObject::tr("Low-pass (IIR)");
+    case FilterNotch:         return QObject::tr("Notch (IIR)");
+    case FilterDecimatingFir: return QObject::tr("Decimating FIR");
+    }
+    return QString();
+}
+
+LoopFilter::LoopFilter(const FilterSettings &settings)
+{
+    setSettings(settings);
+}
+
+void LoopFilter::setSettings(const FilterSettings &settings)
+{
+    cfg = settings;
+    cfg.length = qBound(1, cfg.length, 1023);
+    cfg.decimation = qMax(1, cfg.decimation);
+    cfg.sampleRateHz = qMax(1e-3, cfg.sampleRateHz);
+
+    // Biquads from the RBJ audio EQ cookbook; both have unity DC gain,
+    // which the bias subtraction relies on
+    if (cfg.kind == FilterLowPass || cfg.kind == FilterNotch) {
+        const double f0 = cfg.kind == FilterLowPass ? cfg.cutoffHz : cfg.notchHz;
+        const double w0 = 2.0 * pi * qBound(1e-6, f0 / cfg.sampleRateHz, 0.49);
+        const double alpha = std::sin(w0) / (2.0 * qMax(0.05, cfg.q));
+        const double c = std::cos(w0);
+        const double a0 = 1.0 + alpha;
+        if (cfg.kind == FilterLowPass) {
+            b0 = b2 = (1.0 - c) / 2.0 / a0;
+            b1 = (1.0 - c) / a0;
+        } else {
+            b0 = b2 = 1.0 / a0;
+            b1 = -2.0 * c / a0;
+        }
+        a1 = -2.0 * c / a0;
+        a2 = (1.0 - alpha) / a0;
+    }
+
+    // Windowed-sinc low-pass below the new Nyquist rate, Hamming window,
+    // normalised to unity DC gain
+    if (cfg.kind == FilterDecimatingFir) {
+        const int n = qMax(3, cfg.length);
+        const double fc = qMin(cfg.cutoffHz / cfg.sampleRateHz, 0.45 / cfg.decimation);
+        taps.resize(n);
+        double sum = 0.0;
+        for (int k = 0; k < n; ++k) {
+            const double t = k - (n - 1) / 2.0;
+            const double sinc = t == 0.0 ? 2.0 * fc : std::sin(2.0 * pi * fc * t) / (pi * t);
+            const double window = 0.54 - 0.46 * std::cos(2.0 * pi * k / (n - 1));
+            taps[k] = float(sinc * window);
+            sum += taps[k];
+        }
+        for (float &tap : taps)
+            tap = float(tap / sum);
+    } else {
+        taps.clear();
+    }
+    reset();
+}
+
+int LoopFilter::delay() const
+{
+    switch (cfg.kind) {
+    case FilterMovingAverage:
+    case FilterMedian:
+        return (cfg.length - 1) / 2;
+    case FilterDecimatingFir:
+        return (int(taps.size()) - 1) / 2;
+    default:
+        return 0;
+    }
+}
+
+void LoopFilter::reset()
+{
+    count = 0;
+    restarted = true;
+}
+
+// Fill the state as if x had been the input forever. Kernels work on
+// in - x, so the IIR state and the windows start at zero.
+void LoopFilter::prime(double x)
+{
+    bias = x;
+    ring.fill(0.0, cfg.length);
+    sorted.fill(0.0, cfg.length);
+    ringPos = 0;
+    ringSum = 0.0;
+    s1 = s2 = 0.0;
+    history.fill(0.0f, qMax(0, int(taps.size()) - 1));
+}
+
+// Replace out by in in the sorted window and return its median
+double LoopFilter::median(double in, double out)
+{
+    sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), out));
+    sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), in), in);
+    const int len = int(sorted.size());
+    return len % 2 ? sorted[len / 2] : (sorted[len / 2 - 1] + sorted[len / 2]) / 2.0;
+}
+
+int LoopFilter::process(const double *in, int n, double *out, int *source)
+{
+    if (n <= 0)
+        return 0;
+    if (count == 0)
+        prime(in[0]);
+    const int d = delay();
+    int m = 0;
+
+    switch (cfg.kind) {
+    case FilterOff:
+        for (int i = 0; i < n; ++i) {
+            out[i] = in[i];
+            source[i] = i;
+        }
+        m = n;
+        break;
+    case FilterMovingAverage: {
+        const int len = int(ring.size());
+        for (int i = 0; i < n; ++i) {
+            const double x = in[i] - bias;
+            ringSum += x - ring[ringPos];
+            ring[ringPos] = x;
+            if (++ringPos == len) {
+                // Resum once per window so rounding cannot accumulate
+                ringPos = 0;
+                ringSum = std::accumulate(ring.cbegin(), ring.cend(), 0.0);
+            }
+            if (count + i >= d) {
+                out[m] = bias + ringSum / len;
+                source[m++] = i - d;
+            }
+        }
+        break;
+    }
+    case FilterMedian: {
+        const int len = int(ring.size());
+        for (int i = 0; i < n; ++i) {
+            const double x = in[i] - bias;
+            const double med = median(x, ring[ringPos]);
+            ring[ringPos] = x;
+            ringPos = (ringPos + 1) % len;
+            if (count + i >= d) {
+                out[m] = bias + med;
+                source[m++] = i - d;
+            }
+        }
+        break;
+    }
+    case FilterLowPass:
+    case FilterNotch:
+        for (int i = 0; i < n; ++i) {
+            const double x = in[i] - bias;
+            const double y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            out[m] = bias + y;
+            source[m++] = i;
+        }
+        break;
+    case FilterDecimatingFir: {
+        // The block after the inputs still needed from the last one, as
+        // floats relative to the bias so the SIMD dot product keeps the
+        // resolution of the small variations
+        const int taken = int(history.size());
+        buffer.resize(taken + n);
+        std::copy(history.cbegin(), history.cend(), buffer.begin());
+        for (int i = 0; i < n; ++i)
+            buffer[taken + i] = float(in[i] - bias);
+        for (int i = 0; i < n; ++i) {
+            const qint64 g = count + i;
+            if (g < d || (g - d) % cfg.decimation != 0)
+                continue;
+            out[m] = bias + SimdKernels::dot(buffer.constData() + i, taps.constData(), int(taps.size()));
+            source[m++] = i - d;
+        }
+        std::copy(buffer.cend() - taken, buffer.cend(), history.begin());
+        break;
+    }
+    case FilterKindCount:
+        break;
+    }
+    count += n;
+    return m;
+}
+
+void LoopFilter::run(const LoopTrace &raw, int first, LoopTrace &filtered)
+{
+    if (!isActive())
+        return;
+    const int chunk = 65536;
+    const QVector<int> &breaks = raw.breaks();
+    QVector<double> in;
+    QVector<double> out;
+    QVector<int> source;
+    int i = qMax(0, first);
+    while (i < raw.size()) {
+        if (i > 0 && raw.gapBefore(i))
+            reset();
+        // Up to the next gap, in chunks
+        auto next = std::upper_bound(breaks.cbegin(), breaks.cend(), i);
+        const int end = qMin(next == breaks.cend() ? raw.size() : *next, i + chunk);
+        raw.read(i, end, in);
+        out.resize(in.size());
+        source.resize(in.size());
+        const int m = process(in.constData(), int(in.size()), out.data(), source.data());
+        for (int k = 0; k < m; ++k) {
+            const int s = i + source[k];
+            filtered.append(out[k], raw.time(s), restarted, raw.events().flagsAt(s));
+            restarted = false;
+        }
+        i = end;
+    }
+}
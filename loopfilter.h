@@ -0,0 +1,86 @@
+// loopfilter.h
+#ifndef LOOPFILTER_H
+#define LOOPFILTER_H
+
+#include <QString>
+#include <QVector>
+
+class LoopTrace;
+
+enum FilterKind {
+    FilterOff,
+    FilterMovingAverage,
+    FilterMedian,
+    FilterLowPass,      // 2nd order IIR (biquad)
+    FilterNotch,        // 2nd order IIR (biquad)
+    FilterDecimatingFir,
+    FilterKindCount
+};
+
+QString filterKindName(int kind);
+
+struct FilterSettings {
+    FilterKind kind = FilterOff;
+    int    length = 5;          // moving average / median window, FIR taps
+    double cutoffHz = 1.0;      // low-pass corner
+    double notchHz = 1.0;       // notch centre
+    double q = 0.707;           // low-pass / notch quality factor
+    int    decimation = 4;      // FIR: one output per this many inputs
+    double sampleRateHz = 10.0; // nominal rate of the samples
+};
+
+// Streaming filter for one loop's frequency samples. Blocks of any size
+// can be fed in; the live path passes one sample per frame, the batch path
+// a whole capture in chunks, and both give the same output.
+//
+// Windowed filters are compensated for their group delay: an output is
+// attributed to the input at the centre of its window, so raw and
+// filtered traces line up. The first input after reset() primes the
+// state as if the signal had been constant before it, so there is no
+// start-up transient.
+class LoopFilter {
+public:
+    explicit LoopFilter(const FilterSettings &settings = FilterSettings());
+
+    void setSettings(const FilterSettings &settings);    // also resets
+    const FilterSettings &settings() const { return cfg; }
+    bool isActive() const { return cfg.kind != FilterOff; }
+    int delay() const;          // group delay in input samples
+
+    void reset();
+
+    // Filter in[0, n). Returns the number of outputs; out[k] belongs to
+    // input source[k], relative to in (negative: an earlier block). out
+    // and source must hold n entries.
+    int process(const double *in, int n, double *out, int *source);
+
+    // Filter samples [first, raw.size()) of raw into filtered, continuing
+    // from the previous call. Every gap in raw restarts the filter.
+    void run(const LoopTrace &raw, int first, LoopTrace &filtered);
+
+private:
+    void prime(double x);
+    double median(double in, double out);
+
+    FilterSettings cfg;
+    qint64 count = 0;           // inputs since reset
+    bool   restarted = true;    // next output starts a new segment
+    double bias = 0.0;          // first input; kernels see in - bias
+
+    // Moving average and median: ring of the last length inputs
+    QVector<double> ring;
+    QVector<double> sorted;
+    int    ringPos = 0;
+    double ringSum = 0.0;
+
+    // Biquad, transposed direct form II
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    double s1 = 0.0, s2 = 0.0;
+
+    // Decimating FIR: windowed-sinc taps and the inputs still needed
+    QVector<float> taps;
+    QVector<float> history;
+    QVector<float> buffer;
+};
+
+#endif // LOOPFILTER_H
@@ -0,0 +1,129 @@
+// looptrace.cpp
+#include "looptrace.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+void LoopTrace::clear()
+{
+    store.clear();
+    breakList.clear();
+    eventIndex.clear();
+    originUs = -1;
+    ++clearCount;
+}
+
+void LoopTrace::append(double value, double timeS, bool gapBefore, quint8 eventFlags)
+{
+    if (gapBefore && !store.isEmpty())
+        breakList.append(store.size());
+    eventIndex.addSample(store.size(), timeS, eventFlags);
+    store.append(qRound64(timeS * 1e6), value);
+}
+
+void LoopTrace::restore(SampleStore &&samples, const QVector<int> &breaks,
+                        const QVector<DetectionEvent> &events)
+{
+    clear();
+    store = std::move(samples);
+    breakList = breaks;
+    eventIndex.restore(events, store.size());
+}
+
+double LoopTrace::lastX(bool timeAxis) const
+{
+    if (store.isEmpty())
+        return 0.0;
+    return timeAxis ? store.lastTimeUs() / 1e6 : double(store.size());
+}
+
+bool LoopTrace::gapBefore(int i) const
+{
+    return std::binary_search(breakList.cbegin(), breakList.cend(), i);
+}
+
+int LoopTrace::nearest(double x, bool timeAxis) const
+{
+    if (store.isEmpty())
+        return -1;
+    if (!timeAxis)
+        return qBound(0, int(std::lround(x)), store.size() - 1);
+    // Binary search on the timestamps, then the closer neighbour
+    const int i = store.lowerBoundTime(qint64(std::llround(x * 1e6)));
+    if (i <= 0)
+        return 0;
+    if (i >= store.size())
+        return store.size() - 1;
+    return time(i) - x < x - time(i - 1) ? i : i - 1;
+}
+
+void LoopTrace::visibleRange(double minX, double maxX, bool timeAxis, int &first, int &last) const
+{
+    if (timeAxis) {
+        first = store.lowerBoundTime(qint64(std::ceil(minX * 1e6)));
+        last = store.upperBoundTime(qint64(std::floor(maxX * 1e6)));
+    } else {
+        first = qBound(0, int(std::ceil(minX)), store.size());
+        last = qBound(0, int(std::floor(maxX)) + 1, store.size());
+    }
+    if (last < first)
+        last = first;
+}
+
+QVector<QVector<QPointF>> LoopTrace::points(int first, int last, bool timeAxis, int maxPoints) const
+{
+    QVector<QVector<QPointF>> runs;
+    first = qMax(0, first);
+    last = qMin(store.size(), last);
+    if (last <= first)
+        return runs;
+    runs.append(QVector<QPointF>());
+
+    // A break at 'first' itself does not split anything
+    auto nextBreak = std::upper_bound(breakList.cbegin(), breakList.cend(), first);
+    const int count = last - first;
+
+    if (count <= maxPoints) {
+        QVector<qint64> times;
+        QVector<double> values;
+        store.read(first, last, timeAxis ? &times : nullptr, &values);
+        runs.last().reserve(count);
+        for (int k = 0; k < count; ++k) {
+            const int i = first + k;
+            if (nextBreak != breakList.cend() && *nextBreak == i) {
+                runs.append(QVector<QPointF>());
+                ++nextBreak;
+            }
+            runs.last().append({ timeAxis ? times[k] / 1e6 : double(i), values[k] });
+        }
+        return runs;
+    }
+
+    // More samples than pixels: keep the extremes of each bucket
+    const int buckets = qMax(1, maxPoints / 2);
+    for (int b = 0; b < buckets; ++b) {
+        const int from = first + int(qint64(count) * b / buckets);
+        const int to = first + int(qint64(count) * (b + 1) / buckets);
+        if (to <= from)
+            continue;
+        if (nextBreak != breakList.cend() && *nextBreak < to) {
+            if (!runs.last().isEmpty())
+                runs.append(QVector<QPointF>());
+            while (nextBreak != breakList.cend() && *nextBreak < to)
+                ++nextBreak;
+        }
+        double min, max, sum;
+        store.summarize(from, to, min, max, sum);
+        const double xv = x(from, timeAxis);
+        runs.last().append({ xv, min });
+        runs.last().append({ xv, max });
+    }
+    return runs;
+}
+
+double LoopTrace::hostSeconds(qint64 hostUs)
+{
+    if (originUs < 0)
+        originUs = hostUs - (store.isEmpty() ? 0 : store.lastTimeUs());
+    return (hostUs - originUs) / 1e6;
+}
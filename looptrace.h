@@ -0,0 +1,75 @@
+// looptrace.h
+#ifndef LOOPTRACE_H
+#define LOOPTRACE_H
+
+#include <QVector>
+#include <QPointF>
+
+#include "samplestore.h"
+#include "eventindex.h"
+
+// Recorded samples of one loop: frequency, host time, the positions of
+// gaps where frames were lost and the detection/error intervals. The
+// sample index is implicit; samples live in a compressed SampleStore.
+class LoopTrace {
+public:
+    void clear();
+    void append(double value, double timeS, bool gapBefore = false, quint8 eventFlags = 0);
+
+    int size() const { return store.size(); }
+    bool isEmpty() const { return store.isEmpty(); }
+    double value(int i) const { return store.value(i); }
+    double time(int i) const { return store.timeUs(i) / 1e6; }
+    double x(int i, bool timeAxis) const { return timeAxis ? time(i) : double(i); }
+    double lastX(bool timeAxis) const;
+
+    // Sorted indices of samples that start a new gap-free segment
+    const QVector<int> &breaks() const { return breakList; }
+    bool gapBefore(int i) const;
+
+    // Decode the values of samples [first, last)
+    void read(int first, int last, QVector<double> &values) const
+    {
+        store.read(first, last, nullptr, &values);
+    }
+
+    const EventIndex &events() const { return eventIndex; }
+
+    // Sample whose x is closest to the given one, -1 when empty
+    int nearest(double x, bool timeAxis) const;
+
+    // Samples with x in [minX, maxX] are [first, last)
+    void visibleRange(double minX, double maxX, bool timeAxis, int &first, int &last) const;
+
+    // Samples [first, last) as chart points, one list per gap-free run.
+    // Ranges longer than maxPoints are reduced to a min/max pair per bucket.
+    QVector<QVector<QPointF>> points(int first, int last, bool timeAxis, int maxPoints) const;
+
+    void summarize(int first, int last, double &min, double &max, double &sum) const
+    {
+        store.summarize(first, last, min, max, sum);
+    }
+    qint64 memoryBytes() const { return store.memoryBytes(); }
+
+    // Snapshot support: the generation changes on every clear(), so a
+    // snapshot can tell an appended trace from a replaced one
+    const SampleStore &samples() const { return store; }
+    int generation() const { return clearCount; }
+    void restore(SampleStore &&samples, const QVector<int> &breaks,
+                 const QVector<DetectionEvent> &events);
+
+    // Seconds since the first live sample; appending to a loaded capture
+    // continues after its last timestamp
+    double hostSeconds(qint64 hostUs);
+    // Host time of time 0, -1 before the first live sample
+    qint64 hostOriginUs() const { return originUs; }
+
+private:
+    SampleStore  store;
+    QVector<int> breakList;
+    EventIndex   eventIndex;
+    qint64       originUs = -1;
+    int          clearCount = 0;
+};
+
+#endif // LOOPTRACE_H
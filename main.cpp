@@ -1,6 +1,10 @@
 #include "mainwindow.h"
+#ifdef LOOP_SOAK
+#include "soaktest.h"
+#endif
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
@@ -8,7 +12,40 @@ int main(int argc, char *argv[])
 
     a.setWindowIcon(QIcon(":/icons/loop_detector_favicon.ico"));
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption freshOpt("fresh", "Start with an empty session instead of restoring the last one.");
+    parser.addOption(freshOpt);
+#ifdef LOOP_SOAK
+    QCommandLineOption soakOpt("soak", "Run a soak test against a synthetic device, then exit.");
+    QCommandLineOption minutesOpt("soak-minutes", "Soak test duration (default 60).", "minutes", "60");
+    QCommandLineOption rateOpt("soak-rate", "Synthetic frames per second (default 100).", "fps", "100");
+    QCommandLineOption asciiOpt("soak-ascii", "Send LIVE: lines instead of binary frames.");
+    QCommandLineOption reportOpt("soak-report", "CSV file for the soak samples.", "file");
+    parser.addOptions({soakOpt, minutesOpt, rateOpt, asciiOpt, reportOpt});
+#endif
+    parser.process(a);
+
     MainWindow w;
+#ifdef LOOP_SOAK
+    // A soak run must not replace the user's session
+    if (!parser.isSet(soakOpt))
+        w.restoreSession(!parser.isSet(freshOpt));
+#else
+    w.restoreSession(!parser.isSet(freshOpt));
+#endif
     w.show();
+
+#ifdef LOOP_SOAK
+    if (parser.isSet(soakOpt)) {
+        SoakOptions options;
+        options.minutes = qMax(1, parser.value(minutesOpt).toInt());
+        options.frameRate = qMax(1.0, parser.value(rateOpt).toDouble());
+        options.binary = !parser.isSet(asciiOpt);
+        options.reportFile = parser.value(reportOpt);
+        auto *soak = new SoakTest(&w, options, &w);
+        soak->start();
+    }
+#endif
     return a.exec();
 }
@@ -1,15 +1,16 @@
 // mainwindow.cpp
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include <QtConcurrent>
 
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow),
-    serialPort(new QSerialPort(this)), portGroup(new QActionGroup(this)),
+    serialPort(new JournalingSerialPort(this)), portGroup(new QActionGroup(this)),
     connectionLabel(new QLabel(this)), chart1(new QChart()),
-    series1(new QLineSeries(this)), axisX1(new QValueAxis()),
+    axisX1(new QValueAxis()),
     axisY1(new QValueAxis()), sampleCount1(0), chart2(new QChart()),
-    series2(new QLineSeries(this)), axisX2(new QValueAxis()),
+    axisX2(new QValueAxis()),
     axisY2(new QValueAxis()), sampleCount2(0),isPanning(false) {
     ui->setupUi(this);
 
@@ -21,6 +22,12 @@ MainWindow::MainWindow(QWidget *parent)
     liveDataLabel->setText(tr("LIVE: OFF"));
     statusBar()->addWidget(liveDataLabel);
 
+    timingLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(timingLabel);
+    timingTimer = new QTimer(this);
+    timingTimer->setInterval(500);
+    connect(timingTimer, &QTimer::timeout, this, &MainWindow::updateTimingLabel);
+
     // Create and configure live polling timer
     liveTimer = new QTimer(this);
     liveTimer->setInterval(100);
@@ -42,63 +49,171 @@ MainWindow::MainWindow(QWidget *parent)
     portGroup->setExclusive(true);
     connectAction->setEnabled(false);
     disconnectAction->setEnabled(false);
+
+    // Baud rate, also used by the port probes
+    auto *baudMenu = new QMenu(tr("Baud Rate"), this);
+    ui->actionBAUD_RATE->setMenu(baudMenu);
+    baudGroup = new QActionGroup(this);
+    baudGroup->setExclusive(true);
+    for (qint32 baud : {115200, 230400, 460800, 921600, 1000000, 2000000}) {
+        QAction *act = baudMenu->addAction(QString::number(baud));
+        act->setCheckable(true);
+        act->setData(baud);
+        act->setChecked(baud == baudRate);
+        baudGroup->addAction(act);
+    }
+
+    // LIVE poll interval: the firmware answers every "live" with one frame
+    auto *pollMenu = new QMenu(tr("Poll Rate"), this);
+    ui->actionPOLL_RATE->setMenu(pollMenu);
+    pollGroup = new QActionGroup(this);
+    pollGroup->setExclusive(true);
+    for (int ms : {100, 50, 20, 10}) {
+        QAction *act = pollMenu->addAction(tr("%1 Hz (%2 ms)").arg(1000 / ms).arg(ms));
+        act->setCheckable(true);
+        act->setData(ms);
+        act->setChecked(ms == liveTimer->interval());
+        pollGroup->addAction(act);
+    }
     connectActions();
     statusBar()->addPermanentWidget(connectionLabel);
 
+    // Raw serial journal: every chunk in and out, written by a background thread
+    journal = new SerialJournal(this);
+    serialPort->setWriteHook([this](const char *data, qint64 size) {
+        journal->record(SerialJournal::Outbound, frameClock.nsecsElapsed() / 1000, data, size);
+    });
+    replay = new JournalReplay(this);
+    connect(replay, &JournalReplay::chunkReady, this, &MainWindow::processIncoming);
+    connect(replay, &JournalReplay::finished, this, &MainWindow::onReplayFinished);
+    replaySpeedGroup = new QActionGroup(this);
+    replaySpeedGroup->setExclusive(true);
+    ui->actionREPLAY_1X->setData(1.0);
+    ui->actionREPLAY_10X->setData(10.0);
+    ui->actionREPLAY_100X->setData(100.0);
+    ui->actionREPLAY_MAX->setData(0.0);     // as fast as possible
+    for (QAction *act : {ui->actionREPLAY_1X, ui->actionREPLAY_10X,
+                         ui->actionREPLAY_100X, ui->actionREPLAY_MAX})
+        replaySpeedGroup->addAction(act);
+    ui->actionREPLAY_1X->setChecked(true);
+    ui->actionSTOP_REPLAY->setEnabled(false);
+
+    frameServer = new FrameServer(this);
+    messageBus = new MessageBus(this);
+    metricsServer = new MetricsServer(&frameTiming, &frameDecoder, messageBus, this);
+    // The window only takes frames and malformed lines; dialogs subscribe
+    // to their own topics when opened
+    messageBus->subscribe(TopicLiveFrame, this, [this](const BusMessagePtr &message) {
+        binaryLive = message->binary;
+        handleLiveFrame(message->frame);
+    });
+    messageBus->subscribe(TopicUnknown, this, [this](const BusMessagePtr &message) {
+        if (!message->malformed)
+            return;
+        ++metricsServer->metrics().parseErrors;
+        qDebug() << "LIVE format error:" << message->line;
+    });
+
+    // Frequency waterfall, hidden until chosen from the LIVE menu
+    waterfallDock = new WaterfallDock(this);
+    addDockWidget(Qt::BottomDockWidgetArea, waterfallDock);
+    waterfallDock->hide();
+    waterfallDock->toggleViewAction()->setText(tr("WATERFALL"));
+    ui->menuLIVE->addAction(waterfallDock->toggleViewAction());
+
+    // Every LIVE field at a throttled refresh rate
+    telemetryDock = new TelemetryDock(this);
+    addDockWidget(Qt::RightDockWidgetArea, telemetryDock);
+    telemetryDock->toggleViewAction()->setText(tr("TELEMETRY"));
+    ui->menuLIVE->addAction(telemetryDock->toggleViewAction());
+
+    calibrationMonitor = new CalibrationMonitor(this);
+    connect(calibrationMonitor, &CalibrationMonitor::loopFinished, this, [this](int loop) {
+        const CalibrationResult &r = calibrationMonitor->result(loop);
+        if (r.state == CalConverged)
+            statusBar()->showMessage(tr("Loop %1 calibrated in %2 s, baseline %3")
+                                         .arg(loop).arg(r.convergeS, 0, 'f', 1)
+                                         .arg(r.baseline, 0, 'f', 1), 10000);
+        else
+            statusBar()->showMessage(tr("Loop %1 did not settle: %2").arg(loop).arg(r.note), 10000);
+    });
+
+    triggerEngine = new TriggerEngine(this);
+    connect(triggerEngine, &TriggerEngine::captureSaved, this, [this](const QString &fn, bool ok) {
+        statusBar()->showMessage(ok ? tr("Trigger capture saved: %1").arg(fn)
+                                    : tr("Failed to write trigger capture: %1").arg(fn), 5000);
+    });
+    connect(frameServer, &FrameServer::clientsChanged, this, [this](int count) {
+        statusBar()->showMessage(tr("Frame server: %n client(s)", nullptr, count), 3000);
+    });
+
+    // Port discovery and probing run off the GUI thread
+    scannerThread = new QThread(this);
+    portScanner = new PortScanner;
+    portScanner->moveToThread(scannerThread);
+    connect(scannerThread, &QThread::started, portScanner, &PortScanner::start);
+    connect(scannerThread, &QThread::finished, portScanner, &QObject::deleteLater);
+    connect(portScanner, &PortScanner::portsChanged, this, &MainWindow::onPortsChanged);
+
     // Chart 1
+    // (line segments are created by resetLoop1)
     chartView1 = ui->chartViewLoop1;
-    chart1->addSeries(series1);
     chart1->legend()->hide();
     axisX1->setTitleText("Sample Count");
     axisX1->setRange(0, windowSize);
     axisX1->setLabelFormat("%d");
     chart1->addAxis(axisX1, Qt::AlignBottom);
-    series1->attachAxis(axisX1);
     axisY1->setTitleText("Frequency (Hz)");
     axisY1->setRange(-1, 1);
     chart1->addAxis(axisY1, Qt::AlignLeft);
-    series1->attachAxis(axisY1);
     chartView1->setChart(chart1);
     chartView1->setRenderHint(QPainter::Antialiasing);
-    series1->setPen(QPen(Qt::red, 2));
-    chartView1->setRenderHint(QPainter::Antialiasing);
     chartView1->setRubberBand(QChartView::NoRubberBand);
 
     // Chart 2
     chartView2 = ui->chartViewLoop2;
-    chart2->addSeries(series2);
     chart2->legend()->hide();
     axisX2->setTitleText("Sample Count");
     axisX2->setRange(0, windowSize);
     axisX2->setLabelFormat("%d");
     chart2->addAxis(axisX2, Qt::AlignBottom);
-    series2->attachAxis(axisX2);
     axisY2->setTitleText("Frequency (Hz)");
     axisY2->setRange(-1, 1);
     chart2->addAxis(axisY2, Qt::AlignLeft);
-    series2->attachAxis(axisY2);
     chartView2->setChart(chart2);
     chartView2->setRenderHint(QPainter::Antialiasing);
-    series2->setPen(QPen(Qt::blue, 2));
-    chartView2->setRenderHint(QPainter::Antialiasing);
     chartView2->setRubberBand(QChartView::NoRubberBand);
 
     chartView1->installEventFilter(this);
     chartView2->installEventFilter(this);
+    chartView1->setMouseTracking(true);
+    chartView2->setMouseTracking(true);
+    cursor1 = new ChartCursor(chart1, &trace1, axisX1, axisY1);
+    cursor2 = new ChartCursor(chart2, &trace2, axisX2, axisY2);
 
     scrollBar1 = new QScrollBar(Qt::Horizontal, this);
     scrollBar2 = new QScrollBar(Qt::Horizontal, this);
     ui->verticalLayoutCharts->insertWidget(1, scrollBar1);
     ui->verticalLayoutCharts->insertWidget(3, scrollBar2);
     connect(scrollBar1, &QScrollBar::valueChanged, this, [this](int v){
-        axisX1->setRange(v, v + windowSize);
-        autoscaleYVisible(series1, axisX1, axisY1);
+        setVisibleWindow(trace1, axisX1, v);
+        setEventCursor(trace1, v + windowSize / 2);
     });
     connect(scrollBar2, &QScrollBar::valueChanged, this, [this](int v){
-        axisX2->setRange(v, v + windowSize);
-        autoscaleYVisible(series2, axisX2, axisY2);
+        setVisibleWindow(trace2, axisX2, v);
+        setEventCursor(trace2, v + windowSize / 2);
     });
 
+    // The series only hold what is visible, so redraw whenever X moves
+    renderTimer = new QTimer(this);
+    renderTimer->setSingleShot(true);
+    renderTimer->setInterval(0);
+    connect(renderTimer, &QTimer::timeout, this, &MainWindow::renderCharts);
+    connect(axisX1, &QValueAxis::rangeChanged, this, &MainWindow::scheduleRender);
+    connect(axisX2, &QValueAxis::rangeChanged, this, &MainWindow::scheduleRender);
+    connect(chart1, &QChart::plotAreaChanged, this, &MainWindow::scheduleRender);
+    connect(chart2, &QChart::plotAreaChanged, this, &MainWindow::scheduleRender);
+
     ui->actionRESET_MCU->setEnabled(false);
     ui->actionLED_TEST->setEnabled(false);
     ui->actionFORMAT_EEPROM->setEnabled(false);
@@ -115,49 +230,154 @@ MainWindow::MainWindow(QWidget *parent)
     resetLoop1();
     resetLoop2();
 
-    on_actionREFRESH_triggered();
+    frameClock.start();
+    clockEpochUs = QDateTime::currentMSecsSinceEpoch() * 1000;
+
+    statusBar()->showMessage(tr("Scanning serial ports..."), 2000);
+    scannerThread->start();
 }
 
-MainWindow::~MainWindow() { delete ui; }
+MainWindow::~MainWindow()
+{
+    saveSession();
+    scannerThread->quit();
+    scannerThread->wait();
+    delete cursor1;
+    delete cursor2;
+    delete ui;
+}
 
 void MainWindow::connectActions() {
     connect(portGroup, &QActionGroup::triggered, this,
             &MainWindow::onPortSelected);
+    connect(baudGroup, &QActionGroup::triggered, this,
+            &MainWindow::onBaudSelected);
+    connect(pollGroup, &QActionGroup::triggered, this,
+            &MainWindow::onPollRateSelected);
     connect(serialPort, &QSerialPort::readyRead,
             this, &MainWindow::onSerialReadyRead);
+    connect(serialPort, &QSerialPort::errorOccurred,
+            this, &MainWindow::onSerialError);
 }
 
 void MainWindow::on_actionREFRESH_triggered() {
+    // Results arrive asynchronously through onPortsChanged
+    statusBar()->showMessage(tr("Scanning serial ports..."), 2000);
+    QMetaObject::invokeMethod(portScanner, "rescan", Qt::QueuedConnection);
+}
+void MainWindow::onPortsChanged(const QList<PortCandidate> &ports)
+{
+    QString selected = portGroup->checkedAction()
+                           ? portGroup->checkedAction()->data().toString() : sessionPort;
     for (auto *act : portGroup->actions()) {
         portMenu->removeAction(act);
         portGroup->removeAction(act);
         delete act;
     }
-    for (auto &info : QSerialPortInfo::availablePorts()) {
-        QAction *act = new QAction(
-            QString("%1 (%2)").arg(info.portName(), info.description().isEmpty()
-                                                        ? info.systemLocation()
-                                                                                 : info.description()),
-            this);
+    QStringList detectors;
+    bool lostPortBack = false;
+    for (const PortCandidate &info : ports) {
+        QAction *act = new QAction(QString("%1 (%2)").arg(info.portName, info.description), this);
+        if (info.isDetector) {
+            act->setText(act->text() + tr("  [DETECTOR]"));
+            QFont font = act->font();
+            font.setBold(true);
+            act->setFont(font);
+            detectors << info.portName;
+        }
         act->setCheckable(true);
-        act->setData(info.portName());
+        act->setData(info.portName);
+        act->setChecked(info.portName == selected);
         portGroup->addAction(act);
         portMenu->addAction(act);
+        if (info.portName == reconnectPort)
+            lostPortBack = true;
+    }
+    connectAction->setEnabled(!serialPort->isOpen() && portGroup->checkedAction() != nullptr);
+
+    if (serialPort->isOpen() || !ui->actionAUTO_CONNECT->isChecked())
+        return;
+
+    // Reopen a port that dropped out, or pick the only detector at startup
+    QString target;
+    if (!reconnectPort.isEmpty()) {
+        if (lostPortBack)
+            target = reconnectPort;
+    } else if (!autoConnectDone && detectors.size() == 1) {
+        target = detectors.first();
+    }
+    autoConnectDone = true;
+    if (target.isEmpty())
+        return;
+
+    for (auto *act : portGroup->actions())
+        act->setChecked(act->data().toString() == target);
+    bool live = resumeLive;
+    if (connectToPort(target)) {
+        if (live)
+            on_actionLIVE_ON_triggered();
+    } else if (!reconnectPort.isEmpty()) {
+        // Device may still be booting; look again shortly
+        QTimer::singleShot(1000, this, &MainWindow::on_actionREFRESH_triggered);
+    }
+}
+void MainWindow::onSerialError(QSerialPort::SerialPortError error)
+{
+    // USB unplugged or device reset: drop the connection and wait for it
+    if (error != QSerialPort::ResourceError || !serialPort->isOpen())
+        return;
+    QString portName = serialPort->portName();
+    bool wasLive = liveTimer->isActive();
+    on_actionDISCONNECT_triggered();
+    if (ui->actionAUTO_CONNECT->isChecked()) {
+        reconnectPort = portName;
+        resumeLive = wasLive;
+        statusBar()->showMessage(tr("Connection to %1 lost, waiting for it to return...")
+                                     .arg(portName), 0);
+    } else {
+        statusBar()->showMessage(tr("Connection to %1 lost.").arg(portName), 5000);
     }
-    connectAction->setEnabled(false);
 }
 void MainWindow::onPortSelected(QAction *action) {
     action->setChecked(true);
     connectAction->setEnabled(true);
 }
+void MainWindow::onBaudSelected(QAction *action)
+{
+    baudRate = action->data().toInt();
+    QMetaObject::invokeMethod(portScanner, "setBaudRate", Qt::QueuedConnection,
+                              Q_ARG(qint32, baudRate));
+    if (serialPort->isOpen() && !serialPort->setBaudRate(baudRate))
+        statusBar()->showMessage(tr("Failed to set %1 baud").arg(baudRate), 5000);
+}
+void MainWindow::onPollRateSelected(QAction *action)
+{
+    // Takes effect at once; lateness and gaps are judged by the new interval
+    liveTimer->setInterval(action->data().toInt());
+    frameTiming.setNominalInterval(qint64(liveTimer->interval()) * 1000);
+}
 void MainWindow::on_actionCONNECT_triggered()
 {
     QAction *sel = portGroup->checkedAction();
     if (!sel) { statusBar()->showMessage(tr("No port selected!"),0); return; }
-    serialPort->setPort(QSerialPortInfo(sel->data().toString()));
-    serialPort->setBaudRate(921600);
+    connectToPort(sel->data().toString());
+}
+bool MainWindow::connectToPort(const QString &portName)
+{
+    if (replay->isRunning()) {
+        statusBar()->showMessage(tr("Cannot connect while replaying."), 5000);
+        return false;
+    }
+    serialPort->setPort(QSerialPortInfo(portName));
+    serialPort->setBaudRate(baudRate);
     if (serialPort->open(QIODevice::ReadWrite)) {
-        connectionLabel->setText(tr("Connected: %1").arg(sel->data().toString()));
+        metricsServer->setDevice(portName);
+        reconnectPort.clear();
+        resumeLive = false;
+        QMetaObject::invokeMethod(portScanner, "setExcludedPort", Qt::QueuedConnection,
+                                  Q_ARG(QString, portName));
+        connectionLabel->setText(tr("Connected: %1").arg(portName));
+        statusBar()->clearMessage();
         refreshAction->setEnabled(false);
         connectAction->setEnabled(false);
         disconnectAction->setEnabled(true);
@@ -177,19 +397,25 @@ void MainWindow::on_actionCONNECT_triggered()
 
         ui->actionEEPROM->setEnabled(true);
         ui->actionOPEN_PARAMETERS->setEnabled(true);
+        return true;
     }
     else {
         // Restore portName if we overwrote it above:
         connectionLabel->setText(tr(""));
         statusBar()->showMessage(
-            tr("Failed to connect to %1").arg(sel->data().toString()),
+            tr("Failed to connect to %1").arg(portName),
             5000  // stay visible for 5s
             );
+        return false;
     }
 }
 void MainWindow::on_actionDISCONNECT_triggered()
 {
     if (serialPort->isOpen()) serialPort->close();
+    reconnectPort.clear();
+    resumeLive = false;
+    QMetaObject::invokeMethod(portScanner, "setExcludedPort", Qt::QueuedConnection,
+                              Q_ARG(QString, QString()));
     connectionLabel->clear();
     refreshAction->setEnabled(true);
     disconnectAction->setEnabled(false);
@@ -200,6 +426,7 @@ void MainWindow::on_actionDISCONNECT_triggered()
 
     if (liveTimer->isActive()) {
         liveTimer->stop();
+        timingTimer->stop();
         autoScroll = false;   // also turn off auto‐scroll
     }
     liveDataLabel->setText(tr("Live: OFF"));
@@ -217,10 +444,11 @@ void MainWindow::on_actionDISCONNECT_triggered()
     ui->btnCAL2->setEnabled(false);
 }
 
-void MainWindow::addLoop1Data(double frequency)
+void MainWindow::addLoop1Data(double frequency, double timeS, bool gapBefore, quint8 eventFlags)
 {
-    // 1) Append the new point
-    series1->append(sampleCount1, frequency);
+    // 1) Append the new point; a gap starts a new line segment
+    trace1.append(frequency, timeS, gapBefore, eventFlags);
+    filter1.run(trace1, trace1.size() - 1, filtered1);
     ++sampleCount1;
 
     // 2) Recompute how far you can scroll: total_samples – windowSize
@@ -235,13 +463,14 @@ void MainWindow::addLoop1Data(double frequency)
         scrollBar1->setValue(maxScroll);
     }
 
-    autoscaleYVisible(series1, axisX1, axisY1);
+    scheduleRender();
 
 }
-void MainWindow::addLoop2Data(double frequency)
+void MainWindow::addLoop2Data(double frequency, double timeS, bool gapBefore, quint8 eventFlags)
 {
-    // 1) Append your new point
-    series2->append(sampleCount2, frequency);
+    // 1) Append your new point; a gap starts a new line segment
+    trace2.append(frequency, timeS, gapBefore, eventFlags);
+    filter2.run(trace2, trace2.size() - 1, filtered2);
     ++sampleCount2;
 
     // 2) Compute how far you can scroll: total_samples – windowSize
@@ -256,12 +485,18 @@ void MainWindow::addLoop2Data(double frequency)
         scrollBar2->setValue(maxScroll);
     }
 
-    autoscaleYVisible(series2, axisX2, axisY2);
+    scheduleRender();
 }
 void MainWindow::resetLoop1()
 {
     // Clear series and reset sample counter
-    series1->clear();
+    trace1.clear();
+    filtered1.clear();
+    filter1.reset();
+    recountTraffic();
+    cursor1->clear();
+    sourceFile1.clear();
+    scheduleRender();
     sampleCount1 = 0;
 
     // Reset axes: X from 0 to windowSize; Y from 0 to 1
@@ -277,7 +512,13 @@ void MainWindow::resetLoop1()
 void MainWindow::resetLoop2()
 {
     // Clear series and reset sample counter
-    series2->clear();
+    trace2.clear();
+    filtered2.clear();
+    filter2.reset();
+    recountTraffic();
+    cursor2->clear();
+    sourceFile2.clear();
+    scheduleRender();
     sampleCount2 = 0;
 
     // Reset axes: X from 0 to windowSize; Y from 0 to 1
@@ -290,15 +531,272 @@ void MainWindow::resetLoop2()
     scrollBar2->setValue(0);
     scrollBar2->setEnabled(false);
 }
+QLineSeries *MainWindow::addSegment(QChart *chart, QList<QLineSeries*> &segments,
+                                    QValueAxis *axisX, QValueAxis *axisY, const QColor &color)
+{
+    auto *segment = new QLineSeries(this);
+    segment->setPen(QPen(color, 2));
+    chart->addSeries(segment);
+    segment->attachAxis(axisX);
+    segment->attachAxis(axisY);
+    segments.append(segment);
+    return segment;
+}
+void MainWindow::renderLoop(QChart *chart, QList<QLineSeries*> &segments,
+                            const LoopTrace &trace, QValueAxis *axisX,
+                            QValueAxis *axisY, const QColor &color,
+                            QVector<double> &yVals, const LoopTrace *raw)
+{
+    // Only the visible range (plus one sample each side) goes into the
+    // chart, reduced to about two points per pixel. One series per
+    // gap-free run so that gaps are drawn as breaks.
+    const double minX = axisX->min();
+    const double maxX = axisX->max();
+    // A filtered trace numbers its samples differently (delay, decimation);
+    // on the sample axis it is selected by time and each point placed at
+    // the raw sample it belongs to
+    const bool byRawIndex = raw && !timeAxis && !raw->isEmpty();
+    int first, last;
+    if (byRawIndex) {
+        const int lastRaw = raw->size() - 1;
+        trace.visibleRange(raw->time(qBound(0, int(std::ceil(minX)), lastRaw)),
+                           raw->time(qBound(0, int(std::floor(maxX)), lastRaw)), true, first, last);
+    } else {
+        trace.visibleRange(minX, maxX, timeAxis, first, last);
+    }
+    const int maxPoints = qMax(200, int(chart->plotArea().width()) * 2);
+    QVector<QVector<QPointF>> runs =
+        trace.points(first - 1, last + 1, timeAxis || byRawIndex, maxPoints);
+    if (byRawIndex) {
+        for (QVector<QPointF> &run : runs) {
+            for (QPointF &p : run)
+                p.setX(raw->samples().lowerBoundTime(qRound64(p.x() * 1e6)));
+        }
+    }
+
+    while (segments.size() < runs.size())
+        addSegment(chart, segments, axisX, axisY, color);
+
+    for (int s = 0; s < segments.size(); ++s) {
+        if (s < runs.size()) {
+            for (const QPointF &p : runs[s]) {
+                if (p.x() >= minX && p.x() <= maxX)
+                    yVals.append(p.y());
+            }
+            segments[s]->replace(runs[s]);
+        } else if (segments[s]->count() > 0) {
+            segments[s]->clear();
+        }
+    }
+}
+void MainWindow::renderEvents(QChart *chart, QList<QGraphicsRectItem*> &overlays,
+                              const LoopTrace &trace, QValueAxis *axisX)
+{
+    static const QColor colors[EventKindCount] = {
+        QColor(0, 170, 0, 45),      // presence
+        QColor(255, 190, 0, 60),    // calibration
+        QColor(220, 0, 0, 50),      // open loop
+        QColor(150, 0, 170, 50)     // short
+    };
+
+    // Shaded spans of the events in view. Spans of one kind closer than a
+    // pixel are merged, so a zoomed-out capture needs few items.
+    const QRectF area = chart->plotArea();
+    const double minX = axisX->min();
+    const double maxX = axisX->max();
+    QVector<QPair<int, QRectF>> rects;
+    if (ui->actionSHOW_EVENTS->isChecked() && maxX > minX) {
+        int first, last;
+        trace.visibleRange(minX, maxX, timeAxis, first, last);
+        const EventIndex &events = trace.events();
+        const double scale = area.width() / (maxX - minX);
+        for (int i : events.overlapping(first - 1, last + 1)) {
+            const DetectionEvent &e = events.at(i);
+            const int end = events.endSample(i);
+            const double x0 = trace.x(e.firstSample, timeAxis);
+            const double x1 = end < trace.size() ? trace.x(end, timeAxis) : trace.lastX(timeAxis);
+            const double px0 = area.left() + (qMax(x0, minX) - minX) * scale;
+            const double px1 = area.left() + (qMin(x1, maxX) - minX) * scale;
+            if (px1 < px0)
+                continue;
+            if (!rects.isEmpty() && rects.last().first == e.kind
+                && px0 <= rects.last().second.right() + 1.0) {
+                rects.last().second.setRight(qMax(px1, rects.last().second.right()));
+                continue;
+            }
+            rects.append({ e.kind, QRectF(px0, area.top(), qMax(1.0, px1 - px0), area.height()) });
+        }
+    }
+
+    // Items sit below grid and series (z 0) and are hidden, not deleted
+    while (overlays.size() < rects.size()) {
+        auto *item = new QGraphicsRectItem(chart);
+        item->setPen(Qt::NoPen);
+        overlays.append(item);
+    }
+    for (int i = 0; i < overlays.size(); ++i) {
+        if (i < rects.size()) {
+            overlays[i]->setRect(rects[i].second);
+            overlays[i]->setBrush(colors[rects[i].first]);
+            overlays[i]->show();
+        } else {
+            overlays[i]->hide();
+        }
+    }
+}
+void MainWindow::scheduleRender()
+{
+    if (!renderTimer->isActive())
+        renderTimer->start();
+}
+void MainWindow::renderCharts()
+{
+    // An empty trace clears the series of a hidden one
+    static const LoopTrace none;
+    QVector<double> yVals1, yVals2;
+    renderLoop(chart1, segments1, filter1.isActive() && !showRaw ? none : trace1,
+               axisX1, axisY1, Qt::red, yVals1);
+    renderLoop(chart1, filteredSegments1, showFiltered ? filtered1 : none,
+               axisX1, axisY1, QColor(0, 120, 0), yVals1, &trace1);
+    renderLoop(chart2, segments2, filter2.isActive() && !showRaw ? none : trace2,
+               axisX2, axisY2, Qt::blue, yVals2);
+    renderLoop(chart2, filteredSegments2, showFiltered ? filtered2 : none,
+               axisX2, axisY2, QColor(0, 120, 0), yVals2, &trace2);
+    autoscaleYVisible(yVals1, axisY1);
+    autoscaleYVisible(yVals2, axisY2);
+    renderEvents(chart1, overlays1, trace1, axisX1);
+    renderEvents(chart2, overlays2, trace2, axisX2);
+    cursor1->update(timeAxis);
+    cursor2->update(timeAxis);
+}
+QList<QPair<QWidget *, QAction *>> MainWindow::sessionDialogs() const
+{
+    // Dialogs that work without a device, with the action that opens them
+    return {
+        {statisticsDialog, ui->actionSTATISTICS},
+        {eventListDialog, ui->actionEVENT_LIST},
+        {trafficDialog, ui->actionTRAFFIC},
+        {triggerDialog, ui->actionTRIGGERS},
+        {trendDialog, ui->actionTRENDS},
+        {compareDialog, ui->actionCOMPARE_CAPTURES},
+        {calibrationDialog, ui->actionCALIBRATION_MONITOR},
+        {scriptDialog, ui->actionRUN_SCRIPT},
+    };
+}
+void MainWindow::saveSession()
+{
+    if (!sessionTimer)
+        return;
+    SessionState state;
+    if (serialPort->isOpen())
+        state.port = serialPort->portName();
+    else if (portGroup->checkedAction())
+        state.port = portGroup->checkedAction()->data().toString();
+    else
+        state.port = sessionPort;
+    state.baud = baudRate;
+    state.geometry = saveGeometry();
+    state.windowState = saveState();
+    state.timeAxis = timeAxis;
+    for (const auto &d : sessionDialogs()) {
+        if (d.first && d.first->isVisible())
+            state.dialogs << d.second->objectName();
+    }
+    state.loops[0] = {axisX1->min(), axisX1->max(), axisY1->min(), axisY1->max(),
+                      scrollBar1->value(), sourceFile1};
+    state.loops[1] = {axisX2->min(), axisX2->max(), axisY2->min(), axisY2->max(),
+                      scrollBar2->value(), sourceFile2};
+    if (!session.save(state, trace1, trace2))
+        statusBar()->showMessage(tr("Failed to write the session snapshot in %1")
+                                     .arg(session.directory()), 5000);
+}
+void MainWindow::restoreSession(bool restore)
+{
+    sessionTimer = new QTimer(this);
+    sessionTimer->setInterval(5000);
+    connect(sessionTimer, &QTimer::timeout, this, &MainWindow::saveSession);
+    sessionTimer->start();
+    if (!restore) {
+        session.discard();
+        return;
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    SessionState state;
+    if (!session.restore(state, trace1, trace2))
+        return;
+    restoreGeometry(state.geometry);
+    restoreState(state.windowState);
+    sessionPort = state.port;
+    for (QAction *act : baudGroup->actions()) {
+        if (act->data().toInt() == state.baud && !act->isChecked())
+            act->trigger();
+    }
+    ui->actionTIME_AXIS->setChecked(state.timeAxis);
+
+    auto restoreLoop = [&](int loop, const SessionLoop &view, LoopTrace &trace, int &sampleCount,
+                           QString &sourceFile, QScrollBar *scrollBar,
+                           QValueAxis *axisX, QValueAxis *axisY) {
+        // No usable snapshot of the samples: fall back to the capture file
+        if (trace.isEmpty() && !view.sourceFile.isEmpty()
+            && loadLoopCsv(view.sourceFile, loop, trace, liveTimer->interval() / 1000.0) != CaptureOk)
+            return;
+        sourceFile = view.sourceFile;
+        sampleCount = trace.size();
+        scrollBar->setRange(0, qMax(0, sampleCount - windowSize));
+        scrollBar->setValue(view.scroll);
+        scrollBar->setEnabled(sampleCount > windowSize);
+        if (view.maxX > view.minX)
+            axisX->setRange(view.minX, view.maxX);
+        if (view.maxY > view.minY)
+            axisY->setRange(view.minY, view.maxY);
+    };
+    restoreLoop(1, state.loops[0], trace1, sampleCount1, sourceFile1, scrollBar1, axisX1, axisY1);
+    restoreLoop(2, state.loops[1], trace2, sampleCount2, sourceFile2, scrollBar2, axisX2, axisY2);
+    recountTraffic();
+    scheduleRender();
+
+    for (const auto &d : sessionDialogs()) {
+        if (state.dialogs.contains(d.second->objectName()))
+            d.second->trigger();
+    }
+    statusBar()->showMessage(tr("Session restored in %1 ms (%2 + %3 samples)")
+                                 .arg(clock.elapsed())
+                                 .arg(trace1.size())
+                                 .arg(trace2.size()), 5000);
+}
+double MainWindow::windowSpan() const
+{
+    // In time mode the window covers windowSize polls at the nominal rate
+    return timeAxis ? windowSize * liveTimer->interval() / 1000.0 : windowSize;
+}
+void MainWindow::setVisibleWindow(const LoopTrace &trace, QValueAxis *axisX, int first)
+{
+    if (!timeAxis) {
+        axisX->setRange(first, first + windowSize);
+        return;
+    }
+    double start = first < trace.size() ? trace.time(first) : 0.0;
+    double end = start + windowSpan();
+    int last = qMin(first + windowSize, trace.size()) - 1;
+    if (last >= first)
+        end = qMax(end, trace.time(last));
+    axisX->setRange(start, end);
+}
 bool MainWindow::eventFilter(QObject *obj, QEvent *event)
 {
     auto handleChart = [&](QChart *chart,
                            QChartView *view,
-                           QLineSeries *series,
+                           const LoopTrace &trace,
                            QValueAxis *axisX,
                            QValueAxis *axisY,
-                           int &sampleCount) -> bool
+                           ChartCursor *cursor) -> bool
     {
+        auto chartPos = [&](const QMouseEvent *me) {
+            return chart->mapFromScene(view->mapToScene(me->pos()));
+        };
+
         // Helper to clamp axis min ≥ 0 and max ≤ data bounds
         auto clampAxes = [&](){
             // X-axis clamp
@@ -310,14 +808,15 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
                 minX = 0;
                 maxX = span;
             }
-            // Ensure upper bound ≤ total samples
-            if (maxX > sampleCount) {
-                maxX = sampleCount;
-                minX = qMax(0.0, maxX - windowSize);
+            // Ensure upper bound ≤ total samples (or last timestamp)
+            double limitX = trace.lastX(timeAxis);
+            if (maxX > limitX) {
+                maxX = limitX;
+                minX = qMax(0.0, maxX - windowSpan());
             }
             axisX->setRange(minX, maxX);
 
-            autoscaleYVisible(series, axisX, axisY);
+            scheduleRender();
         };
 
         // Mouse wheel: zoom
@@ -354,6 +853,16 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
             return true;
         }
 
+        // Mouse hover: move the crosshair to the nearest sample
+        if (event->type() == QEvent::MouseMove) {
+            cursor->hover(chartPos(static_cast<QMouseEvent*>(event)), timeAxis);
+            return false;
+        }
+        if (event->type() == QEvent::Leave) {
+            cursor->leave();
+            return false;
+        }
+
         // Mouse press: start panning or reset
         if (event->type() == QEvent::MouseButtonPress) {
             auto *me = static_cast<QMouseEvent*>(event);
@@ -365,6 +874,7 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
             if (me->button() == Qt::LeftButton) {
                 isPanning = true;
                 lastMousePos = me->pos();
+                pressMousePos = me->pos();
                 return true;
             }
         }
@@ -374,6 +884,10 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
             auto *me = static_cast<QMouseEvent*>(event);
             if (me->button() == Qt::LeftButton) {
                 isPanning = false;
+                // A click without dragging places a measurement marker
+                if (cursor->measureEnabled()
+                    && (me->pos() - pressMousePos).manhattanLength() < 3)
+                    cursor->placeMarker(chartPos(me), timeAxis);
                 return true;
             }
         }
@@ -382,11 +896,11 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
     };
 
     if (obj == chartView1) {
-        if (handleChart(chart1, chartView1, series1, axisX1, axisY1, sampleCount1))
+        if (handleChart(chart1, chartView1, trace1, axisX1, axisY1, cursor1))
             return true;
     }
     if (obj == chartView2) {
-        if (handleChart(chart2, chartView2, series2, axisX2, axisY2, sampleCount2))
+        if (handleChart(chart2, chartView2, trace2, axisX2, axisY2, cursor2))
             return true;
     }
     return QMainWindow::eventFilter(obj, event);
@@ -400,28 +914,66 @@ void MainWindow::on_actionSAVE_LOOP_1_triggered() {
                                               tr("CSV Files (*.csv)"));
     if (fn.isEmpty())
         return;
-    QFile f(fn);
-    if (!f.open(QIODevice::WriteOnly | QIODevice::Text))
-        return;
-    QTextStream o(&f);
-    o << "#Loop 1\n";
-    for (auto &p : series1->pointsVector())
-        o << p.x() << "," << p.y() << "\n";
+    saveLoopCsv(fn, 1, trace1);
 }
 void MainWindow::on_actionSAVE_LOOP_2_triggered() {
     QString fn = QFileDialog::getSaveFileName(this, tr("Save Loop 2"), QString(),
                                               tr("CSV Files (*.csv)"));
     if (fn.isEmpty())
         return;
-    QFile f(fn);
-    if (!f.open(QIODevice::WriteOnly | QIODevice::Text))
-        return;
-    QTextStream o(&f);
-    o << "#Loop 2\n";
-    for (auto &p : series2->pointsVector())
-        o << p.x() << "," << p.y() << "\n";
+    saveLoopCsv(fn, 2, trace2);
 }
 
+void MainWindow::on_actionFILTERS_triggered()
+{
+    if (!filterDialog) {
+        FilterSettings s1 = filter1.settings();
+        FilterSettings s2 = filter2.settings();
+        s1.sampleRateHz = s2.sampleRateHz = 1000.0 / liveTimer->interval();
+        filterDialog = new FilterDialog(s1, s2, showRaw, showFiltered, this);
+        connect(filterDialog, &FilterDialog::filterChanged, this, &MainWindow::applyFilter);
+        connect(filterDialog, &FilterDialog::displayChanged, this, [this](bool raw, bool filtered) {
+            showRaw = raw;
+            showFiltered = filtered;
+            scheduleRender();
+        });
+        connect(filterDialog, &FilterDialog::saveRequested, this, &MainWindow::saveFiltered);
+    }
+    filterDialog->show();
+    filterDialog->raise();
+}
+void MainWindow::applyFilter(int loop, const FilterSettings &settings)
+{
+    // Rerun the new filter over everything recorded or loaded so far
+    LoopFilter &filter = loop == 1 ? filter1 : filter2;
+    LoopTrace &filtered = loop == 1 ? filtered1 : filtered2;
+    QElapsedTimer clock;
+    clock.start();
+    filter.setSettings(settings);
+    filtered.clear();
+    filter.run(loop == 1 ? trace1 : trace2, 0, filtered);
+    scheduleRender();
+    if (filter.isActive())
+        statusBar()->showMessage(tr("Loop %1: %2, %3 samples filtered in %4 ms")
+                                     .arg(loop)
+                                     .arg(filterKindName(settings.kind))
+                                     .arg((loop == 1 ? trace1 : trace2).size())
+                                     .arg(clock.elapsed()), 5000);
+}
+void MainWindow::saveFiltered(int loop)
+{
+    const LoopTrace &filtered = loop == 1 ? filtered1 : filtered2;
+    if (filtered.isEmpty()) {
+        statusBar()->showMessage(tr("Loop %1 has no filtered samples.").arg(loop), 5000);
+        return;
+    }
+    QString fn = QFileDialog::getSaveFileName(this, tr("Save Filtered Loop %1").arg(loop), QString(),
+                                              tr("CSV Files (*.csv)"));
+    if (fn.isEmpty())
+        return;
+    if (!saveLoopCsv(fn, loop, filtered))
+        statusBar()->showMessage(tr("Failed to write %1").arg(fn), 5000);
+}
 void MainWindow::on_actionLOAD_LOOP1_triggered()
 {
     if (serialPort->isOpen()) {
@@ -433,44 +985,25 @@ void MainWindow::on_actionLOAD_LOOP1_triggered()
         statusBar()->showMessage(tr("Load canceled."), 2000);
         return;
     }
-    QFile f(fn);
-    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    CaptureStatus status = loadLoopCsv(fn, 1, trace1, liveTimer->interval() / 1000.0);
+    if (status == CaptureOpenFailed) {
         statusBar()->showMessage(tr("Failed to open file: %1").arg(fn), 5000);
         return;
     }
-    QTextStream in(&f);
-    QString header = in.readLine().trimmed();
-    if (!header.contains("1")) {
+    if (status == CaptureBadHeader) {
         statusBar()->showMessage(tr("Invalid file format for Loop 1."), 5000);
         return;
     }
-    series1->clear();
-    sampleCount1 = 0;
-    QVector<QPointF> pts;
-    while (!in.atEnd()) {
-        QStringList parts = in.readLine().split(',');
-        if (parts.size() == 2) {
-            bool okX, okY;
-            double x = parts[0].toDouble(&okX);
-            double y = parts[1].toDouble(&okY);
-            if (okX && okY) {
-                pts.append({ x, y });
-                sampleCount1++;
-            }
-        }
-    }
-    series1->replace(pts);
-    axisX1->setRange(0, windowSize);
-    if (!pts.isEmpty()) {
-        double minY = pts.first().y(), maxY = minY;
-        for (const QPointF &p : pts) {
-            minY = qMin(minY, p.y());
-            maxY = qMax(maxY, p.y());
-        }
-        axisY1->setRange(minY, maxY);
-    }
-    scrollBar1->setRange(0, sampleCount1 - windowSize);
+    sampleCount1 = trace1.size();
+    sourceFile1 = fn;
+    applyFilter(1, filter1.settings());
+    recountTraffic();
+    cursor1->clear();
+    setVisibleWindow(trace1, axisX1, 0);
+    scheduleRender();
+    scrollBar1->setRange(0, qMax(0, sampleCount1 - windowSize));
     scrollBar1->setValue(0);
+    scrollBar1->setEnabled(sampleCount1 > windowSize);
     statusBar()->showMessage(tr("Loop 1 data loaded successfully."), 5000);
 }
 void MainWindow::on_actionLOAD_LOOP2_triggered()
@@ -484,116 +1017,153 @@ void MainWindow::on_actionLOAD_LOOP2_triggered()
         statusBar()->showMessage(tr("Load canceled."), 2000);
         return;
     }
-    QFile f(fn);
-    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    CaptureStatus status = loadLoopCsv(fn, 2, trace2, liveTimer->interval() / 1000.0);
+    if (status == CaptureOpenFailed) {
         statusBar()->showMessage(tr("Failed to open file: %1").arg(fn), 5000);
         return;
     }
-    QTextStream in(&f);
-    QString header = in.readLine().trimmed();
-    if (!header.contains("2")) {
+    if (status == CaptureBadHeader) {
         statusBar()->showMessage(tr("Invalid file format for Loop 2."), 5000);
         return;
     }
-    series2->clear();
-    sampleCount2 = 0;
-    QVector<QPointF> pts;
-    while (!in.atEnd()) {
-        QStringList parts = in.readLine().split(',');
-        if (parts.size() == 2) {
-            bool okX, okY;
-            double x = parts[0].toDouble(&okX);
-            double y = parts[1].toDouble(&okY);
-            if (okX && okY) {
-                pts.append({ x, y });
-                sampleCount2++;
-            }
+    sampleCount2 = trace2.size();
+    sourceFile2 = fn;
+    applyFilter(2, filter2.settings());
+    recountTraffic();
+    cursor2->clear();
+    setVisibleWindow(trace2, axisX2, 0);
+    scheduleRender();
+    scrollBar2->setRange(0, qMax(0, sampleCount2 - windowSize));
+    scrollBar2->setValue(0);
+    scrollBar2->setEnabled(sampleCount2 > windowSize);
+    statusBar()->showMessage(tr("Loop 2 data loaded successfully."), 5000);
+}
+ChartExportPlot MainWindow::exportPlot(const LoopTrace &trace, QValueAxis *axisX,
+                                       QValueAxis *axisY, bool whole, int maxPoints) const
+{
+    ChartExportPlot plot;
+    int first = 0, last = trace.size();
+    if (whole) {
+        plot.minX = trace.isEmpty() ? 0.0 : trace.x(0, timeAxis);
+        plot.maxX = trace.isEmpty() ? 1.0 : trace.lastX(timeAxis);
+        if (!trace.isEmpty()) {
+            double sum;
+            trace.summarize(0, trace.size(), plot.minY, plot.maxY, sum);
+            const double pad = qMax(1e-6, (plot.maxY - plot.minY) * 0.05);
+            plot.minY -= pad;
+            plot.maxY += pad;
         }
+    } else {
+        plot.minX = axisX->min();
+        plot.maxX = axisX->max();
+        plot.minY = axisY->min();
+        plot.maxY = axisY->max();
+        trace.visibleRange(plot.minX, plot.maxX, timeAxis, first, last);
+        --first;
+        ++last;
     }
-    series2->replace(pts);
-    axisX2->setRange(0, windowSize);
-    if (!pts.isEmpty()) {
-        double minY = pts.first().y(), maxY = minY;
-        for (const QPointF &p : pts) {
-            minY = qMin(minY, p.y());
-            maxY = qMax(maxY, p.y());
-        }
-        axisY2->setRange(minY, maxY);
+    plot.runs = trace.points(first, last, timeAxis, maxPoints);
+    return plot;
+}
+void MainWindow::on_actionEXPORT_CHART_triggered()
+{
+    ExportDialog options(this);
+    if (options.exec() != QDialog::Accepted)
+        return;
+    QString fn = QFileDialog::getSaveFileName(this, tr("Export Chart"), QString(),
+                                              tr("PNG Image (*.png);;SVG Image (*.svg);;PDF Document (*.pdf)"));
+    if (fn.isEmpty())
+        return;
+    if (QFileInfo(fn).suffix().isEmpty())
+        fn += ".png";
+
+    // Decimated copies are taken here; the traces are not touched off-thread
+    ChartExport chart;
+    chart.fileName = fn;
+    chart.size = options.size();
+    chart.xTitle = timeAxis ? "Time (s)" : "Sample Count";
+    chart.yTitle = "Frequency";
+    const int maxPoints = chart.size.width() * 2;
+    if (options.loop1()) {
+        chart.plots.append(exportPlot(trace1, axisX1, axisY1, options.wholeCapture(), maxPoints));
+        chart.plots.last().title = tr("Loop 1");
+        chart.plots.last().color = Qt::red;
     }
-    scrollBar2->setRange(0, sampleCount2 - windowSize);
-    scrollBar2->setValue(0);
-    statusBar()->showMessage(tr("Loop 2 data loaded successfully."), 5000);
+    if (options.loop2()) {
+        chart.plots.append(exportPlot(trace2, axisX2, axisY2, options.wholeCapture(), maxPoints));
+        chart.plots.last().title = tr("Loop 2");
+        chart.plots.last().color = Qt::blue;
+    }
+
+    statusBar()->showMessage(tr("Exporting chart to %1...").arg(fn));
+    QtConcurrent::run([chart]() {
+        QString error;
+        return renderChartExport(chart, &error) ? QString() : error;
+    }).then(this, [this, fn](const QString &error) {
+        statusBar()->showMessage(error.isEmpty() ? tr("Chart exported to %1").arg(fn)
+                                                 : tr("Chart export failed: %1").arg(error), 5000);
+    });
+}
+void MainWindow::on_actionCOMPARE_CAPTURES_triggered()
+{
+    if (!compareDialog)
+        compareDialog = new CompareDialog(this);
+    compareDialog->show();
+    compareDialog->raise();
 }
 
 void MainWindow::onSerialReadyRead()
 {
-    // Read and process each complete line
-    while (serialPort->canReadLine()) {
-        QByteArray rawLine = serialPort->readLine();       // includes the '\n'
-        rawLine = rawLine.trimmed();                       // strips '\r' and '\n'
-        QString line = QString::fromUtf8(rawLine);
-
-        emit serialLineReceived(line);
-
-        // Check for LIVE command
-        if (line.startsWith("LIVE:")) {
-            QString data = line.mid(QString("LIVE:").length());
-            QStringList parts = data.split(',', Qt::KeepEmptyParts);
-            if (parts.size() == 22) {
-                bool ok;
-                double freq0 = parts[0].toDouble(&ok);
-                if (ok)
-                {
-                    addLoop1Data(freq0);
-                }
-                double freq1 = parts[1].toDouble(&ok);
-                if (ok) addLoop2Data(freq1);
-                // Parse other values
-                int state0 = parts[2].toInt(&ok);
-                int state1 = parts[3].toInt(&ok);
-                double base0 = parts[4].toDouble(&ok);
-                double base1 = parts[5].toDouble(&ok);
-                double std0 = parts[6].toDouble(&ok);
-                double std1 = parts[7].toDouble(&ok);
-                double jump0 = parts[8].toDouble(&ok);
-                double jump1 = parts[9].toDouble(&ok);
-                double open0 = parts[10].toDouble(&ok);
-                double open1 = parts[11].toDouble(&ok);
-                double short0 = parts[12].toDouble(&ok);
-                double short1 = parts[13].toDouble(&ok);
-                int cal0 = parts[14].toInt(&ok);
-                int cal1 = parts[15].toInt(&ok);
-                int sens1 = parts[16].toInt(&ok);
-                int sens2 = parts[17].toInt(&ok);
-                int boost = parts[18].toInt(&ok);
-                int freqChange = parts[19].toInt(&ok);
-                int loop2Event = parts[20].toInt(&ok);
-                int detectMode = parts[21].toInt(&ok);
-                // Display on status bar
-                // Build first half (up through calibration flags):
-                QString line1 = tr("S0:%1  S1:%2  B0:%3  B1:%4 STD0:%5 STD1:%6 J0:%7  J1:%8  O0:%9  O1:%10  SH0:%11  SH1:%12  C0:%13  C1:%14")
-                                    .arg(state0).arg(state1)
-                                    .arg(base0,0,'f',1).arg(base1,0,'f',1)
-                                    .arg(std0,0,'f',1).arg(std1,0,'f',1)
-                                    .arg(jump0,0,'f',1).arg(jump1,0,'f',1)
-                                    .arg(open0,0,'f',1).arg(open1,0,'f',1)
-                                    .arg(short0,0,'f',1).arg(short1,0,'f',1)
-                                    .arg(cal0).arg(cal1);
-
-                // Build second half (sensitivities onward):
-                QString line2 = tr("S1:%1  S2:%2  B:%3  FC:%4  L2:%5  M:%6")
-                                    .arg(sens1).arg(sens2)
-                                    .arg(boost).arg(freqChange)
-                                    .arg(loop2Event).arg(detectMode);
-
-                // Set both with a newline in between
-                liveDataLabel->setText(line1 + "\n" + line2);
-            } else {
-                qDebug() << "LIVE format error:" << line;
-            }
-        } else {
-        }
+    // Stamp everything in this chunk with the time its bytes arrived
+    const qint64 arrivalUs = frameClock.nsecsElapsed() / 1000;
+    QByteArray chunk = serialPort->readAll();
+    journal->record(SerialJournal::Inbound, arrivalUs, chunk.constData(), chunk.size());
+    processIncoming(chunk, arrivalUs);
+}
+void MainWindow::processIncoming(const QByteArray &chunk, qint64 arrivalUs)
+{
+    // Complete lines and binary frames; partial ones wait for the next chunk
+    decodedItems.clear();
+    frameDecoder.feed(chunk, decodedItems);
+    for (const DecodedItem &item : decodedItems) {
+        if (item.binary)
+            messageBus->publishFrame(item.frame, arrivalUs);
+        else    // trimming strips '\r' and '\n'
+            messageBus->publishLine(QString::fromUtf8(item.line.trimmed()), arrivalUs);
+    }
+}
+void MainWindow::handleLiveFrame(const LiveFrame &frame)
+{
+    // The bus stamped hostTimeUs with the arrival time of the frame's bytes
+    const qint64 arrivalUs = frame.hostTimeUs;
+    bool gap = frameTiming.addFrame(frame.hostTimeUs, frame.deviceSeq) || pendingBreak;
+    pendingBreak = false;
+    if (frame.isValid(FieldFreq0)) {
+        addLoop1Data(frame.value(FieldFreq0), trace1.hostSeconds(frame.hostTimeUs), gap,
+                     loopEventFlags(frame, 1));
+        // Both loops on the wall clock: the traces have their own origins
+        trafficCounter.addSample(1, clockEpochUs + frame.hostTimeUs,
+                                 loopEventFlags(frame, 1) & (1 << EventPresence));
+    }
+    if (frame.isValid(FieldFreq1)) {
+        addLoop2Data(frame.value(FieldFreq1), trace2.hostSeconds(frame.hostTimeUs), gap,
+                     loopEventFlags(frame, 2));
+        trafficCounter.addSample(2, clockEpochUs + frame.hostTimeUs,
+                                 loopEventFlags(frame, 2) & (1 << EventPresence));
     }
+    liveStats.addFrame(frame);
+    frameServer->publish(frame);
+    triggerEngine->addFrame(frame);
+    calibrationMonitor->addFrame(frame);
+    waterfallDock->view()->addFrame(frame);
+    telemetryDock->model()->addFrame(frame);
+    // Replayed frames would land at today's time, so only live ones are archived
+    if (!replay->isRunning())
+        trendArchive.addFrame(frame, clockEpochUs + arrivalUs);
+
+    // Replayed frames carry their recorded arrival time, not ours
+    const qint64 latencyUs = replay->isRunning() ? 0 : frameClock.nsecsElapsed() / 1000 - arrivalUs;
+    metricsServer->metrics().addFrame(frame, latencyUs);
 }
 void MainWindow::sendSerial(const QString &text)
 {
@@ -613,6 +1183,16 @@ void MainWindow::on_actionLIVE_ON_triggered()
         return;
     }
     if (!liveTimer->isActive()) {
+        // A new live session always starts a new line segment
+        frameTiming.reset();
+        frameTiming.setNominalInterval(qint64(liveTimer->interval()) * 1000);
+        pendingBreak = true;
+        timingTimer->start();
+
+        // Firmware without binary support ignores this and keeps sending
+        // LIVE: lines, which the decoder still accepts
+        sendSerial(ui->actionBINARY_FRAMES->isChecked() ? "binary" : "ascii");
+
         liveTimer->start();
         autoScroll = true;      // enable auto‐scroll
         liveDataLabel->setText(tr("Live: ON"));
@@ -634,6 +1214,8 @@ void MainWindow::on_actionLIVE_OFF_triggered()
 {
     if (liveTimer->isActive()) {
         liveTimer->stop();
+        timingTimer->stop();
+        updateTimingLabel();
         autoScroll = false;     // disable auto‐scroll
         liveDataLabel->setText(tr("Live: OFF"));
         ui->actionLIVE_ON->setEnabled(true);
@@ -675,26 +1257,44 @@ void MainWindow::on_actionFORMAT_EEPROM_triggered()
 
 void MainWindow::on_btnCLA1_clicked()
 {
-    if (serialPort->isOpen()) {
-        sendSerial("cal1");
-    }
+    startCalibration(1);
 }
 void MainWindow::on_btnCAL2_clicked()
 {
-    if (serialPort->isOpen()) {
-        sendSerial("cal2");
+    startCalibration(2);
+}
+void MainWindow::startCalibration(int loopMask)
+{
+    if (!serialPort->isOpen())
+        return;
+    // Convergence is judged from the LIVE fields
+    if (!liveTimer->isActive())
+        on_actionLIVE_ON_triggered();
+    for (int loop = 1; loop <= 2; ++loop) {
+        if (!(loopMask & (1 << (loop - 1))))
+            continue;
+        sendSerial(loop == 1 ? "cal1" : "cal2");
+        calibrationMonitor->start(loop);
+    }
+}
+void MainWindow::on_actionCALIBRATION_MONITOR_triggered()
+{
+    if (!calibrationDialog) {
+        calibrationDialog = new CalibrationDialog(calibrationMonitor, this);
+        connect(calibrationDialog, &CalibrationDialog::startRequested,
+                this, &MainWindow::startCalibration);
     }
+    calibrationDialog->show();
+    calibrationDialog->raise();
 }
 
 void MainWindow::on_actionEEPROM_triggered()
 {
         if (!eepromDialog) {
             eepromDialog = new EEPROMDialog(serialPort, this);
-            // listen for lines
-            connect(this,
-                    &MainWindow::serialLineReceived,
-                    eepromDialog,
-                    &EEPROMDialog::appendLine);
+            messageBus->subscribe(TopicEepromRow, eepromDialog, [this](const BusMessagePtr &message) {
+                eepromDialog->setRow(message->address, message->addressText, message->values);
+            });
         }
         eepromDialog->show();
         eepromDialog->raise();
@@ -704,25 +1304,180 @@ void MainWindow::on_actionOPEN_PARAMETERS_triggered()
 {
     if (!parametersDialog) {
         parametersDialog = new ParametersDialog(serialPort, this);
-        // forward all incoming lines into it
-        connect(this,
-                &MainWindow::serialLineReceived,
-                parametersDialog,
-                &ParametersDialog::onSerialLineReceived);
+        messageBus->subscribe(TopicParameterSet, parametersDialog, [this](const BusMessagePtr &message) {
+            parametersDialog->setValues(message->values);
+        });
     }
     parametersDialog->show();
     parametersDialog->raise();
     parametersDialog->onRefreshClicked();  // fetch current params
 }
-void MainWindow::autoscaleYVisible(QLineSeries* series, QValueAxis* axisX, QValueAxis* axisY) {
-    // 1) alle Punkte im sichtbaren X-Bereich sammeln
-    const auto minX = axisX->min();
-    const auto maxX = axisX->max();
-    QVector<double> yVals;
-    for (const auto &pt : series->pointsVector()) {
-        if (pt.x() >= minX && pt.x() <= maxX)
-            yVals.append(pt.y());
+void MainWindow::on_actionRECORD_JOURNAL_toggled(bool checked)
+{
+    if (!checked) {
+        journal->close();
+        statusBar()->showMessage(tr("Journal closed: %1 bytes written, %2 dropped")
+                                     .arg(journal->writtenBytes())
+                                     .arg(journal->droppedBytes()), 5000);
+        return;
+    }
+    QString fn = QFileDialog::getSaveFileName(this, tr("Record Journal"), QString(),
+                                              tr("Serial Journal (*.ljr)"));
+    if (fn.isEmpty() || !journal->open(fn)) {
+        QSignalBlocker block(ui->actionRECORD_JOURNAL);
+        ui->actionRECORD_JOURNAL->setChecked(false);
+        if (!fn.isEmpty())
+            statusBar()->showMessage(tr("Failed to open file: %1").arg(fn), 5000);
+        return;
+    }
+    statusBar()->showMessage(tr("Recording serial journal to %1").arg(fn), 5000);
+}
+void MainWindow::on_actionREPLAY_JOURNAL_triggered()
+{
+    if (serialPort->isOpen()) {
+        statusBar()->showMessage(tr("Cannot replay while connected."), 5000);
+        return;
+    }
+    QString fn = QFileDialog::getOpenFileName(this, tr("Replay Journal"), QString(),
+                                              tr("Serial Journal (*.ljr)"));
+    if (fn.isEmpty())
+        return;
+    if (!replay->open(fn)) {
+        statusBar()->showMessage(tr("Invalid journal file: %1").arg(fn), 5000);
+        return;
+    }
+
+    // Start from a clean pipeline, exactly as a fresh live session would
+    metricsServer->setDevice(QStringLiteral("replay"));
+    resetLoop1();
+    resetLoop2();
+    frameDecoder.clear();
+    liveStats.reset();
+    frameTiming.reset();
+    frameTiming.setNominalInterval(qint64(liveTimer->interval()) * 1000);
+    autoScroll = true;
+    timingTimer->start();
+    liveDataLabel->setText(tr("Replay: ON"));
+
+    ui->actionREPLAY_JOURNAL->setEnabled(false);
+    ui->actionSTOP_REPLAY->setEnabled(true);
+    connectAction->setEnabled(false);
+    ui->actionLOAD_LOOP1->setEnabled(false);
+    ui->actionLOAD_LOOP2->setEnabled(false);
+    ui->actionSAVE_LOOP_1->setEnabled(false);
+    ui->actionSAVE_LOOP_2->setEnabled(false);
+    // Dialogs see the replayed PARAMETERS:/EEPROM lines like live ones
+    ui->actionEEPROM->setEnabled(true);
+    ui->actionOPEN_PARAMETERS->setEnabled(true);
+
+    replayClock.start();
+    replay->start(replaySpeedGroup->checkedAction()->data().toDouble());
+}
+void MainWindow::on_actionSTOP_REPLAY_triggered()
+{
+    replay->stop();
+    onReplayFinished();
+}
+void MainWindow::onReplayFinished()
+{
+    autoScroll = false;
+    timingTimer->stop();
+    updateTimingLabel();
+    liveDataLabel->setText(tr("Replay: OFF"));
+
+    ui->actionREPLAY_JOURNAL->setEnabled(true);
+    ui->actionSTOP_REPLAY->setEnabled(false);
+    connectAction->setEnabled(portGroup->checkedAction() != nullptr);
+    ui->actionLOAD_LOOP1->setEnabled(true);
+    ui->actionLOAD_LOOP2->setEnabled(true);
+    ui->actionSAVE_LOOP_1->setEnabled(true);
+    ui->actionSAVE_LOOP_2->setEnabled(true);
+    ui->actionEEPROM->setEnabled(serialPort->isOpen());
+    ui->actionOPEN_PARAMETERS->setEnabled(serialPort->isOpen());
+    if (sampleCount1 > windowSize) scrollBar1->setEnabled(true);
+    if (sampleCount2 > windowSize) scrollBar2->setEnabled(true);
+
+    statusBar()->showMessage(tr("Replay finished: %1 chunks in %2 ms")
+                                 .arg(replay->chunksReplayed())
+                                 .arg(replayClock.elapsed()), 0);
+}
+void MainWindow::on_actionSTATISTICS_triggered()
+{
+    if (!statisticsDialog)
+        statisticsDialog = new StatisticsDialog(&liveStats, this);
+    statisticsDialog->show();
+    statisticsDialog->raise();
+}
+void MainWindow::on_actionTRIGGERS_triggered()
+{
+    if (!triggerDialog)
+        triggerDialog = new TriggerDialog(triggerEngine, this);
+    triggerDialog->show();
+    triggerDialog->raise();
+}
+void MainWindow::on_actionRECORD_TRENDS_toggled(bool checked)
+{
+    if (!checked) {
+        trendArchive.close();
+        statusBar()->showMessage(tr("Trend archive closed"), 5000);
+        return;
     }
+    // An existing archive is continued where it left off
+    QString fn = QFileDialog::getSaveFileName(this, tr("Record Trends"), QString(),
+                                              tr("Trend Archive (*.ltr)"), nullptr,
+                                              QFileDialog::DontConfirmOverwrite);
+    if (fn.isEmpty() || !trendArchive.open(fn, true)) {
+        QSignalBlocker block(ui->actionRECORD_TRENDS);
+        ui->actionRECORD_TRENDS->setChecked(false);
+        if (!fn.isEmpty())
+            statusBar()->showMessage(tr("Failed to open trend archive: %1").arg(fn), 5000);
+        return;
+    }
+    statusBar()->showMessage(tr("Recording trends to %1").arg(fn), 5000);
+}
+void MainWindow::on_actionTRENDS_triggered()
+{
+    if (!trendDialog)
+        trendDialog = new TrendDialog(&trendArchive, this);
+    trendDialog->show();
+    trendDialog->raise();
+}
+void MainWindow::on_actionTIME_AXIS_toggled(bool checked)
+{
+    timeAxis = checked;
+    for (QValueAxis *axis : {axisX1, axisX2}) {
+        axis->setTitleText(checked ? "Time (s)" : "Sample Count");
+        axis->setLabelFormat(checked ? "%.1f" : "%d");
+    }
+    setVisibleWindow(trace1, axisX1, scrollBar1->value());
+    setVisibleWindow(trace2, axisX2, scrollBar2->value());
+    scheduleRender();
+}
+void MainWindow::on_actionCROSSHAIR_toggled(bool checked)
+{
+    cursor1->setCrosshairEnabled(checked);
+    cursor2->setCrosshairEnabled(checked);
+}
+void MainWindow::on_actionMEASURE_toggled(bool checked)
+{
+    cursor1->setMeasureEnabled(checked);
+    cursor2->setMeasureEnabled(checked);
+    if (checked)
+        statusBar()->showMessage(tr("Click a chart to place marker A, click again for B."), 5000);
+}
+void MainWindow::updateTimingLabel()
+{
+    timingLabel->setText(tr("%1 Hz  jitter %2 ms  gaps %3  lost %4  %5  crc err %6")
+                             .arg(frameTiming.rateHz(), 0, 'f', 1)
+                             .arg(frameTiming.jitterMs(), 0, 'f', 1)
+                             .arg(frameTiming.gaps())
+                             .arg(frameTiming.lostFrames())
+                             .arg(binaryLive ? tr("BIN") : tr("ASCII"))
+                             .arg(frameDecoder.crcErrors()));
+}
+void MainWindow::autoscaleYVisible(QVector<double> yVals, QValueAxis* axisY) {
+    // 1) Punkte im sichtbaren X-Bereich kommen von renderLoop
+    //    (bei starker Verkleinerung Min/Max je Pixel)
     if (yVals.empty()) return;
 
     // 2) sortieren
@@ -743,3 +1498,219 @@ void MainWindow::autoscaleYVisible(QLineSeries* series, QValueAxis* axisX, QValu
     // 4) Range neu setzen
     axisY->setRange(yVals[start], yVals[end]);
 }
+void MainWindow::on_actionSHOW_EVENTS_toggled(bool)
+{
+    scheduleRender();
+}
+void MainWindow::setEventCursor(const LoopTrace &trace, int centerSample)
+{
+    // After scrolling, navigation continues from the centre of the view
+    if (trace.isEmpty())
+        return;
+    eventCursorS = trace.time(qBound(0, centerSample, trace.size() - 1));
+    eventCursorLoop = 0;
+    eventCursorIndex = -1;
+}
+void MainWindow::on_actionNEXT_EVENT_triggered()
+{
+    // Events are ordered by (start time, loop, index); take the smallest
+    // one after the cursor. Each candidate is one binary search.
+    int bestLoop = 0, bestIndex = -1;
+    double bestS = 0.0;
+    for (int loop = 1; loop <= 2; ++loop) {
+        const EventIndex &events = (loop == 1 ? trace1 : trace2).events();
+        int i;
+        if (loop == eventCursorLoop)
+            i = eventCursorIndex + 1;
+        else if (loop > eventCursorLoop)
+            i = events.lowerBoundTime(eventCursorS);
+        else
+            i = events.upperBoundTime(eventCursorS);
+        if (i >= events.size())
+            continue;
+        if (bestIndex < 0 || events.at(i).startS < bestS) {
+            bestLoop = loop;
+            bestIndex = i;
+            bestS = events.at(i).startS;
+        }
+    }
+    if (bestIndex < 0) {
+        statusBar()->showMessage(tr("No further events."), 2000);
+        return;
+    }
+    jumpToEvent(bestLoop, bestIndex);
+}
+void MainWindow::on_actionPREVIOUS_EVENT_triggered()
+{
+    int bestLoop = 0, bestIndex = -1;
+    double bestS = 0.0;
+    for (int loop = 2; loop >= 1; --loop) {
+        const EventIndex &events = (loop == 1 ? trace1 : trace2).events();
+        int i;
+        if (loop == eventCursorLoop)
+            i = eventCursorIndex - 1;
+        else if (loop > eventCursorLoop)
+            i = events.lowerBoundTime(eventCursorS) - 1;
+        else
+            i = events.upperBoundTime(eventCursorS) - 1;
+        if (i < 0 || i >= events.size())
+            continue;
+        if (bestIndex < 0 || events.at(i).startS > bestS) {
+            bestLoop = loop;
+            bestIndex = i;
+            bestS = events.at(i).startS;
+        }
+    }
+    if (bestIndex < 0) {
+        statusBar()->showMessage(tr("No earlier events."), 2000);
+        return;
+    }
+    jumpToEvent(bestLoop, bestIndex);
+}
+void MainWindow::jumpToEvent(int loop, int index)
+{
+    if (autoScroll) {
+        statusBar()->showMessage(tr("Stop live or replay to navigate events."), 3000);
+        return;
+    }
+    const LoopTrace &trace = loop == 1 ? trace1 : trace2;
+    if (index < 0 || index >= trace.events().size())
+        return;
+    const DetectionEvent &e = trace.events().at(index);
+
+    // Centre the event in its chart and the other chart on the same host time
+    int sample1 = e.firstSample, sample2 = e.firstSample, last;
+    if (loop == 1)
+        trace2.visibleRange(e.startS, e.startS, true, sample2, last);
+    else
+        trace1.visibleRange(e.startS, e.startS, true, sample1, last);
+    scrollBar1->setValue(qMax(0, sample1 - windowSize / 2));
+    scrollBar2->setValue(qMax(0, sample2 - windowSize / 2));
+
+    eventCursorS = e.startS;
+    eventCursorLoop = loop;
+    eventCursorIndex = index;
+    statusBar()->showMessage(tr("Loop %1: %2 at %3 s, %4 s long")
+                                 .arg(loop)
+                                 .arg(eventKindName(e.kind))
+                                 .arg(e.startS, 0, 'f', 3)
+                                 .arg(e.endS - e.startS, 0, 'f', 3), 5000);
+}
+void MainWindow::on_actionEVENT_LIST_triggered()
+{
+    if (!eventListDialog) {
+        eventListDialog = new EventListDialog(&trace1, &trace2, this);
+        connect(eventListDialog, &EventListDialog::eventActivated,
+                this, &MainWindow::jumpToEvent);
+    }
+    eventListDialog->show();
+    eventListDialog->raise();
+}
+void MainWindow::on_actionTRAFFIC_triggered()
+{
+    if (!trafficDialog) {
+        trafficDialog = new TrafficDialog(&trafficCounter, this);
+        connect(trafficDialog, &TrafficDialog::settingsChanged, this,
+                [this](const TrafficSettings &settings) {
+            trafficCounter.setSettings(settings);
+            recountTraffic();
+        });
+    }
+    trafficDialog->show();
+    trafficDialog->raise();
+}
+void MainWindow::recountTraffic()
+{
+    // Presence intervals are indexed per trace, so this is quick even for
+    // long captures; live samples then continue from the last state
+    QElapsedTimer clock;
+    clock.start();
+    // Traces count from their first live sample on the wall clock, so a
+    // recount matches the live count. Loaded captures without live data
+    // have no wall clock; their own time axis starts at the epoch.
+    auto wallOrigin = [this](const LoopTrace &trace) {
+        return trace.hostOriginUs() < 0 ? 0 : clockEpochUs + trace.hostOriginUs();
+    };
+    trafficCounter.count(trace1, wallOrigin(trace1), trace2, wallOrigin(trace2));
+    if (!trafficCounter.vehicles().isEmpty())
+        statusBar()->showMessage(tr("%1 vehicles counted in %2 ms")
+                                     .arg(trafficCounter.vehicles().size())
+                                     .arg(clock.elapsed()), 5000);
+}
+void MainWindow::on_actionRUN_SCRIPT_triggered()
+{
+    // Scripts open their own ports; the one connected here stays in use
+    if (!scriptDialog)
+        scriptDialog = new ScriptDialog(this);
+    scriptDialog->setBaudRate(baudRate);
+    scriptDialog->show();
+    scriptDialog->raise();
+}
+QHostAddress MainWindow::serverAddress() const
+{
+    // Live data stays on this machine unless remote clients are allowed
+    return ui->actionALLOW_REMOTE->isChecked() ? QHostAddress(QHostAddress::Any)
+                                               : QHostAddress(QHostAddress::LocalHost);
+}
+void MainWindow::on_actionALLOW_REMOTE_toggled(bool checked)
+{
+    // Running servers are rebound at once on the same port
+    if (metricsServer->isListening()) {
+        const quint16 port = metricsServer->port();
+        if (!metricsServer->listen(port, serverAddress())) {
+            QSignalBlocker block(ui->actionMETRICS_ENDPOINT);
+            ui->actionMETRICS_ENDPOINT->setChecked(false);
+            statusBar()->showMessage(tr("Cannot listen on port %1").arg(port), 5000);
+            return;
+        }
+    }
+    if (frameServer->isListening()) {
+        const quint16 port = frameServer->port();
+        if (!frameServer->listen(port, serverAddress())) {
+            QSignalBlocker block(ui->actionFRAME_SERVER);
+            ui->actionFRAME_SERVER->setChecked(false);
+            statusBar()->showMessage(tr("Cannot listen on port %1").arg(port), 5000);
+            return;
+        }
+    }
+    statusBar()->showMessage(checked ? tr("Servers accept remote clients.")
+                                     : tr("Servers accept local clients only."), 3000);
+}
+void MainWindow::on_actionFRAME_SERVER_toggled(bool checked)
+{
+    if (!checked) {
+        frameServer->close();
+        statusBar()->showMessage(tr("Frame server stopped."), 3000);
+        return;
+    }
+    bool ok;
+    int port = QInputDialog::getInt(this, tr("Frame Server"), tr("TCP port:"),
+                                    5760, 1, 65535, 1, &ok);
+    if (!ok || !frameServer->listen(quint16(port), serverAddress())) {
+        QSignalBlocker block(ui->actionFRAME_SERVER);
+        ui->actionFRAME_SERVER->setChecked(false);
+        if (ok)
+            statusBar()->showMessage(tr("Cannot listen on port %1").arg(port), 5000);
+        return;
+    }
+    statusBar()->showMessage(tr("Frame server listening on port %1").arg(port), 5000);
+}
+void MainWindow::on_actionMETRICS_ENDPOINT_toggled(bool checked)
+{
+    if (!checked) {
+        metricsServer->close();
+        statusBar()->showMessage(tr("Metrics endpoint stopped."), 3000);
+        return;
+    }
+    bool ok;
+    int port = QInputDialog::getInt(this, tr("Metrics Endpoint"), tr("HTTP port:"),
+                                    9464, 1, 65535, 1, &ok);
+    if (!ok || !metricsServer->listen(quint16(port), serverAddress())) {
+        QSignalBlocker block(ui->actionMETRICS_ENDPOINT);
+        ui->actionMETRICS_ENDPOINT->setChecked(false);
+        if (ok)
+            statusBar()->showMessage(tr("Cannot listen on port %1").arg(port), 5000);
+        return;
+    }
+    statusBar()->showMessage(tr("Metrics at http://localhost:%1/metrics").arg(port), 5000);
+}
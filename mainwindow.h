@@ -15,6 +15,11 @@
 #include <QMouseEvent>
 #include <QTimer>
 #include <QMessageBox>  // at the top with the other Qt includes
+#include <QInputDialog>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QThread>
+#include <QGraphicsRectItem>
 #include <QtCharts/QChartView>
 #include <QtCharts/QChart>
 #include <QtCharts/QLineSeries>
@@ -22,6 +27,33 @@
 
 #include <eepromdialog.h>
 #include <parametersdialog.h>
+#include <statisticsdialog.h>
+#include <eventlistdialog.h>
+#include <scriptdialog.h>
+#include <triggerdialog.h>
+#include <waterfallview.h>
+#include <telemetrydock.h>
+#include <trenddialog.h>
+#include <filterdialog.h>
+#include <trafficdialog.h>
+#include <comparedialog.h>
+#include <calibrationdialog.h>
+#include <liveframe.h>
+#include <framedecoder.h>
+#include <rollingstats.h>
+#include <frametiming.h>
+#include <looptrace.h>
+#include <chartcursor.h>
+#include <captureio.h>
+#include <sessionsnapshot.h>
+#include <chartexport.h>
+#include <exportdialog.h>
+#include <portscanner.h>
+#include <serialjournal.h>
+#include <journalreplay.h>
+#include <frameserver.h>
+#include <metricsserver.h>
+#include <messagebus.h>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -31,16 +63,17 @@ QT_END_NAMESPACE
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
+    friend class SoakTest;     // drives the window like a device and a user
 
 public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
-    void addLoop1Data(double frequency);
-    void addLoop2Data(double frequency);
+    void addLoop1Data(double frequency, double timeS, bool gapBefore = false, quint8 eventFlags = 0);
+    void addLoop2Data(double frequency, double timeS, bool gapBefore = false, quint8 eventFlags = 0);
     void sendSerial(const QString &text);
-
-signals:
-    void serialLineReceived(const QString &line);
+    // Start saving the session every few seconds; with restore, first
+    // bring back the previous one (call before show())
+    void restoreSession(bool restore);
 
 protected:
     bool eventFilter(QObject *obj, QEvent *event) override;
@@ -48,12 +81,16 @@ protected:
 private slots:
     void on_actionREFRESH_triggered();
     void onPortSelected(QAction *action);
+    void onBaudSelected(QAction *action);
+    void onPollRateSelected(QAction *action);
     void on_actionCONNECT_triggered();
     void on_actionDISCONNECT_triggered();
     void on_btnRESET1_clicked();
     void on_btnRESET2_clicked();
     void on_actionSAVE_LOOP_1_triggered();
     void on_actionSAVE_LOOP_2_triggered();
+    void on_actionFILTERS_triggered();
+    void on_actionEXPORT_CHART_triggered();
     void on_actionLOAD_LOOP1_triggered();
     void on_actionLOAD_LOOP2_triggered();
     void onSerialReadyRead();
@@ -66,49 +103,167 @@ private slots:
     void on_btnCAL2_clicked();
     void on_actionEEPROM_triggered();
     void on_actionOPEN_PARAMETERS_triggered();
+    void on_actionSTATISTICS_triggered();
+    void on_actionTRIGGERS_triggered();
+    void on_actionRECORD_TRENDS_toggled(bool checked);
+    void on_actionTRENDS_triggered();
+    void on_actionCOMPARE_CAPTURES_triggered();
+    void on_actionTIME_AXIS_toggled(bool checked);
+    void on_actionCROSSHAIR_toggled(bool checked);
+    void on_actionMEASURE_toggled(bool checked);
+    void onPortsChanged(const QList<PortCandidate> &ports);
+    void onSerialError(QSerialPort::SerialPortError error);
+    void on_actionRECORD_JOURNAL_toggled(bool checked);
+    void on_actionREPLAY_JOURNAL_triggered();
+    void on_actionSTOP_REPLAY_triggered();
+    void onReplayFinished();
+    void on_actionSHOW_EVENTS_toggled(bool checked);
+    void on_actionNEXT_EVENT_triggered();
+    void on_actionPREVIOUS_EVENT_triggered();
+    void on_actionEVENT_LIST_triggered();
+    void on_actionTRAFFIC_triggered();
+    void on_actionRUN_SCRIPT_triggered();
+    void on_actionCALIBRATION_MONITOR_triggered();
+    void startCalibration(int loopMask);
+    void on_actionALLOW_REMOTE_toggled(bool checked);
+    void on_actionFRAME_SERVER_toggled(bool checked);
+    void on_actionMETRICS_ENDPOINT_toggled(bool checked);
+    void jumpToEvent(int loop, int index);
+    void updateTimingLabel();
 
 private:
     void connectActions();
+    bool connectToPort(const QString &portName);
+    void processIncoming(const QByteArray &chunk, qint64 arrivalUs);
+    void handleLiveFrame(const LiveFrame &frame);
     void resetLoop1();
     void resetLoop2();
+    QLineSeries *addSegment(QChart *chart, QList<QLineSeries*> &segments,
+                            QValueAxis *axisX, QValueAxis *axisY, const QColor &color);
+    void renderLoop(QChart *chart, QList<QLineSeries*> &segments, const LoopTrace &trace,
+                    QValueAxis *axisX, QValueAxis *axisY, const QColor &color,
+                    QVector<double> &yVals, const LoopTrace *raw = nullptr);
+    void applyFilter(int loop, const FilterSettings &settings);
+    void saveFiltered(int loop);
+    QHostAddress serverAddress() const;
+    void recountTraffic();
+    void renderEvents(QChart *chart, QList<QGraphicsRectItem*> &overlays,
+                      const LoopTrace &trace, QValueAxis *axisX);
+    void scheduleRender();
+    void renderCharts();
+    void setEventCursor(const LoopTrace &trace, int centerSample);
+    void setVisibleWindow(const LoopTrace &trace, QValueAxis *axisX, int first);
+    double windowSpan() const;
+    void saveSession();
+    QList<QPair<QWidget *, QAction *>> sessionDialogs() const;
+    ChartExportPlot exportPlot(const LoopTrace &trace, QValueAxis *axisX, QValueAxis *axisY,
+                               bool whole, int maxPoints) const;
 
     Ui::MainWindow *ui;
-    QSerialPort *serialPort;
-    QByteArray serialBuffer;
+    JournalingSerialPort *serialPort;
+    qint32 baudRate = 921600;
+    FrameDecoder frameDecoder;  // ASCII lines and binary LIVE frames
+    QList<DecodedItem> decodedItems;
+    MessageBus *messageBus;     // decoded lines and frames by topic
+    bool binaryLive = false;    // last LIVE frame arrived in binary
+    SerialJournal *journal;     // optional raw traffic recording
+    JournalReplay *replay;      // feeds a journal back into processIncoming
+    QActionGroup *replaySpeedGroup;
+    QElapsedTimer replayClock;
+    FrameServer *frameServer;   // optional fan-out of frames to TCP clients
+    MetricsServer *metricsServer;   // optional HTTP /metrics endpoint
     QMenu *portMenu;
     QActionGroup *portGroup;
+    QActionGroup *baudGroup;
+    QActionGroup *pollGroup;
     QAction *refreshAction;
     QAction *connectAction;
     QAction *disconnectAction;
+    QThread *scannerThread;
+    PortScanner *portScanner;   // lives in scannerThread
+    QString reconnectPort;      // port lost while connected, reopened when it returns
+    bool resumeLive = false;
+    bool autoConnectDone = false;
     QLabel *connectionLabel;
-    QLabel *liveDataLabel;  // shows parsed live data
+    QLabel *liveDataLabel;  // live / replay state
+    QLabel *timingLabel;    // measured frame rate / jitter / gaps
+    QTimer *timingTimer;    // refreshes timingLabel while live
+    QTimer *renderTimer;    // coalesces chart redraws into one per event loop pass
     QTimer  *liveTimer;      // polls device every 100 ms
     QScrollBar *scrollBar1;
     QScrollBar *scrollBar2;
 
     QChartView *chartView1;
     QChart *chart1;
-    QLineSeries *series1;
+    QList<QLineSeries*> segments1;  // one series per gap-free run
+    QList<QGraphicsRectItem*> overlays1;    // shaded event spans, reused
+    ChartCursor *cursor1;
+    LoopTrace trace1;
+    LoopFilter filter1;             // filter stage between the frames and filtered1
+    LoopTrace filtered1;
+    QList<QLineSeries*> filteredSegments1;
     QValueAxis *axisX1;
     QValueAxis *axisY1;
     int sampleCount1;
 
     QChartView *chartView2;
     QChart *chart2;
-    QLineSeries *series2;
+    QList<QLineSeries*> segments2;
+    QList<QGraphicsRectItem*> overlays2;
+    ChartCursor *cursor2;
+    LoopTrace trace2;
+    LoopFilter filter2;
+    LoopTrace filtered2;
+    QList<QLineSeries*> filteredSegments2;
     QValueAxis *axisX2;
     QValueAxis *axisY2;
     int sampleCount2;
 
     bool isPanning;
     QPoint lastMousePos;
+    QPoint pressMousePos;       // a release near it is a click, not a pan
     const int windowSize = 100;
     bool autoScroll;
+    bool timeAxis = false;      // X axis in host seconds instead of samples
+    bool showRaw = true;        // with a filter active, raw and/or filtered traces
+    bool showFiltered = true;
+    bool pendingBreak = false;  // next sample starts a new segment
+
+    // Event navigation position: the last event jumped to, or loop 0 and
+    // the time at the centre of the view after scrolling
+    double eventCursorS = 0.0;
+    int eventCursorLoop = 0;
+    int eventCursorIndex = -1;
 
     EEPROMDialog* eepromDialog = nullptr;
     ParametersDialog *parametersDialog = nullptr;
+    StatisticsDialog *statisticsDialog = nullptr;
+    EventListDialog *eventListDialog = nullptr;
+    ScriptDialog *scriptDialog = nullptr;
+    TriggerDialog *triggerDialog = nullptr;
+    TrendDialog *trendDialog = nullptr;
+    CompareDialog *compareDialog = nullptr;
+    CalibrationDialog *calibrationDialog = nullptr;
+    FilterDialog *filterDialog = nullptr;
+    TrafficDialog *trafficDialog = nullptr;
+
+    QElapsedTimer frameClock;   // host time base for received frames
+    qint64 clockEpochUs = 0;    // wall clock at frameClock.start()
+    LiveStatistics liveStats;   // host side statistics of every LIVE field
+    TrafficCounter trafficCounter;  // vehicles from the presence states of both loops
+    FrameTiming frameTiming;    // measured rate, jitter and gaps
+    TriggerEngine *triggerEngine;   // pre/post-trigger captures
+    CalibrationMonitor *calibrationMonitor;
+    WaterfallDock *waterfallDock;
+    TelemetryDock *telemetryDock;
+    TrendArchive trendArchive;  // optional 1 s / 1 min / 1 h health archive
+    SessionSnapshot session;    // restored at startup, saved by sessionTimer and on exit
+    QTimer *sessionTimer = nullptr;
+    QString sessionPort;        // port of the restored session, preselected when it appears
+    QString sourceFile1;        // capture each loop was loaded from
+    QString sourceFile2;
 
-    void autoscaleYVisible(QLineSeries* series, QValueAxis* axisX, QValueAxis* axisY);
+    void autoscaleYVisible(QVector<double> yVals, QValueAxis* axisY);
 };
 
 
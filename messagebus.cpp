@@ -0,0 +1,136 @@
+// messagebus.cpp
+#include "messagebus.h"
+#include <QRegularExpression>
+
+QString messageTopicName(int topic)
+{
+    switch (topic) {
+    case TopicLiveFrame:    return QStringLiteral("live");
+    case TopicParameterSet: return QStringLiteral("parameters");
+    case TopicEepromRow:    return QStringLiteral("eeprom");
+    case TopicUnknown:      return QStringLiteral("unknown");
+    }
+    return QString();
+}
+
+MessageBus::MessageBus(QObject *parent)
+    : QObject(parent)
+{
+    clock.start();
+}
+
+void MessageBus::subscribe(MessageTopic topic, QObject *receiver, const Handler &handler)
+{
+    bool known = false;
+    for (const Topic &t : topics) {
+        for (const Subscriber &s : t.subscribers)
+            known = known || s.receiver == receiver;
+    }
+    if (!known)
+        connect(receiver, &QObject::destroyed, this, [this, receiver]() { unsubscribe(receiver); });
+    topics[topic].subscribers.append({receiver, handler});
+    topics[topic].stats.subscribers = topics[topic].subscribers.size();
+}
+
+void MessageBus::unsubscribe(QObject *receiver)
+{
+    for (Topic &t : topics) {
+        t.subscribers.removeIf([receiver](const Subscriber &s) {
+            return s.receiver.isNull() || s.receiver == receiver;
+        });
+        t.stats.subscribers = t.subscribers.size();
+    }
+}
+
+void MessageBus::count(MessageTopic topic)
+{
+    Topic &t = topics[topic];
+    ++t.stats.published;
+    ++t.windowCount;
+    const qint64 nowNs = clock.nsecsElapsed();
+    if (nowNs - t.windowStartNs >= 1000000000) {
+        t.stats.rateHz = t.windowCount * 1e9 / (nowNs - t.windowStartNs);
+        t.windowStartNs = nowNs;
+        t.windowCount = 0;
+    }
+}
+
+void MessageBus::publishLine(const QString &line, qint64 arrivalUs)
+{
+    static const QString livePrefix = QStringLiteral("LIVE:");
+    static const QString parametersPrefix = QStringLiteral("PARAMETERS:");
+
+    MessageTopic topic = TopicUnknown;
+    if (line.startsWith(livePrefix))
+        topic = TopicLiveFrame;
+    else if (line.startsWith(parametersPrefix))
+        topic = TopicParameterSet;
+    else if (line.startsWith(QLatin1String("0x")))
+        topic = TopicEepromRow;
+    // Nobody listens: count it by prefix and skip the parsing. A LIVE line
+    // that fails to parse still goes to the subscribers of TopicUnknown.
+    if (!hasSubscribers(topic) && !(topic == TopicLiveFrame && hasSubscribers(TopicUnknown))) {
+        count(topic);
+        return;
+    }
+
+    auto message = QSharedPointer<BusMessage>::create();
+    message->topic = topic;
+    message->arrivalUs = arrivalUs;
+    message->line = line;
+    if (topic == TopicLiveFrame) {
+        message->frame.hostTimeUs = arrivalUs;
+        if (!parseLiveFrame(line, message->frame)) {
+            message->topic = TopicUnknown;
+            message->malformed = true;
+        }
+    } else if (topic == TopicParameterSet) {
+        message->values = line.mid(parametersPrefix.size()).split(',', Qt::SkipEmptyParts);
+    } else if (topic == TopicEepromRow) {
+        static const QRegularExpression space("\\s+");
+        const QStringList parts = line.split(space, Qt::SkipEmptyParts);
+        bool ok = false;
+        message->address = parts.at(0).mid(2).toInt(&ok, 16);
+        if (ok && parts.size() >= 17) {
+            message->addressText = parts.at(0);
+            message->values = parts.mid(1, 16);
+        } else {
+            message->topic = TopicUnknown;
+        }
+    }
+    count(message->topic);
+    if (hasSubscribers(message->topic))
+        deliver(message);
+}
+
+void MessageBus::publishFrame(const LiveFrame &frame, qint64 arrivalUs)
+{
+    count(TopicLiveFrame);
+    if (!hasSubscribers(TopicLiveFrame))
+        return;
+    auto message = QSharedPointer<BusMessage>::create();
+    message->topic = TopicLiveFrame;
+    message->arrivalUs = arrivalUs;
+    message->frame = frame;
+    message->frame.hostTimeUs = arrivalUs;
+    message->binary = true;
+    deliver(message);
+}
+
+void MessageBus::deliver(const QSharedPointer<BusMessage> &message)
+{
+    const BusMessagePtr shared = message;
+    Topic &t = topics[message->topic];
+    // A handler may subscribe or unsubscribe; the copy only detaches then
+    const QVector<Subscriber> subscribers = t.subscribers;
+    for (const Subscriber &s : subscribers) {
+        if (s.receiver.isNull())
+            continue;
+        const qint64 startNs = clock.nsecsElapsed();
+        s.handler(shared);
+        const double us = (clock.nsecsElapsed() - startNs) / 1000.0;
+        ++t.stats.deliveries;
+        t.stats.handlerSumUs += us;
+        t.stats.handlerMaxUs = qMax(t.stats.handlerMaxUs, us);
+    }
+}
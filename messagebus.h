@@ -0,0 +1,91 @@
+// messagebus.h
+#ifndef MESSAGEBUS_H
+#define MESSAGEBUS_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+#include "liveframe.h"
+
+// What a received line is, decided once from its prefix
+enum MessageTopic {
+    TopicLiveFrame,     // "LIVE:" line or binary frame
+    TopicParameterSet,  // "PARAMETERS:" line
+    TopicEepromRow,     // "0x" address followed by 16 bytes
+    TopicUnknown,       // anything else
+    TopicCount
+};
+
+QString messageTopicName(int topic);
+
+// One received message, built once and shared read-only by every
+// subscriber of its topic
+struct BusMessage {
+    MessageTopic topic = TopicUnknown;
+    qint64      arrivalUs = 0;
+    QString     line;               // as received, empty for binary frames
+    LiveFrame   frame;              // TopicLiveFrame, hostTimeUs set to arrivalUs
+    bool        binary = false;     // TopicLiveFrame from a binary frame
+    QStringList values;             // TopicParameterSet values, TopicEepromRow bytes
+    int         address = -1;       // TopicEepromRow
+    QString     addressText;        // TopicEepromRow, as the device sent it
+    bool        malformed = false;  // TopicUnknown: a LIVE: line that failed to parse
+};
+using BusMessagePtr = QSharedPointer<const BusMessage>;
+
+struct TopicStats {
+    quint64 published = 0;
+    quint64 deliveries = 0;     // one per subscriber and message
+    double  rateHz = 0.0;       // over the last full second
+    int     subscribers = 0;
+    double  handlerSumUs = 0;   // time spent in the subscribers
+    double  handlerMaxUs = 0;
+};
+
+// Routes received lines and frames by topic. Each line is classified and
+// parsed once; only the subscribers of its topic are called, directly and
+// in subscription order, with the same shared message. Lines of a topic
+// without subscribers are only counted, never parsed. Per topic it counts
+// messages, their rate and the time spent in the subscribers.
+class MessageBus : public QObject {
+    Q_OBJECT
+
+public:
+    using Handler = std::function<void(const BusMessagePtr &message)>;
+
+    explicit MessageBus(QObject *parent = nullptr);
+
+    // The handler runs until unsubscribe() or until receiver is destroyed
+    void subscribe(MessageTopic topic, QObject *receiver, const Handler &handler);
+    void unsubscribe(QObject *receiver);
+
+    void publishLine(const QString &line, qint64 arrivalUs);
+    void publishFrame(const LiveFrame &frame, qint64 arrivalUs);
+
+    const TopicStats &stats(int topic) const { return topics[topic].stats; }
+
+private:
+    struct Subscriber {
+        QPointer<QObject> receiver;
+        Handler handler;
+    };
+    struct Topic {
+        QVector<Subscriber> subscribers;
+        TopicStats stats;
+        qint64 windowStartNs = 0;
+        quint64 windowCount = 0;
+    };
+    bool hasSubscribers(MessageTopic topic) const { return !topics[topic].subscribers.isEmpty(); }
+    void count(MessageTopic topic);
+    void deliver(const QSharedPointer<BusMessage> &message);
+
+    Topic topics[TopicCount];
+    QElapsedTimer clock;
+};
+
+#endif // MESSAGEBUS_H
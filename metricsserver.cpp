@@ -0,0 +1,198 @@
+// metricsserver.cpp
+#include "metricsserver.h"
+#include "eventindex.h"
+#include <QTimer>
+
+void DeviceMetrics::addFrame(const LiveFrame &frame, qint64 latencyUs)
+{
+    static const LiveField fields[2][6] = {
+        {FieldFreq0, FieldBase0, FieldStd0, FieldOpen0, FieldShort0, FieldState0},
+        {FieldFreq1, FieldBase1, FieldStd1, FieldOpen1, FieldShort1, FieldState1}};
+    for (int loop = 0; loop < 2; ++loop) {
+        const LiveField *f = fields[loop];
+        freq[loop] = frame.value(f[0]);
+        base[loop] = frame.value(f[1]);
+        stddev[loop] = frame.value(f[2]);
+        open[loop] = frame.value(f[3]) != 0;
+        shorted[loop] = frame.value(f[4]) != 0;
+        const bool now = loopEventFlags(frame, loop + 1) & (1 << EventPresence);
+        if (now && !present[loop])
+            ++detections[loop];
+        present[loop] = now;
+    }
+    ++frames;
+    latencyLastUs = double(latencyUs);
+    latencyMaxUs = qMax(latencyMaxUs, latencyLastUs);
+    latencySumUs += latencyLastUs;
+}
+
+MetricsServer::MetricsServer(const FrameTiming *timing, const FrameDecoder *decoder,
+                             const MessageBus *bus, QObject *parent)
+    : QObject(parent), timing(timing), decoder(decoder), bus(bus)
+{
+    connect(&server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+bool MetricsServer::listen(quint16 port, const QHostAddress &address)
+{
+    server.close();
+    return server.listen(address, port);
+}
+
+void MetricsServer::setDevice(const QString &device)
+{
+    if (device == values.device)
+        return;
+    values = DeviceMetrics();
+    values.device = device;
+}
+
+void MetricsServer::close()
+{
+    server.close();
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (QTcpSocket *socket = server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { handleRequest(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        // A half-sent request must not hold the socket open forever
+        auto *idle = new QTimer(socket);
+        idle->setSingleShot(true);
+        connect(idle, &QTimer::timeout, socket, [socket]() {
+            socket->abort();
+            socket->deleteLater();
+        });
+        idle->start(requestTimeoutMs);
+    }
+}
+
+void MetricsServer::handleRequest(QTcpSocket *socket)
+{
+    // Only the request line matters; wait for the end of the headers
+    const QByteArray request = socket->peek(8192);
+    if (!request.contains("\r\n\r\n") && !request.contains("\n\n") && request.size() < 8192)
+        return;
+    socket->readAll();
+
+    const QList<QByteArray> parts = request.left(request.indexOf('\n')).trimmed().split(' ');
+    QByteArray status = "200 OK", body;
+    if (parts.size() < 2 || parts[0] != "GET") {
+        status = "405 Method Not Allowed";
+    } else if (parts[1] != "/metrics" && !parts[1].startsWith("/metrics?")) {
+        status = "404 Not Found";
+    } else {
+        ++scrapes;
+        body = render();
+    }
+    socket->write("HTTP/1.0 " + status + "\r\n"
+                  "Content-Type: text/plain; version=0.0.4\r\n"
+                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                  "Connection: close\r\n\r\n" + body);
+    socket->disconnectFromHost();
+}
+
+namespace {
+
+struct MetricWriter {
+    QByteArray &out;
+    QByteArray device;
+
+    void header(const char *name, const char *type, const char *help)
+    {
+        out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+        out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+    }
+    void value(const char *name, double v, int loop = 0)
+    {
+        out += name;
+        out += "{device=\"" + device + '"';
+        if (loop > 0)
+            out += ",loop=\"" + QByteArray::number(loop) + '"';
+        out += "} ";
+        out += QByteArray::number(v, 'g', 12);
+        out += '\n';
+    }
+    void perLoop(const char *name, const char *type, const char *help, const double v[2])
+    {
+        header(name, type, help);
+        value(name, v[0], 1);
+        value(name, v[1], 2);
+    }
+    template <typename Field>
+    void perTopic(const MessageBus *bus, const char *name, const char *type, const char *help,
+                  Field field)
+    {
+        header(name, type, help);
+        for (int t = 0; t < TopicCount; ++t) {
+            out += name;
+            out += "{device=\"" + device + "\",topic=\"" + messageTopicName(t).toUtf8() + "\"} ";
+            out += QByteArray::number(double(field(bus->stats(t))), 'g', 12);
+            out += '\n';
+        }
+    }
+};
+
+} // namespace
+
+QByteArray MetricsServer::render() const
+{
+    QByteArray out;
+    out.reserve(4096);
+    QByteArray device = values.device.toUtf8();
+    device.replace('\\', "\\\\").replace('"', "\\\"");
+    MetricWriter w{out, device.isEmpty() ? QByteArray("none") : device};
+
+    const double open[2] = {double(values.open[0]), double(values.open[1])};
+    const double shorted[2] = {double(values.shorted[0]), double(values.shorted[1])};
+    const double present[2] = {double(values.present[0]), double(values.present[1])};
+    const double detections[2] = {double(values.detections[0]), double(values.detections[1])};
+    w.perLoop("loop_frequency_hz", "gauge", "Current loop frequency.", values.freq);
+    w.perLoop("loop_baseline_hz", "gauge", "Baseline reported by the device.", values.base);
+    w.perLoop("loop_std_hz", "gauge", "Standard deviation reported by the device.", values.stddev);
+    w.perLoop("loop_open", "gauge", "1 while the device flags an open loop.", open);
+    w.perLoop("loop_short", "gauge", "1 while the device flags a shorted loop.", shorted);
+    w.perLoop("loop_presence", "gauge", "1 while a vehicle is detected.", present);
+    w.perLoop("loop_detections_total", "counter", "Detections (rising presence edges).", detections);
+
+    w.header("detector_frames_total", "counter", "LIVE frames handled.");
+    w.value("detector_frames_total", double(values.frames));
+    w.header("detector_parse_errors_total", "counter", "Malformed LIVE lines.");
+    w.value("detector_parse_errors_total", double(values.parseErrors));
+    w.header("detector_crc_errors_total", "counter", "Binary frames with a bad CRC.");
+    w.value("detector_crc_errors_total", double(decoder->crcErrors()));
+    w.header("detector_frame_rate_hz", "gauge", "Measured frame rate.");
+    w.value("detector_frame_rate_hz", timing->rateHz());
+    w.header("detector_frame_jitter_seconds", "gauge", "Std deviation of the frame interval.");
+    w.value("detector_frame_jitter_seconds", timing->jitterMs() / 1000.0);
+    w.header("detector_frame_gaps_total", "counter", "Gaps in the frame stream.");
+    w.value("detector_frame_gaps_total", double(timing->gaps()));
+    w.header("detector_lost_frames_total", "counter", "Frames missing by sequence number.");
+    w.value("detector_lost_frames_total", double(timing->lostFrames()));
+
+    w.header("pipeline_latency_seconds", "summary", "Chunk arrival to frame handled.");
+    w.value("pipeline_latency_seconds_sum", values.latencySumUs / 1e6);
+    w.value("pipeline_latency_seconds_count", double(values.frames));
+    w.header("pipeline_latency_last_seconds", "gauge", "Latency of the last frame.");
+    w.value("pipeline_latency_last_seconds", values.latencyLastUs / 1e6);
+    w.header("pipeline_latency_max_seconds", "gauge", "Largest latency seen.");
+    w.value("pipeline_latency_max_seconds", values.latencyMaxUs / 1e6);
+
+    w.perTopic(bus, "bus_messages_total", "counter", "Received messages by topic.",
+               [](const TopicStats &s) { return s.published; });
+    w.perTopic(bus, "bus_message_rate_hz", "gauge", "Messages per second by topic.",
+               [](const TopicStats &s) { return s.rateHz; });
+    w.perTopic(bus, "bus_subscribers", "gauge", "Subscribers by topic.",
+               [](const TopicStats &s) { return s.subscribers; });
+    w.perTopic(bus, "bus_handler_seconds_sum", "counter", "Time spent in the subscribers by topic.",
+               [](const TopicStats &s) { return s.handlerSumUs / 1e6; });
+    w.perTopic(bus, "bus_handler_calls_total", "counter", "Subscriber calls by topic.",
+               [](const TopicStats &s) { return s.deliveries; });
+    w.perTopic(bus, "bus_handler_max_seconds", "gauge", "Slowest subscriber call by topic.",
+               [](const TopicStats &s) { return s.handlerMaxUs / 1e6; });
+
+    w.header("metrics_scrapes_total", "counter", "Scrapes of this endpoint.");
+    w.value("metrics_scrapes_total", double(scrapes));
+    return out;
+}
@@ -0,0 +1,72 @@
+// metricsserver.h
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "liveframe.h"
+#include "frametiming.h"
+#include "framedecoder.h"
+#include "messagebus.h"
+
+// Values behind the metrics endpoint. addFrame() only stores numbers and
+// bumps counters; the text is built when a scrape comes in.
+struct DeviceMetrics {
+    QString device;             // port name, used as label
+    double  freq[2] = {};
+    double  base[2] = {};
+    double  stddev[2] = {};
+    bool    open[2] = {};
+    bool    shorted[2] = {};
+    bool    present[2] = {};
+    quint64 detections[2] = {}; // rising edges of the presence state
+    quint64 frames = 0;
+    quint64 parseErrors = 0;
+    double  latencyLastUs = 0;  // chunk arrival to frame handled
+    double  latencyMaxUs = 0;
+    double  latencySumUs = 0;
+
+    void addFrame(const LiveFrame &frame, qint64 latencyUs);
+};
+
+// Opt-in HTTP endpoint answering GET /metrics in the Prometheus text
+// exposition format. Frame timing, decoder and message bus counters are
+// read from their owners at scrape time. Listens on localhost unless
+// given a wider address; a connection that sends no complete request
+// within requestTimeoutMs is dropped.
+class MetricsServer : public QObject {
+    Q_OBJECT
+
+public:
+    MetricsServer(const FrameTiming *timing, const FrameDecoder *decoder,
+                  const MessageBus *bus, QObject *parent = nullptr);
+
+    bool listen(quint16 port, const QHostAddress &address = QHostAddress::LocalHost);
+    void close();
+    bool isListening() const { return server.isListening(); }
+    quint16 port() const { return server.serverPort(); }
+
+    DeviceMetrics &metrics() { return values; }
+    // A different device starts its counters from zero
+    void setDevice(const QString &device);
+
+private slots:
+    void onNewConnection();
+
+private:
+    void handleRequest(QTcpSocket *socket);
+    QByteArray render() const;
+
+    static const int requestTimeoutMs = 5000;
+
+    QTcpServer server;
+    DeviceMetrics values;
+    const FrameTiming  *timing;
+    const FrameDecoder *decoder;
+    const MessageBus   *bus;
+    quint64 scrapes = 0;
+};
+
+#endif // METRICSSERVER_H
@@ -10,41 +10,9 @@ ParametersDialog::ParametersDialog(QSerialPort *port, QWidget *parent)
     setWindowTitle(tr("Parameters"));
 
     // Define commands and their high limits
-    commands = {"sens1_low",
-                "sens1_medium",
-                "sens1_high",
-                "sens2_low",
-                "sens2_medium",
-                "sens2_high",
-                "open_loop1",
-                "open_loop2",
-                "short_loop1",
-                "short_loop2",
-                "boost_loop1",
-                "boost_loop2",
-                "output_polarity_auf1",
-                "output_polarity_auf2",
-                "output_polarity_zu",
-                "blanking_time",
-                "pulse_time",
-                "out_error_polarity",
-                "rnd_recal_enable",
-                "seq_reset_enable",
-                "seq_timeout_ms",
-                "mode3"};
+    commands = parameterNames();
     // corresponding high limits (booleans are 0–1, timeout up to e.g. 60000)
-    highLimits = QVector<int>({
-        65535, 65535, 65535,    // sens1
-        65535, 65535, 65535,    // sens2
-        65535, 65535,           // open loops
-        65535, 65535,           // short loops
-        65535, 65535,           // boosts
-        1,     1,               // auf polarities
-        1,     65535, 65535, 1, // zu / blank / pulse / error pol
-        1,     1,               // rnd_recal / seq_reset
-        65535,                  // seq_timeout_ms
-        1                       // mode3
-    });
+    highLimits = parameterLimits();
 
     int rows = commands.size();
     table = new QTableWidget(rows, 2, this);
@@ -88,10 +56,6 @@ ParametersDialog::ParametersDialog(QSerialPort *port, QWidget *parent)
     mainLayout->addWidget(table);
     mainLayout->addLayout(btnLayout);
 
-    // Subscribe to parameter lines
-    connect(parent, SIGNAL(serialLineReceived(QString)), this,
-            SLOT(onSerialLineReceived(QString)));
-
     for (int i = 0; i < rows; ++i) {
         auto *nameItem = new QTableWidgetItem(commands[i]);
         // Make parameter names read-only:
@@ -114,6 +78,46 @@ ParametersDialog::ParametersDialog(QSerialPort *port, QWidget *parent)
     originalValues.resize(commands.size());
 }
 
+QStringList ParametersDialog::parameterNames()
+{
+    return {"sens1_low",
+            "sens1_medium",
+            "sens1_high",
+            "sens2_low",
+            "sens2_medium",
+            "sens2_high",
+            "open_loop1",
+            "open_loop2",
+            "short_loop1",
+            "short_loop2",
+            "boost_loop1",
+            "boost_loop2",
+            "output_polarity_auf1",
+            "output_polarity_auf2",
+            "output_polarity_zu",
+            "blanking_time",
+            "pulse_time",
+            "out_error_polarity",
+            "rnd_recal_enable",
+            "seq_reset_enable",
+            "seq_timeout_ms",
+            "mode3"};
+}
+
+QVector<int> ParametersDialog::parameterLimits()
+{
+    return {65535, 65535, 65535,    // sens1
+            65535, 65535, 65535,    // sens2
+            65535, 65535,           // open loops
+            65535, 65535,           // short loops
+            65535, 65535,           // boosts
+            1,     1,               // auf polarities
+            1,     65535, 65535, 1, // zu / blank / pulse / error pol
+            1,     1,               // rnd_recal / seq_reset
+            65535,                  // seq_timeout_ms
+            1};                     // mode3
+}
+
 void ParametersDialog::onRefreshClicked() {
     if (serialPort->isOpen())
         serialPort->write("param\r\n");
@@ -163,17 +167,13 @@ void ParametersDialog::onCellChanged(int row, int column)
     QTimer::singleShot(50, this, &ParametersDialog::onRefreshClicked);
 }
 
-void ParametersDialog::onSerialLineReceived(const QString &line) {
-    if (!line.startsWith("PARAMETERS:")) return;
-    auto parts = line
-                     .mid(QString("PARAMETERS:").length())
-                     .split(',', Qt::SkipEmptyParts);
-    if (parts.size() != commands.size()) return;
+void ParametersDialog::setValues(const QStringList &values) {
+    if (values.size() != commands.size()) return;
 
     initializing = true;
-    for (int i = 0; i < parts.size(); ++i) {
-        table->item(i,1)->setText(parts[i]);
-        originalValues[i] = parts[i];    // <-- remember it
+    for (int i = 0; i < values.size(); ++i) {
+        table->item(i,1)->setText(values[i]);
+        originalValues[i] = values[i];    // <-- remember it
     }
     initializing = false;
 }
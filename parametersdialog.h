@@ -14,8 +14,13 @@ class ParametersDialog : public QDialog {
 public:
     explicit ParametersDialog(QSerialPort* port, QWidget* parent = nullptr);
 
+    // Parameter names in the order of the PARAMETERS: line
+    static QStringList parameterNames();
+    // Highest accepted value of each parameter, the lowest is 0
+    static QVector<int> parameterLimits();
+
 public slots:
-    void onSerialLineReceived(const QString &line);
+    void setValues(const QStringList &values);
     void onRefreshClicked();
 
 private slots:
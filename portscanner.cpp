@@ -0,0 +1,132 @@
+// portscanner.cpp
+#include "portscanner.h"
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QSerialPort>
+#include <QSerialPortInfo>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+
+static const int probeTimeoutMs = 250;
+static const int watchIntervalMs = 1000;
+
+// Runs on a pool thread: open, ask for the parameter line, wait briefly
+static bool probePort(const QString &portName, qint32 baudRate)
+{
+    QSerialPort port;
+    port.setPortName(portName);
+    port.setBaudRate(baudRate);
+    if (!port.open(QIODevice::ReadWrite))
+        return false;
+    port.clear();
+    port.write("param\r\n");
+    port.waitForBytesWritten(probeTimeoutMs);
+
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray reply;
+    while (timer.elapsed() < probeTimeoutMs) {
+        if (!port.waitForReadyRead(int(qMax<qint64>(1, probeTimeoutMs - timer.elapsed()))))
+            break;
+        reply += port.readAll();
+        if (reply.contains("PARAMETERS:") || reply.contains("LIVE:"))
+            return true;
+    }
+    return false;
+}
+
+static QString portKey(const QSerialPortInfo &info)
+{
+    return info.portName() + '|' + info.serialNumber();
+}
+
+PortScanner::PortScanner(QObject *parent) : QObject(parent)
+{
+    qRegisterMetaType<QList<PortCandidate>>("QList<PortCandidate>");
+    probePool.setMaxThreadCount(16);
+}
+
+void PortScanner::start()
+{
+    if (!watchTimer) {
+        watchTimer = new QTimer(this);
+        watchTimer->setInterval(watchIntervalMs);
+        connect(watchTimer, &QTimer::timeout, this, &PortScanner::poll);
+    }
+    scan(true);
+    watchTimer->start();
+}
+
+void PortScanner::rescan()
+{
+    detectorCache.clear();
+    scan(true);
+}
+
+void PortScanner::setBaudRate(qint32 baud)
+{
+    if (baud == baudRate)
+        return;
+    baudRate = baud;
+    detectorCache.clear();
+}
+
+void PortScanner::setExcludedPort(const QString &portName)
+{
+    excludedPort = portName;
+}
+
+void PortScanner::poll()
+{
+    scan(false);
+}
+
+void PortScanner::scan(bool force)
+{
+    const QList<QSerialPortInfo> infos = QSerialPortInfo::availablePorts();
+    QStringList keys;
+    for (const QSerialPortInfo &info : infos)
+        keys << portKey(info);
+    keys.sort();
+    if (!force && keys == lastKeys)
+        return;   // nothing plugged or unplugged
+    lastKeys = keys;
+
+    // Probe every port we have not seen before, all at once
+    QList<QPair<QString, QFuture<bool>>> probes;
+    for (const QSerialPortInfo &info : infos) {
+        const QString key = portKey(info);
+        if (detectorCache.contains(key) || info.portName() == excludedPort)
+            continue;
+        probes.append({key, QtConcurrent::run(&probePool, probePort, info.portName(), baudRate)});
+    }
+    for (auto &probe : probes)
+        detectorCache.insert(probe.first, probe.second.result());
+
+    // Drop cache entries of ports that went away
+    for (auto it = detectorCache.begin(); it != detectorCache.end();) {
+        if (keys.contains(it.key()))
+            ++it;
+        else
+            it = detectorCache.erase(it);
+    }
+
+    QList<PortCandidate> ports;
+    for (const QSerialPortInfo &info : infos) {
+        PortCandidate c;
+        c.portName = info.portName();
+        c.description = info.description().isEmpty() ? info.systemLocation()
+                                                     : info.description();
+        c.serialNumber = info.serialNumber();
+        c.isDetector = detectorCache.value(portKey(info), false);
+        ports.append(c);
+    }
+    // Detectors first, then by name
+    std::stable_sort(ports.begin(), ports.end(),
+                     [](const PortCandidate &a, const PortCandidate &b) {
+                         if (a.isDetector != b.isDetector)
+                             return a.isDetector;
+                         return a.portName < b.portName;
+                     });
+    emit portsChanged(ports);
+}
@@ -0,0 +1,51 @@
+// portscanner.h
+#ifndef PORTSCANNER_H
+#define PORTSCANNER_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+
+struct PortCandidate {
+    QString portName;
+    QString description;
+    QString serialNumber;
+    bool    isDetector = false;
+};
+
+// Enumerates serial ports and watches for hot-plug changes. Lives in a
+// worker thread; new ports are probed concurrently with a short "param"
+// handshake so that real loop detectors can be told apart.
+class PortScanner : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PortScanner(QObject *parent = nullptr);
+
+public slots:
+    void start();                                   // initial scan + watching
+    void rescan();                                  // forget cache, probe again
+    void setBaudRate(qint32 baud);
+    void setExcludedPort(const QString &portName);  // never probe our own port
+
+signals:
+    void portsChanged(const QList<PortCandidate> &ports);
+
+private slots:
+    void poll();
+
+private:
+    void scan(bool force);
+
+    QTimer      *watchTimer = nullptr;
+    QThreadPool  probePool;
+    qint32       baudRate = 921600;
+    QString      excludedPort;
+    QStringList  lastKeys;                 // port name + serial of last scan
+    QHash<QString, bool> detectorCache;   // key -> answered the handshake
+};
+
+#endif // PORTSCANNER_H
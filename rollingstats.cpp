@@ -0,0 +1,188 @@
+// rollingstats.cpp
+#include "rollingstats.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+P2Quantile::P2Quantile(double p) : p(p) { reset(); }
+
+void P2Quantile::reset()
+{
+    count = 0;
+    for (int i = 0; i < 5; ++i) {
+        q[i] = 0.0;
+        n[i] = i;
+    }
+    np[0] = 0;  np[1] = 2 * p;  np[2] = 4 * p;  np[3] = 2 + 2 * p;  np[4] = 4;
+    dn[0] = 0;  dn[1] = p / 2;  dn[2] = p;      dn[3] = (1 + p) / 2; dn[4] = 1;
+}
+
+void P2Quantile::add(double x)
+{
+    // Collect the first five samples verbatim
+    if (count < 5) {
+        q[count++] = x;
+        if (count == 5)
+            std::sort(q, q + 5);
+        return;
+    }
+
+    // Find the cell k with q[k] <= x < q[k+1], extending the extremes
+    int k;
+    if (x < q[0]) {
+        q[0] = x;
+        k = 0;
+    } else if (x >= q[4]) {
+        q[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= q[k + 1])
+            ++k;
+    }
+    for (int i = k + 1; i < 5; ++i)
+        n[i] += 1;
+    for (int i = 0; i < 5; ++i)
+        np[i] += dn[i];
+
+    // Nudge the three inner markers towards their desired positions
+    for (int i = 1; i <= 3; ++i) {
+        double d = np[i] - n[i];
+        if ((d >= 1 && n[i + 1] - n[i] > 1) || (d <= -1 && n[i - 1] - n[i] < -1)) {
+            int s = d >= 0 ? 1 : -1;
+            double qp = parabolic(i, s);
+            q[i] = (q[i - 1] < qp && qp < q[i + 1]) ? qp : linear(i, s);
+            n[i] += s;
+        }
+    }
+    ++count;
+}
+
+double P2Quantile::parabolic(int i, int d) const
+{
+    return q[i] + d / (n[i + 1] - n[i - 1])
+                      * ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i])
+                         + (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+double P2Quantile::linear(int i, int d) const
+{
+    return q[i] + d * (q[i + d] - q[i]) / (n[i + d] - n[i]);
+}
+
+double P2Quantile::value() const
+{
+    if (count == 0)
+        return kNaN;
+    if (count < 5) {
+        double tmp[5];
+        std::copy(q, q + count, tmp);
+        std::sort(tmp, tmp + count);
+        return tmp[qRound(p * (count - 1))];
+    }
+    return q[2];
+}
+
+RollingStats::RollingStats()
+    : windowUs(10 * 1000000LL), alpha(0.1), q05(0.05), q50(0.5), q95(0.95)
+{
+    reset();
+}
+
+void RollingStats::setWindow(qint64 us)
+{
+    windowUs = qMax<qint64>(1, us);
+    if (!minQueue.empty())
+        expire(minQueue.back().t);
+}
+
+void RollingStats::setEwmaAlpha(double a) { alpha = qBound(0.0, a, 1.0); }
+
+void RollingStats::reset()
+{
+    n = 0;
+    avg = 0.0;
+    m2 = 0.0;
+    lastValue = kNaN;
+    ewmaValue = kNaN;
+    minQueue.clear();
+    maxQueue.clear();
+    q05.reset();
+    q50.reset();
+    q95.reset();
+}
+
+void RollingStats::add(double x, qint64 timeUs)
+{
+    if (!std::isfinite(x))
+        return;
+
+    ++n;
+    double delta = x - avg;
+    avg += delta / n;
+    m2 += delta * (x - avg);
+
+    lastValue = x;
+    ewmaValue = (n == 1) ? x : ewmaValue + alpha * (x - ewmaValue);
+
+    while (!minQueue.empty() && minQueue.back().v >= x)
+        minQueue.pop_back();
+    minQueue.push_back({timeUs, x});
+    while (!maxQueue.empty() && maxQueue.back().v <= x)
+        maxQueue.pop_back();
+    maxQueue.push_back({timeUs, x});
+    expire(timeUs);
+
+    q05.add(x);
+    q50.add(x);
+    q95.add(x);
+}
+
+void RollingStats::expire(qint64 now)
+{
+    const qint64 oldest = now - windowUs;
+    while (minQueue.size() > 1 && minQueue.front().t < oldest)
+        minQueue.pop_front();
+    while (maxQueue.size() > 1 && maxQueue.front().t < oldest)
+        maxQueue.pop_front();
+}
+
+double RollingStats::stddev() const { return std::sqrt(variance()); }
+
+double RollingStats::windowMin() const
+{
+    return minQueue.empty() ? kNaN : minQueue.front().v;
+}
+
+double RollingStats::windowMax() const
+{
+    return maxQueue.empty() ? kNaN : maxQueue.front().v;
+}
+
+void LiveStatistics::setWindow(qint64 windowUs)
+{
+    for (auto &f : fields)
+        f.setWindow(windowUs);
+}
+
+void LiveStatistics::setEwmaAlpha(double alpha)
+{
+    for (auto &f : fields)
+        f.setEwmaAlpha(alpha);
+}
+
+void LiveStatistics::reset()
+{
+    for (auto &f : fields)
+        f.reset();
+}
+
+void LiveStatistics::addFrame(const LiveFrame &frame)
+{
+    for (int i = 0; i < LiveFieldCount; ++i) {
+        if (frame.isValid(LiveField(i)))
+            fields[i].add(frame.values[i], frame.hostTimeUs);
+    }
+}
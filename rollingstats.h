@@ -0,0 +1,92 @@
+// rollingstats.h
+#ifndef ROLLINGSTATS_H
+#define ROLLINGSTATS_H
+
+#include <QtGlobal>
+#include <deque>
+
+#include "liveframe.h"
+
+// Streaming quantile estimate (P² algorithm, Jain & Chlamtac 1985).
+// Five markers, constant memory and O(1) per sample.
+class P2Quantile {
+public:
+    explicit P2Quantile(double p = 0.5);
+    void reset();
+    void add(double x);
+    double value() const;
+
+private:
+    double parabolic(int i, int d) const;
+    double linear(int i, int d) const;
+
+    double p;
+    qint64 count;
+    double q[5];     // marker heights
+    double n[5];     // marker positions
+    double np[5];    // desired positions
+    double dn[5];    // desired position increments
+};
+
+// Running statistics of one numeric series. Every add() is O(1)
+// (amortized for the window min/max), independent of the history length.
+class RollingStats {
+public:
+    RollingStats();
+
+    void setWindow(qint64 windowUs);
+    void setEwmaAlpha(double alpha);
+    void reset();
+    void add(double x, qint64 timeUs);
+
+    qint64 count() const { return n; }
+    double last() const { return lastValue; }
+    double mean() const { return avg; }
+    double variance() const { return n > 1 ? m2 / (n - 1) : 0.0; }
+    double stddev() const;
+    double ewma() const { return ewmaValue; }
+    double windowMin() const;
+    double windowMax() const;
+    double p05() const { return q05.value(); }
+    double p50() const { return q50.value(); }
+    double p95() const { return q95.value(); }
+
+private:
+    struct Sample { qint64 t; double v; };
+    void expire(qint64 now);
+
+    qint64 windowUs;
+    double alpha;
+
+    // Welford
+    qint64 n;
+    double avg;
+    double m2;
+
+    double lastValue;
+    double ewmaValue;
+
+    // Monotonic deques: front holds the min (max) of the time window
+    std::deque<Sample> minQueue;
+    std::deque<Sample> maxQueue;
+
+    P2Quantile q05;
+    P2Quantile q50;
+    P2Quantile q95;
+};
+
+// One RollingStats per LIVE field, fed frame by frame
+class LiveStatistics {
+public:
+    void setWindow(qint64 windowUs);
+    void setEwmaAlpha(double alpha);
+    void reset();
+    void addFrame(const LiveFrame &frame);
+
+    const RollingStats &field(int index) const { return fields[index]; }
+
+private:
+    RollingStats fields[LiveFieldCount];
+};
+
+#endif // ROLLINGSTATS_H
@@ -0,0 +1,464 @@
+// samplestore.cpp
+#include "samplestore.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+class BitWriter {
+public:
+    explicit BitWriter(QByteArray &out) : out(out) {}
+
+    // Append the low n bits of v, most significant first
+    void write(quint64 v, int n)
+    {
+        while (n > 0) {
+            if (bitPos == 0)
+                out.append('\0');
+            const int space = 8 - bitPos;
+            const int take = qMin(space, n);
+            const quint8 chunk = quint8((v >> (n - take)) & ((1u << take) - 1));
+            out.data()[out.size() - 1] |= char(chunk << (space - take));
+            bitPos = (bitPos + take) & 7;
+            n -= take;
+        }
+    }
+
+private:
+    QByteArray &out;
+    int bitPos = 0;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const QByteArray &in)
+        : data(reinterpret_cast<const quint8 *>(in.constData())), size(in.size()) {}
+
+    quint64 read(int n)
+    {
+        quint64 v = 0;
+        while (n > 0 && pos < size) {
+            const int space = 8 - bitPos;
+            const int take = qMin(space, n);
+            const quint8 chunk = quint8((data[pos] >> (space - take)) & ((1u << take) - 1));
+            v = (v << take) | chunk;
+            bitPos += take;
+            if (bitPos == 8) {
+                bitPos = 0;
+                ++pos;
+            }
+            n -= take;
+        }
+        return v;
+    }
+
+    qint64 readSigned(int n)
+    {
+        quint64 v = read(n);
+        if (v & (quint64(1) << (n - 1)))
+            v |= ~((quint64(1) << n) - 1);
+        return qint64(v);
+    }
+
+private:
+    const quint8 *data;
+    qsizetype size;
+    qsizetype pos = 0;
+    int bitPos = 0;
+};
+
+quint64 toBits(double v)
+{
+    quint64 b;
+    std::memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+double fromBits(quint64 b)
+{
+    double v;
+    std::memcpy(&v, &b, sizeof(v));
+    return v;
+}
+
+// Delta-of-delta buckets: prefix bits and payload width
+struct DodBucket { quint64 prefix; int prefixBits; int valueBits; };
+const DodBucket dodBuckets[] = {
+    {0x2, 2, 7},      // 10
+    {0x6, 3, 9},      // 110
+    {0xE, 4, 12},     // 1110
+    {0x1E, 5, 20},    // 11110
+};
+
+void writeDod(BitWriter &w, qint64 dod)
+{
+    if (dod == 0) {
+        w.write(0, 1);
+        return;
+    }
+    for (const DodBucket &b : dodBuckets) {
+        const qint64 lim = qint64(1) << (b.valueBits - 1);
+        if (dod >= -lim && dod < lim) {
+            w.write(b.prefix, b.prefixBits);
+            w.write(quint64(dod), b.valueBits);
+            return;
+        }
+    }
+    w.write(0x1F, 5);   // 11111
+    w.write(quint64(dod), 64);
+}
+
+qint64 readDod(BitReader &r)
+{
+    if (r.read(1) == 0)
+        return 0;
+    // Count the remaining 1 bits of the prefix
+    int ones = 1;
+    while (ones < 5 && r.read(1) == 1)
+        ++ones;
+    switch (ones) {
+    case 1: return r.readSigned(7);
+    case 2: return r.readSigned(9);
+    case 3: return r.readSigned(12);
+    case 4: return r.readSigned(20);
+    default: return qint64(r.read(64));
+    }
+}
+
+} // namespace
+
+SampleStore::SampleStore() : sealedCount(0)
+{
+    blockSumPrefix.append(0.0);
+    headTimes.reserve(blockSize);
+    headValues.reserve(blockSize);
+}
+
+void SampleStore::clear()
+{
+    blocks.clear();
+    blockSumPrefix = {0.0};
+    blockMin.clear();
+    blockMax.clear();
+    sealedCount = 0;
+    headTimes.clear();
+    headValues.clear();
+    headTimes.reserve(blockSize);
+    headValues.reserve(blockSize);
+    cache[0].block = cache[1].block = -1;
+}
+
+void SampleStore::append(qint64 timeUs, double value)
+{
+    headTimes.append(timeUs);
+    headValues.append(value);
+    if (headValues.size() == blockSize)
+        seal();
+}
+
+void SampleStore::seal()
+{
+    Block b;
+    b.data = encode(headTimes, headValues);
+    b.data.squeeze();
+    b.firstTimeUs = headTimes.first();
+    b.lastTimeUs = headTimes.last();
+    b.minValue = b.maxValue = headValues.first();
+    b.sum = 0.0;
+    for (double v : headValues) {
+        b.minValue = qMin(b.minValue, v);
+        b.maxValue = qMax(b.maxValue, v);
+        b.sum += v;
+    }
+    sealedCount += int(headValues.size());
+    addSummary(b);
+    headTimes.clear();
+    headValues.clear();
+}
+
+void SampleStore::appendBlock(const Block &b)
+{
+    Q_ASSERT(headValues.isEmpty());
+    sealedCount += blockSize;
+    addSummary(b);
+}
+
+void SampleStore::addSummary(const Block &b)
+{
+    blocks.append(b);
+
+    // The new block ends one more range on every level of the sparse table
+    blockSumPrefix.append(blockSumPrefix.last() + b.sum);
+    const int n = int(blocks.size());
+    if (blockMin.isEmpty()) {
+        blockMin.append(QVector<double>());
+        blockMax.append(QVector<double>());
+    }
+    blockMin[0].append(b.minValue);
+    blockMax[0].append(b.maxValue);
+    for (int k = 1; (1 << k) <= n; ++k) {
+        if (blockMin.size() <= k) {
+            blockMin.append(QVector<double>());
+            blockMax.append(QVector<double>());
+        }
+        const int i = n - (1 << k);
+        const int half = 1 << (k - 1);
+        blockMin[k].append(qMin(blockMin[k - 1][i], blockMin[k - 1][i + half]));
+        blockMax[k].append(qMax(blockMax[k - 1][i], blockMax[k - 1][i + half]));
+    }
+}
+
+QByteArray SampleStore::encode(const QVector<qint64> &times, const QVector<double> &values)
+{
+    QByteArray out;
+    BitWriter w(out);
+    w.write(quint64(times[0]), 64);
+    w.write(toBits(values[0]), 64);
+
+    qint64 prevTime = times[0];
+    qint64 prevDelta = 0;
+    quint64 prevBits = toBits(values[0]);
+    int prevLead = -1;
+    int prevTrail = 0;
+
+    for (int i = 1; i < values.size(); ++i) {
+        const qint64 delta = times[i] - prevTime;
+        writeDod(w, delta - prevDelta);
+        prevDelta = delta;
+        prevTime = times[i];
+
+        const quint64 bits = toBits(values[i]);
+        const quint64 x = bits ^ prevBits;
+        prevBits = bits;
+        if (x == 0) {
+            w.write(0, 1);
+            continue;
+        }
+        const int lead = qMin(31, int(qCountLeadingZeroBits(x)));
+        const int trail = int(qCountTrailingZeroBits(x));
+        if (prevLead >= 0 && lead >= prevLead && trail >= prevTrail) {
+            // Fits inside the previous meaningful-bit window
+            w.write(0x2, 2);
+            w.write(x >> prevTrail, 64 - prevLead - prevTrail);
+        } else {
+            const int meaningful = 64 - lead - trail;
+            w.write(0x3, 2);
+            w.write(quint64(lead), 5);
+            w.write(quint64(meaningful & 63), 6);     // 64 is stored as 0
+            w.write(x >> trail, meaningful);
+            prevLead = lead;
+            prevTrail = trail;
+        }
+    }
+    return out;
+}
+
+void SampleStore::decode(const QByteArray &data, int count,
+                         QVector<qint64> &times, QVector<double> &values)
+{
+    times.resize(count);
+    values.resize(count);
+    BitReader r(data);
+    qint64 prevTime = qint64(r.read(64));
+    quint64 prevBits = r.read(64);
+    times[0] = prevTime;
+    values[0] = fromBits(prevBits);
+
+    qint64 prevDelta = 0;
+    int prevLead = 0;
+    int prevTrail = 0;
+    for (int i = 1; i < count; ++i) {
+        prevDelta += readDod(r);
+        prevTime += prevDelta;
+        times[i] = prevTime;
+
+        if (r.read(1) != 0) {
+            quint64 x;
+            if (r.read(1) == 0) {
+                x = r.read(64 - prevLead - prevTrail) << prevTrail;
+            } else {
+                prevLead = int(r.read(5));
+                int meaningful = int(r.read(6));
+                if (meaningful == 0)
+                    meaningful = 64;
+                prevTrail = 64 - prevLead - meaningful;
+                x = r.read(meaningful) << prevTrail;
+            }
+            prevBits ^= x;
+        }
+        values[i] = fromBits(prevBits);
+    }
+}
+
+const SampleStore::Decoded &SampleStore::decoded(int block) const
+{
+    for (const Decoded &d : cache) {
+        if (d.block == block)
+            return d;
+    }
+    Decoded &d = cache[cacheNext];
+    cacheNext ^= 1;
+    decode(blocks[block].data, blockSize, d.times, d.values);
+    d.block = block;
+    return d;
+}
+
+double SampleStore::value(int i) const
+{
+    if (i >= sealedCount)
+        return headValues[i - sealedCount];
+    return decoded(i / blockSize).values[i % blockSize];
+}
+
+qint64 SampleStore::timeUs(int i) const
+{
+    if (i >= sealedCount)
+        return headTimes[i - sealedCount];
+    return decoded(i / blockSize).times[i % blockSize];
+}
+
+qint64 SampleStore::lastTimeUs() const
+{
+    if (!headTimes.isEmpty())
+        return headTimes.last();
+    return blocks.isEmpty() ? 0 : blocks.last().lastTimeUs;
+}
+
+int SampleStore::lowerBoundTime(qint64 t) const
+{
+    // First block whose last timestamp reaches t, then search inside it
+    auto it = std::lower_bound(blocks.cbegin(), blocks.cend(), t,
+                               [](const Block &b, qint64 v) { return b.lastTimeUs < v; });
+    if (it != blocks.cend()) {
+        const int b = int(it - blocks.cbegin());
+        const Decoded &d = decoded(b);
+        return b * blockSize
+               + int(std::lower_bound(d.times.cbegin(), d.times.cend(), t) - d.times.cbegin());
+    }
+    return sealedCount
+           + int(std::lower_bound(headTimes.cbegin(), headTimes.cend(), t) - headTimes.cbegin());
+}
+
+int SampleStore::upperBoundTime(qint64 t) const
+{
+    auto it = std::upper_bound(blocks.cbegin(), blocks.cend(), t,
+                               [](qint64 v, const Block &b) { return v < b.lastTimeUs; });
+    if (it != blocks.cend()) {
+        const int b = int(it - blocks.cbegin());
+        const Decoded &d = decoded(b);
+        return b * blockSize
+               + int(std::upper_bound(d.times.cbegin(), d.times.cend(), t) - d.times.cbegin());
+    }
+    return sealedCount
+           + int(std::upper_bound(headTimes.cbegin(), headTimes.cend(), t) - headTimes.cbegin());
+}
+
+void SampleStore::read(int first, int last, QVector<qint64> *times, QVector<double> *values) const
+{
+    first = qMax(0, first);
+    last = qMin(size(), last);
+    if (times) {
+        times->clear();
+        times->reserve(qMax(0, last - first));
+    }
+    if (values) {
+        values->clear();
+        values->reserve(qMax(0, last - first));
+    }
+    int i = first;
+    while (i < last) {
+        if (i >= sealedCount) {
+            const int from = i - sealedCount;
+            const int to = last - sealedCount;
+            if (times)
+                times->append(headTimes.mid(from, to - from));
+            if (values)
+                values->append(headValues.mid(from, to - from));
+            break;
+        }
+        const int b = i / blockSize;
+        const int from = i % blockSize;
+        const int to = qMin(blockSize, last - b * blockSize);
+        const Decoded &d = decoded(b);
+        if (times)
+            times->append(d.times.mid(from, to - from));
+        if (values)
+            values->append(d.values.mid(from, to - from));
+        i = b * blockSize + to;
+    }
+}
+
+// Walk over [first, last) block by block, decoding partial ones
+void SampleStore::scan(int first, int last, double &min, double &max, double &sum) const
+{
+    int i = first;
+    while (i < last) {
+        if (i >= sealedCount) {
+            for (int k = i - sealedCount; k < last - sealedCount; ++k) {
+                const double v = headValues[k];
+                min = qMin(min, v);
+                max = qMax(max, v);
+                sum += v;
+            }
+            break;
+        }
+        const int b = i / blockSize;
+        const int from = i % blockSize;
+        const int to = qMin(blockSize, last - b * blockSize);
+        if (from == 0 && to == blockSize) {
+            const Block &blk = blocks[b];
+            min = qMin(min, blk.minValue);
+            max = qMax(max, blk.maxValue);
+            sum += blk.sum;
+        } else {
+            const Decoded &d = decoded(b);
+            for (int k = from; k < to; ++k) {
+                const double v = d.values[k];
+                min = qMin(min, v);
+                max = qMax(max, v);
+                sum += v;
+            }
+        }
+        i = b * blockSize + to;
+    }
+}
+
+void SampleStore::summarize(int first, int last, double &min, double &max, double &sum) const
+{
+    first = qMax(0, first);
+    last = qMin(size(), last);
+    min = std::numeric_limits<double>::infinity();
+    max = -std::numeric_limits<double>::infinity();
+    sum = 0.0;
+
+    // Sealed blocks lying completely inside the range
+    const int fromBlock = (first + blockSize - 1) / blockSize;
+    const int toBlock = qMin(last, sealedCount) / blockSize;
+    if (fromBlock >= toBlock) {
+        scan(first, last, min, max, sum);
+        return;
+    }
+    scan(first, fromBlock * blockSize, min, max, sum);
+    sum += blockSumPrefix[toBlock] - blockSumPrefix[fromBlock];
+    int k = 0;
+    while ((2 << k) <= toBlock - fromBlock)
+        ++k;
+    min = qMin(min, qMin(blockMin[k][fromBlock], blockMin[k][toBlock - (1 << k)]));
+    max = qMax(max, qMax(blockMax[k][fromBlock], blockMax[k][toBlock - (1 << k)]));
+    scan(toBlock * blockSize, last, min, max, sum);
+}
+
+qint64 SampleStore::memoryBytes() const
+{
+    qint64 bytes = qint64(blocks.capacity()) * sizeof(Block);
+    for (const Block &b : blocks)
+        bytes += b.data.capacity();
+    bytes += qint64(headTimes.capacity()) * sizeof(qint64);
+    bytes += qint64(headValues.capacity()) * sizeof(double);
+    bytes += qint64(blockSumPrefix.capacity()) * sizeof(double);
+    for (int k = 0; k < blockMin.size(); ++k)
+        bytes += qint64(blockMin[k].capacity() + blockMax[k].capacity()) * sizeof(double);
+    return bytes;
+}
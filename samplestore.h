@@ -0,0 +1,87 @@
+// samplestore.h
+#ifndef SAMPLESTORE_H
+#define SAMPLESTORE_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QtGlobal>
+
+// Compressed (time, value) history. Samples are kept raw until a block of
+// blockSize is full, then sealed with Gorilla style encoding: timestamps
+// as delta-of-delta, values as XOR against the previous value. Sealed
+// blocks carry a small summary (time span, min/max/sum) so range queries
+// can skip decoding whole blocks. Typical loop data packs into a few
+// bytes per sample.
+class SampleStore {
+public:
+    static const int blockSize = 1024;
+
+    SampleStore();
+
+    void clear();
+    void append(qint64 timeUs, double value);
+
+    int size() const { return sealedCount + int(headValues.size()); }
+    bool isEmpty() const { return size() == 0; }
+    double value(int i) const;
+    qint64 timeUs(int i) const;
+    qint64 lastTimeUs() const;
+
+    // First sample with time >= t / > t (timestamps must be non-decreasing)
+    int lowerBoundTime(qint64 t) const;
+    int upperBoundTime(qint64 t) const;
+
+    // Decode samples [first, last); either output may be null
+    void read(int first, int last, QVector<qint64> *times, QVector<double> *values) const;
+    // Min/max/sum of values in [first, last). Whole blocks are answered in
+    // O(1) from a prefix sum and a sparse table over the block summaries;
+    // at most the two partial blocks at the ends are decoded.
+    void summarize(int first, int last, double &min, double &max, double &sum) const;
+
+    qint64 memoryBytes() const;
+
+    // A sealed block never changes, so snapshots only copy new ones
+    struct Block {
+        QByteArray data;
+        qint64 firstTimeUs;
+        qint64 lastTimeUs;
+        double minValue;
+        double maxValue;
+        double sum;
+    };
+    int blockCount() const { return int(blocks.size()); }
+    const Block &block(int b) const { return blocks[b]; }
+    // Add an already encoded block of blockSize samples; only valid
+    // while no samples are waiting in the open block
+    void appendBlock(const Block &b);
+
+private:
+    struct Decoded {
+        int block = -1;
+        QVector<qint64> times;
+        QVector<double> values;
+    };
+
+    void seal();
+    void addSummary(const Block &b);
+    void scan(int first, int last, double &min, double &max, double &sum) const;
+    const Decoded &decoded(int block) const;
+    static QByteArray encode(const QVector<qint64> &times, const QVector<double> &values);
+    static void decode(const QByteArray &data, int count, QVector<qint64> &times, QVector<double> &values);
+
+    QVector<Block> blocks;
+    // blockSumPrefix[b]: sum of blocks [0, b). blockMin[k][b] / blockMax[k][b]:
+    // min / max of blocks [b, b + 2^k)
+    QVector<double> blockSumPrefix;
+    QList<QVector<double>> blockMin;
+    QList<QVector<double>> blockMax;
+    int sealedCount;
+    QVector<qint64> headTimes;      // open block, not yet compressed
+    QVector<double> headValues;
+
+    // Two most recently decoded blocks
+    mutable Decoded cache[2];
+    mutable int cacheNext = 0;
+};
+
+#endif // SAMPLESTORE_H
@@ -0,0 +1,255 @@
+// scriptdialog.cpp
+#include "scriptdialog.h"
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QSerialPortInfo>
+#include <QTextStream>
+#include <QVBoxLayout>
+
+static const char *const exampleScript =
+    "// Runs once per selected port; 'portName' holds the port.\n"
+    "device.open(portName);\n"
+    "device.send(\"led_test\");\n"
+    "device.sleep(2000);\n"
+    "device.send(\"cal1\");\n"
+    "device.send(\"cal2\");\n"
+    "// Wait for the calibration to start, then for it to end\n"
+    "device.waitFor(\"cal0\", \"!=\", 0, 2000);\n"
+    "device.waitFor(\"cal1\", \"!=\", 0, 2000);\n"
+    "device.waitFor(\"cal0\", \"==\", 0, 10000);\n"
+    "device.waitFor(\"cal1\", \"==\", 0, 10000);\n"
+    "device.setParam(\"sens1_medium\", 20);\n"
+    "device.send(\"save\");\n"
+    "device.log(\"Drive a vehicle over loop 1\");\n"
+    "if (!device.waitFor(\"state0\", \"!=\", 0, 60000))\n"
+    "    throw new Error(\"no vehicle detected on loop 1\");\n"
+    "device.close();\n";
+
+enum ReportColumn { ColPort, ColStep, ColResult, ColTime, ColDetail, ReportColumnCount };
+
+ScriptDialog::ScriptDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Scripts"));
+
+    editor = new QPlainTextEdit(this);
+    editor->setFont(QFont("Monospace"));
+    editor->setPlainText(exampleScript);
+
+    portList = new QListWidget(this);
+
+    report = new QTableWidget(0, ReportColumnCount, this);
+    report->setHorizontalHeaderLabels({tr("Port"), tr("Step"), tr("Result"),
+                                       tr("Time (ms)"), tr("Detail")});
+    report->verticalHeader()->setVisible(false);
+    report->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    report->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    summaryLabel = new QLabel(this);
+
+    openBtn = new QPushButton(tr("Open..."), this);
+    saveBtn = new QPushButton(tr("Save..."), this);
+    refreshBtn = new QPushButton(tr("Refresh Ports"), this);
+    runBtn = new QPushButton(tr("Run"), this);
+    stopBtn = new QPushButton(tr("Stop"), this);
+    exportBtn = new QPushButton(tr("Export Report..."), this);
+    connect(openBtn, &QPushButton::clicked, this, &ScriptDialog::onOpenClicked);
+    connect(saveBtn, &QPushButton::clicked, this, &ScriptDialog::onSaveClicked);
+    connect(refreshBtn, &QPushButton::clicked, this, &ScriptDialog::onRefreshPortsClicked);
+    connect(runBtn, &QPushButton::clicked, this, &ScriptDialog::onRunClicked);
+    connect(stopBtn, &QPushButton::clicked, this, &ScriptDialog::onStopClicked);
+    connect(exportBtn, &QPushButton::clicked, this, &ScriptDialog::onExportClicked);
+
+    auto *portLayout = new QVBoxLayout;
+    portLayout->addWidget(new QLabel(tr("Run on:"), this));
+    portLayout->addWidget(portList);
+    portLayout->addWidget(refreshBtn);
+
+    auto *topLayout = new QHBoxLayout;
+    topLayout->addWidget(editor, 3);
+    topLayout->addLayout(portLayout, 1);
+
+    auto *btnLayout = new QHBoxLayout;
+    btnLayout->addWidget(openBtn);
+    btnLayout->addWidget(saveBtn);
+    btnLayout->addWidget(summaryLabel);
+    btnLayout->addStretch();
+    btnLayout->addWidget(exportBtn);
+    btnLayout->addWidget(runBtn);
+    btnLayout->addWidget(stopBtn);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(topLayout, 1);
+    mainLayout->addWidget(report, 1);
+    mainLayout->addLayout(btnLayout);
+
+    setMinimumSize(1000, 700);
+
+    onRefreshPortsClicked();
+    updateButtons();
+}
+
+ScriptDialog::~ScriptDialog()
+{
+    for (ScriptRunner *runner : runners) {
+        runner->stop();
+        runner->wait();
+    }
+}
+
+void ScriptDialog::updateButtons()
+{
+    const bool running = !runners.isEmpty();
+    runBtn->setEnabled(!running);
+    stopBtn->setEnabled(running);
+    openBtn->setEnabled(!running);
+    editor->setReadOnly(running);
+}
+
+void ScriptDialog::onOpenClicked()
+{
+    QString fn = QFileDialog::getOpenFileName(this, tr("Open Script"), QString(),
+                                              tr("Scripts (*.js)"));
+    if (fn.isEmpty())
+        return;
+    QFile f(fn);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        summaryLabel->setText(tr("Failed to open file: %1").arg(fn));
+        return;
+    }
+    editor->setPlainText(QTextStream(&f).readAll());
+}
+
+void ScriptDialog::onSaveClicked()
+{
+    QString fn = QFileDialog::getSaveFileName(this, tr("Save Script"), QString(),
+                                              tr("Scripts (*.js)"));
+    if (fn.isEmpty())
+        return;
+    QFile f(fn);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        summaryLabel->setText(tr("Failed to open file: %1").arg(fn));
+        return;
+    }
+    QTextStream(&f) << editor->toPlainText();
+}
+
+void ScriptDialog::onRefreshPortsClicked()
+{
+    QStringList checked;
+    for (int i = 0; i < portList->count(); ++i) {
+        if (portList->item(i)->checkState() == Qt::Checked)
+            checked << portList->item(i)->data(Qt::UserRole).toString();
+    }
+    portList->clear();
+    for (const QSerialPortInfo &info : QSerialPortInfo::availablePorts()) {
+        auto *item = new QListWidgetItem(QString("%1 (%2)").arg(info.portName(), info.description()),
+                                         portList);
+        item->setData(Qt::UserRole, info.portName());
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(checked.contains(info.portName()) ? Qt::Checked : Qt::Unchecked);
+    }
+}
+
+void ScriptDialog::onRunClicked()
+{
+    QStringList ports;
+    for (int i = 0; i < portList->count(); ++i) {
+        if (portList->item(i)->checkState() == Qt::Checked)
+            ports << portList->item(i)->data(Qt::UserRole).toString();
+    }
+    if (ports.isEmpty()) {
+        summaryLabel->setText(tr("No port selected!"));
+        return;
+    }
+
+    report->setRowCount(0);
+    passed = failed = 0;
+    summaryLabel->setText(tr("Running on %n device(s)...", nullptr, ports.size()));
+
+    // One thread per device; steps are reported back through queued signals
+    const QString script = editor->toPlainText();
+    for (const QString &port : ports) {
+        auto *runner = new ScriptRunner(script, port, baudRate, this);
+        connect(runner, &ScriptRunner::stepFinished, this, &ScriptDialog::onStepFinished);
+        connect(runner, &ScriptRunner::scriptFinished, this, &ScriptDialog::onScriptFinished);
+        connect(runner, &QThread::finished, this, [this, runner]() {
+            runners.removeOne(runner);
+            runner->deleteLater();
+            updateButtons();
+        });
+        runners.append(runner);
+        runner->start();
+    }
+    updateButtons();
+}
+
+void ScriptDialog::onStopClicked()
+{
+    for (ScriptRunner *runner : runners)
+        runner->stop();
+}
+
+void ScriptDialog::addReportRow(const QString &port, const QString &step, bool ok,
+                                double elapsedMs, const QString &detail)
+{
+    const int row = report->rowCount();
+    report->insertRow(row);
+    const QString texts[ReportColumnCount] = {
+        port, step, ok ? tr("OK") : tr("FAILED"),
+        QString::number(elapsedMs, 'f', 1), detail
+    };
+    for (int col = 0; col < ReportColumnCount; ++col) {
+        auto *item = new QTableWidgetItem(texts[col]);
+        if (col == ColTime)
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        if (!ok)
+            item->setBackground(QColor(255, 180, 180));
+        report->setItem(row, col, item);
+    }
+    report->scrollToBottom();
+}
+
+void ScriptDialog::onStepFinished(const QString &port, const QString &step, bool ok,
+                                  double elapsedMs, const QString &detail)
+{
+    addReportRow(port, step, ok, elapsedMs, detail);
+}
+
+void ScriptDialog::onScriptFinished(const QString &port, bool ok, const QString &message,
+                                    double elapsedMs)
+{
+    addReportRow(port, tr("total"), ok, elapsedMs, message);
+    if (ok)
+        ++passed;
+    else
+        ++failed;
+    summaryLabel->setText(tr("%1 passed, %2 failed").arg(passed).arg(failed));
+}
+
+void ScriptDialog::onExportClicked()
+{
+    QString fn = QFileDialog::getSaveFileName(this, tr("Export Report"), QString(),
+                                              tr("CSV Files (*.csv)"));
+    if (fn.isEmpty())
+        return;
+    QFile f(fn);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        summaryLabel->setText(tr("Failed to open file: %1").arg(fn));
+        return;
+    }
+    QTextStream o(&f);
+    o << "port,step,result,time_ms,detail\n";
+    for (int row = 0; row < report->rowCount(); ++row) {
+        QStringList cells;
+        for (int col = 0; col < ReportColumnCount; ++col) {
+            QString text = report->item(row, col)->text();
+            if (text.contains(',') || text.contains('"'))
+                text = '"' + text.replace('"', "\"\"") + '"';
+            cells << text;
+        }
+        o << cells.join(',') << "\n";
+    }
+}
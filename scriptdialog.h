@@ -0,0 +1,59 @@
+// scriptdialog.h
+#ifndef SCRIPTDIALOG_H
+#define SCRIPTDIALOG_H
+
+#include <QDialog>
+#include <QPlainTextEdit>
+#include <QListWidget>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QLabel>
+
+#include "scriptrunner.h"
+
+// Commissioning scripts: edit or load a script, pick the ports to run it
+// on and collect a per-step timing report from every device.
+class ScriptDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit ScriptDialog(QWidget *parent = nullptr);
+    ~ScriptDialog() override;
+
+    void setBaudRate(qint32 baud) { baudRate = baud; }
+
+private slots:
+    void onOpenClicked();
+    void onSaveClicked();
+    void onRefreshPortsClicked();
+    void onRunClicked();
+    void onStopClicked();
+    void onExportClicked();
+    void onStepFinished(const QString &port, const QString &step, bool ok,
+                        double elapsedMs, const QString &detail);
+    void onScriptFinished(const QString &port, bool ok, const QString &message,
+                          double elapsedMs);
+
+private:
+    void addReportRow(const QString &port, const QString &step, bool ok,
+                      double elapsedMs, const QString &detail);
+    void updateButtons();
+
+    QPlainTextEdit *editor;
+    QListWidget    *portList;
+    QTableWidget   *report;
+    QLabel         *summaryLabel;
+    QPushButton    *openBtn;
+    QPushButton    *saveBtn;
+    QPushButton    *refreshBtn;
+    QPushButton    *runBtn;
+    QPushButton    *stopBtn;
+    QPushButton    *exportBtn;
+
+    QList<ScriptRunner*> runners;
+    int     passed = 0;
+    int     failed = 0;
+    qint32  baudRate = 921600;
+};
+
+#endif // SCRIPTDIALOG_H
@@ -0,0 +1,272 @@
+// scriptrunner.cpp
+#include "scriptrunner.h"
+#include "parametersdialog.h"
+#include <QSerialPortInfo>
+
+static const int livePollMs = 100;
+
+ScriptDevice::ScriptDevice(ScriptRunner *runner, qint32 defaultBaud)
+    : runner(runner), defaultBaud(defaultBaud)
+{
+}
+
+void ScriptDevice::step(const QString &name, bool ok, const QElapsedTimer &timer,
+                        const QString &detail)
+{
+    if (!ok)
+        ++failed;
+    emit runner->stepFinished(runner->portName(), name, ok, timer.nsecsElapsed() / 1e6, detail);
+}
+
+bool ScriptDevice::open(const QString &portName, int baud)
+{
+    QElapsedTimer timer;
+    timer.start();
+    port.close();
+    port.setPort(QSerialPortInfo(portName));
+    port.setBaudRate(baud > 0 ? baud : defaultBaud);
+    bool ok = port.open(QIODevice::ReadWrite);
+    decoder.clear();
+    lines.clear();
+    step(QString("open(%1)").arg(portName), ok, timer, ok ? QString() : port.errorString());
+    return ok;
+}
+
+void ScriptDevice::close()
+{
+    if (!port.isOpen())
+        return;
+    QElapsedTimer timer;
+    timer.start();
+    port.close();
+    step("close()", true, timer);
+}
+
+bool ScriptDevice::write(const QString &command)
+{
+    if (!port.isOpen())
+        return false;
+    port.write(command.toLower().toUtf8() + "\r\n");
+    return port.waitForBytesWritten(1000);
+}
+
+bool ScriptDevice::send(const QString &command)
+{
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = write(command);
+    step(QString("send(%1)").arg(command), ok, timer, port.isOpen() ? QString() : tr("not connected"));
+    return ok;
+}
+
+void ScriptDevice::pump(int timeoutMs)
+{
+    if (!port.isOpen()) {
+        QThread::msleep(timeoutMs);
+        return;
+    }
+    if (!port.waitForReadyRead(timeoutMs))
+        return;
+    items.clear();
+    decoder.feed(port.readAll(), items);
+    for (DecodedItem &item : items) {
+        if (item.binary) {
+            lastFrame = item.frame;
+            ++frameCount;
+            continue;
+        }
+        QString line = QString::fromUtf8(item.line.trimmed());
+        if (line.startsWith("LIVE:")) {
+            if (parseLiveFrame(line, lastFrame))
+                ++frameCount;
+        } else if (!line.isEmpty()) {
+            lines.append(line);
+        }
+    }
+}
+
+bool ScriptDevice::waitForLine(const QString &prefix, int timeoutMs, QString &line)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (;;) {
+        while (!lines.isEmpty()) {
+            line = lines.takeFirst();
+            if (line.startsWith(prefix))
+                return true;
+        }
+        const qint64 left = timeoutMs - timer.elapsed();
+        if (left <= 0 || runner->isInterruptionRequested())
+            return false;
+        pump(int(qMin<qint64>(left, 50)));
+    }
+}
+
+bool ScriptDevice::setParam(const QString &name, int value)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const QStringList names = ParametersDialog::parameterNames();
+    const int index = names.indexOf(name);
+    const QString stepName = QString("setParam(%1, %2)").arg(name).arg(value);
+    if (index < 0) {
+        step(stepName, false, timer, tr("unknown parameter"));
+        return false;
+    }
+    // The same limits the parameters dialog enforces
+    const int limit = ParametersDialog::parameterLimits().at(index);
+    if (value < 0 || value > limit) {
+        const QString detail = tr("value must be between 0 and %1").arg(limit);
+        step(stepName, false, timer, detail);
+        if (QJSEngine *engine = qjsEngine(this))
+            engine->throwError(QJSValue::RangeError, QString("%1: %2").arg(name, detail));
+        return false;
+    }
+
+    // Write, then read back the PARAMETERS: line to confirm
+    lines.clear();
+    QString line;
+    bool ok = write(QString("%1=%2").arg(name).arg(value))
+              && write("param")
+              && waitForLine("PARAMETERS:", 1000, line);
+    QString detail;
+    if (ok) {
+        const QStringList parts = line.mid(QString("PARAMETERS:").length())
+                                      .split(',', Qt::SkipEmptyParts);
+        ok = parts.size() == names.size() && parts[index].trimmed().toInt() == value;
+        if (!ok && parts.size() == names.size())
+            detail = tr("device reports %1").arg(parts[index].trimmed());
+    } else {
+        detail = tr("no PARAMETERS: reply");
+    }
+    step(stepName, ok, timer, detail);
+    return ok;
+}
+
+static int fieldIndex(const QString &name)
+{
+    for (int i = 0; i < LiveFieldCount; ++i) {
+        if (liveFieldName(i) == name)
+            return i;
+    }
+    return -1;
+}
+
+static const QStringList operators = {"<", "<=", ">", ">=", "==", "!="};
+
+static bool compare(double a, const QString &op, double b)
+{
+    if (op == "<")  return a < b;
+    if (op == "<=") return a <= b;
+    if (op == ">")  return a > b;
+    if (op == ">=") return a >= b;
+    if (op == "==") return a == b;
+    if (op == "!=") return a != b;
+    return false;
+}
+
+bool ScriptDevice::waitFor(const QString &field, const QString &op, double value, int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const QString stepName = QString("waitFor(%1 %2 %3)").arg(field, op).arg(value);
+    const int index = fieldIndex(field);
+    if (index < 0 || !operators.contains(op)) {
+        step(stepName, false, timer, tr("unknown field or operator"));
+        return false;
+    }
+
+    // Only frames that arrive after the call count
+    QElapsedTimer poll;
+    qint64 seen = frameCount;
+    bool ok = false;
+    while (!ok && timer.elapsed() < timeoutMs && !runner->isInterruptionRequested()) {
+        if (!poll.isValid() || poll.elapsed() >= livePollMs) {
+            poll.start();
+            if (!write("live"))
+                break;
+        }
+        pump(livePollMs / 2);
+        if (frameCount != seen) {
+            seen = frameCount;
+            ok = lastFrame.isValid(LiveField(index))
+                 && compare(lastFrame.values[index], op, value);
+        }
+    }
+    step(stepName, ok, timer, QString("%1 = %2").arg(field).arg(lastFrame.values[index]));
+    return ok;
+}
+
+double ScriptDevice::field(const QString &name) const
+{
+    const int index = fieldIndex(name);
+    return index < 0 ? 0.0 : lastFrame.values[index];
+}
+
+void ScriptDevice::sleep(int ms)
+{
+    QElapsedTimer timer;
+    timer.start();
+    // Keep reading so replies do not pile up in the driver
+    while (timer.elapsed() < ms && !runner->isInterruptionRequested())
+        pump(int(qMin<qint64>(ms - timer.elapsed(), 50)));
+    step(QString("sleep(%1)").arg(ms), true, timer);
+}
+
+void ScriptDevice::log(const QString &text)
+{
+    QElapsedTimer timer;
+    timer.start();
+    step("log", true, timer, text);
+}
+
+ScriptRunner::ScriptRunner(const QString &script, const QString &portName, qint32 baud,
+                           QObject *parent)
+    : QThread(parent), script(script), port(portName), baud(baud)
+{
+}
+
+void ScriptRunner::stop()
+{
+    requestInterruption();
+    QMutexLocker lock(&engineMutex);
+    if (engine)
+        engine->setInterrupted(true);
+}
+
+void ScriptRunner::run()
+{
+    QElapsedTimer total;
+    total.start();
+
+    QJSEngine js;
+    js.installExtensions(QJSEngine::ConsoleExtension);
+    ScriptDevice device(this, baud);
+    QJSEngine::setObjectOwnership(&device, QJSEngine::CppOwnership);
+    js.globalObject().setProperty("device", js.newQObject(&device));
+    js.globalObject().setProperty("portName", port);
+    {
+        QMutexLocker lock(&engineMutex);
+        engine = &js;
+        if (isInterruptionRequested())
+            js.setInterrupted(true);
+    }
+
+    QJSValue result = js.evaluate(script, QStringLiteral("script"));
+
+    {
+        QMutexLocker lock(&engineMutex);
+        engine = nullptr;
+    }
+    device.close();
+
+    QString message;
+    if (result.isError()) {
+        message = tr("line %1: %2").arg(result.property("lineNumber").toInt())
+                                   .arg(result.toString());
+    } else if (device.failedSteps() > 0) {
+        message = tr("%n step(s) failed", nullptr, device.failedSteps());
+    }
+    const bool ok = !result.isError() && device.failedSteps() == 0;
+    emit scriptFinished(port, ok, message, total.nsecsElapsed() / 1e6);
+}
@@ -0,0 +1,88 @@
+// scriptrunner.h
+#ifndef SCRIPTRUNNER_H
+#define SCRIPTRUNNER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QSerialPort>
+#include <QStringList>
+#include <QJSEngine>
+#include <QElapsedTimer>
+
+#include "framedecoder.h"
+
+class ScriptRunner;
+
+// The "device" object seen by scripts. Every call blocks the runner's
+// thread until it completes or times out and is reported as one step;
+// a run with any failed step fails, even if the script went on.
+class ScriptDevice : public QObject {
+    Q_OBJECT
+
+public:
+    ScriptDevice(ScriptRunner *runner, qint32 defaultBaud);
+
+    // open/close, so QObject::connect and disconnect stay usable here
+    Q_INVOKABLE bool open(const QString &portName, int baud = 0);
+    Q_INVOKABLE void close();
+    Q_INVOKABLE bool send(const QString &command);
+    // Values outside the ParametersDialog limits throw a RangeError
+    Q_INVOKABLE bool setParam(const QString &name, int value);
+    // op is one of < <= > >= == !=; polls "live" until the field matches
+    Q_INVOKABLE bool waitFor(const QString &field, const QString &op, double value, int timeoutMs);
+    Q_INVOKABLE double field(const QString &name) const;
+    Q_INVOKABLE void sleep(int ms);
+    Q_INVOKABLE void log(const QString &text);
+
+    int failedSteps() const { return failed; }
+
+private:
+    void pump(int timeoutMs);
+    bool waitForLine(const QString &prefix, int timeoutMs, QString &line);
+    bool write(const QString &command);
+    void step(const QString &name, bool ok, const QElapsedTimer &timer,
+              const QString &detail = QString());
+
+    ScriptRunner *runner;
+    QSerialPort   port;
+    qint32        defaultBaud;
+    FrameDecoder  decoder;
+    QList<DecodedItem> items;
+    QStringList   lines;        // non-LIVE lines not consumed yet
+    LiveFrame     lastFrame;
+    qint64        frameCount = 0;
+    int           failed = 0;
+};
+
+// Runs one script against one device in its own thread, with its own
+// serial port and JS engine, so many devices can be commissioned at once.
+class ScriptRunner : public QThread {
+    Q_OBJECT
+
+public:
+    ScriptRunner(const QString &script, const QString &portName, qint32 baud,
+                 QObject *parent = nullptr);
+
+    QString portName() const { return port; }
+    void stop();
+
+signals:
+    void stepFinished(const QString &port, const QString &step, bool ok,
+                      double elapsedMs, const QString &detail);
+    void scriptFinished(const QString &port, bool ok, const QString &message,
+                        double elapsedMs);
+
+protected:
+    void run() override;
+
+private:
+    friend class ScriptDevice;
+
+    QString    script;
+    QString    port;
+    qint32     baud;
+    QMutex     engineMutex;
+    QJSEngine *engine = nullptr;    // only while run() evaluates
+};
+
+#endif // SCRIPTRUNNER_H
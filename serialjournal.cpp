@@ -0,0 +1,113 @@
+// serialjournal.cpp
+#include "serialjournal.h"
+#include <QMutexLocker>
+#include <QtEndian>
+#include <cstring>
+
+SerialJournal::SerialJournal(QObject *parent) : QThread(parent)
+{
+    buffers[0].reset(new char[bufferSize]);
+    buffers[1].reset(new char[bufferSize]);
+}
+
+SerialJournal::~SerialJournal() { close(); }
+
+bool SerialJournal::open(const QString &fileName)
+{
+    close();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    char header[JournalFormat::headerSize];
+    std::memcpy(header, JournalFormat::magic, 8);
+    qToLittleEndian<quint32>(JournalFormat::version, header + 8);
+    file.write(header, sizeof(header));
+
+    used[0] = used[1] = 0;
+    active = 0;
+    stopping = false;
+    dropped = 0;
+    written = sizeof(header);
+    recording = true;
+    start(QThread::LowPriority);
+    return true;
+}
+
+void SerialJournal::close()
+{
+    if (!isRunning())
+        return;
+    recording = false;
+    {
+        QMutexLocker lock(&mutex);
+        stopping = true;
+        wake.wakeOne();
+    }
+    wait();
+    file.close();
+}
+
+void SerialJournal::record(Direction direction, qint64 timeUs, const char *data, qint64 size)
+{
+    if (!isRecording() || size <= 0)
+        return;
+    const qint64 need = JournalFormat::recordHeaderSize + size;
+
+    QMutexLocker lock(&mutex);
+    if (used[active] + need > bufferSize) {
+        dropped += size;
+        wake.wakeOne();
+        return;
+    }
+    char *p = buffers[active].get() + used[active];
+    qToLittleEndian<quint64>(quint64(timeUs), p);
+    p[8] = char(direction);
+    qToLittleEndian<quint32>(quint32(size), p + 9);
+    std::memcpy(p + JournalFormat::recordHeaderSize, data, size_t(size));
+    used[active] += need;
+
+    if (used[active] > bufferSize / 2)
+        wake.wakeOne();
+}
+
+void SerialJournal::run()
+{
+    for (;;) {
+        int full;
+        bool done;
+        {
+            QMutexLocker lock(&mutex);
+            if (!stopping && used[active] <= bufferSize / 2)
+                wake.wait(&mutex, 200);
+            // Hand the filled buffer to this thread, producers continue in the other
+            full = active;
+            active ^= 1;
+            done = stopping;
+        }
+        if (used[full] > 0) {
+            file.write(buffers[full].get(), used[full]);
+            written += used[full];
+            used[full] = 0;
+        }
+        if (done) {
+            // Pick up anything appended after the last swap
+            QMutexLocker lock(&mutex);
+            if (used[active] > 0) {
+                file.write(buffers[active].get(), used[active]);
+                written += used[active];
+                used[active] = 0;
+            }
+            break;
+        }
+        file.flush();
+    }
+}
+
+qint64 JournalingSerialPort::writeData(const char *data, qint64 maxSize)
+{
+    qint64 n = QSerialPort::writeData(data, maxSize);
+    if (writeHook && n > 0)
+        writeHook(data, n);
+    return n;
+}
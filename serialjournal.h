@@ -0,0 +1,79 @@
+// serialjournal.h
+#ifndef SERIALJOURNAL_H
+#define SERIALJOURNAL_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+#include <QSerialPort>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// Journal file layout (all little-endian):
+//   "LOOPJRNL" quint32 version
+//   repeated: quint64 timeUs, quint8 direction, quint32 length, bytes
+namespace JournalFormat {
+const char magic[8] = {'L', 'O', 'O', 'P', 'J', 'R', 'N', 'L'};
+const quint32 version = 1;
+const int headerSize = 12;
+const int recordHeaderSize = 13;
+}
+
+// Records every serial chunk with its timestamp. record() only copies into
+// one of two preallocated buffers; a background thread swaps them and
+// writes the full one to disk. If the writer falls behind, chunks are
+// dropped and counted rather than blocking the caller.
+class SerialJournal : public QThread {
+    Q_OBJECT
+
+public:
+    enum Direction : quint8 { Inbound = 0, Outbound = 1 };
+
+    explicit SerialJournal(QObject *parent = nullptr);
+    ~SerialJournal() override;
+
+    bool open(const QString &fileName);
+    void close();
+    bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+
+    void record(Direction direction, qint64 timeUs, const char *data, qint64 size);
+    qint64 droppedBytes() const { return dropped.load(); }
+    qint64 writtenBytes() const { return written.load(); }
+
+protected:
+    void run() override;
+
+private:
+    static const qint64 bufferSize = 4 * 1024 * 1024;
+
+    QFile file;
+    QMutex mutex;
+    QWaitCondition wake;
+    std::unique_ptr<char[]> buffers[2];
+    qint64 used[2] = {0, 0};
+    int active = 0;                 // buffer record() appends to
+    bool stopping = false;
+    std::atomic<bool> recording{false};
+    std::atomic<qint64> dropped{0};
+    std::atomic<qint64> written{0};
+};
+
+// QSerialPort that reports every outgoing write, including those made
+// directly by the dialogs, so they can be journalled
+class JournalingSerialPort : public QSerialPort {
+    Q_OBJECT
+
+public:
+    using QSerialPort::QSerialPort;
+    void setWriteHook(std::function<void(const char *, qint64)> hook) { writeHook = std::move(hook); }
+
+protected:
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    std::function<void(const char *, qint64)> writeHook;
+};
+
+#endif // SERIALJOURNAL_H
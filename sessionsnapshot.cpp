@@ -0,0 +1,251 @@
+// sessionsnapshot.cpp
+#include "sessionsnapshot.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <cstring>
+#include <utility>
+
+namespace {
+const char stateFile[] = "session.state";
+}
+
+QString SessionSnapshot::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/session";
+}
+
+SessionSnapshot::SessionSnapshot(const QString &directory) : dir(directory)
+{
+}
+
+QString SessionSnapshot::traceFileName(int loop) const
+{
+    return QString("%1/loop%2.trace").arg(dir).arg(loop + 1);
+}
+
+// Bring the trace file up to date with the sealed blocks of the trace
+bool SessionSnapshot::syncTrace(int loop, const LoopTrace &trace)
+{
+    const SampleStore &store = trace.samples();
+    TraceFile &tf = traces[loop];
+    QFile file(traceFileName(loop));
+    if (tf.generation != trace.generation() || tf.blocks > store.blockCount() || !file.exists()) {
+        // Cleared or replaced since the last save: start over under a new
+        // token so the old state no longer matches a half written file
+        tf.token = QRandomGenerator::global()->generate64();
+        tf.generation = trace.generation();
+        tf.blocks = 0;
+        tf.bytes = SessionFormat::headerSize;
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return false;
+        uchar header[SessionFormat::headerSize];
+        std::memcpy(header, SessionFormat::magic, 8);
+        qToLittleEndian<quint64>(tf.token, header + 8);
+        if (file.write(reinterpret_cast<const char *>(header), sizeof(header)) != sizeof(header))
+            return false;
+    } else {
+        if (tf.blocks == store.blockCount())
+            return true;
+        // Anything past the last recorded block is from an interrupted save
+        if (!file.open(QIODevice::ReadWrite) || !file.seek(tf.bytes))
+            return false;
+    }
+
+    QByteArray chunk;
+    for (int b = tf.blocks; b < store.blockCount(); ++b) {
+        const SampleStore::Block &blk = store.block(b);
+        uchar record[SessionFormat::recordSize] = {};
+        qToLittleEndian<quint32>(quint32(blk.data.size()), record);
+        qToLittleEndian<qint64>(blk.firstTimeUs, record + 8);
+        qToLittleEndian<qint64>(blk.lastTimeUs, record + 16);
+        qToLittleEndian<double>(blk.minValue, record + 24);
+        qToLittleEndian<double>(blk.maxValue, record + 32);
+        qToLittleEndian<double>(blk.sum, record + 40);
+        chunk.append(reinterpret_cast<const char *>(record), sizeof(record));
+        chunk.append(blk.data);
+    }
+    if (file.write(chunk) != chunk.size() || !file.flush())
+        return false;
+    tf.blocks = store.blockCount();
+    tf.bytes += chunk.size();
+    return true;
+}
+
+bool SessionSnapshot::save(const SessionState &state, const LoopTrace &loop1, const LoopTrace &loop2)
+{
+    if (!QDir().mkpath(dir))
+        return false;
+    const LoopTrace *loops[2] = {&loop1, &loop2};
+    for (int i = 0; i < 2; ++i) {
+        if (!syncTrace(i, *loops[i])) {
+            traces[i].generation = -1;  // rewrite it next time
+            return false;
+        }
+    }
+
+    QByteArray buffer;
+    QDataStream out(&buffer, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out.writeRawData(SessionFormat::magic, 8);
+    out << SessionFormat::version;
+    out << state.port << state.baud << state.geometry << state.windowState
+        << state.timeAxis << state.dialogs;
+    for (int i = 0; i < 2; ++i) {
+        const SessionLoop &l = state.loops[i];
+        out << l.minX << l.maxX << l.minY << l.maxY << qint32(l.scroll) << l.sourceFile;
+
+        // The open block is small, store it with the state
+        const SampleStore &store = loops[i]->samples();
+        QVector<qint64> times;
+        QVector<double> values;
+        store.read(traces[i].blocks * SampleStore::blockSize, store.size(), &times, &values);
+        out << traces[i].token << qint32(traces[i].blocks) << times << values << loops[i]->breaks();
+
+        const EventIndex &events = loops[i]->events();
+        out << qint32(events.size());
+        for (int k = 0; k < events.size(); ++k) {
+            const DetectionEvent &e = events.at(k);
+            out << qint32(e.kind) << qint32(e.firstSample) << qint32(e.lastSample) << e.startS << e.endS;
+        }
+    }
+
+    QSaveFile file(dir + '/' + stateFile);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(buffer);
+    return file.commit();
+}
+
+// Copy the first blocks of a trace file into the store; returns the
+// offset after the last one, or -1 if the file does not match
+qint64 SessionSnapshot::mapTrace(int loop, quint64 token, int blocks, SampleStore &store) const
+{
+    QFile file(traceFileName(loop));
+    if (!file.open(QIODevice::ReadOnly) || file.size() < SessionFormat::headerSize)
+        return -1;
+    const qint64 size = file.size();
+    uchar *base = file.map(0, size);
+    if (!base)
+        return -1;
+
+    qint64 pos = -1;
+    if (std::memcmp(base, SessionFormat::magic, 8) == 0
+        && qFromLittleEndian<quint64>(base + 8) == token) {
+        pos = SessionFormat::headerSize;
+        for (int b = 0; b < blocks; ++b) {
+            const uchar *r = base + pos;
+            if (pos + SessionFormat::recordSize > size
+                || pos + SessionFormat::recordSize + qFromLittleEndian<quint32>(r) > size) {
+                pos = -1;
+                break;
+            }
+            const quint32 bytes = qFromLittleEndian<quint32>(r);
+            SampleStore::Block blk;
+            blk.data = QByteArray(reinterpret_cast<const char *>(r + SessionFormat::recordSize), bytes);
+            blk.firstTimeUs = qFromLittleEndian<qint64>(r + 8);
+            blk.lastTimeUs = qFromLittleEndian<qint64>(r + 16);
+            blk.minValue = qFromLittleEndian<double>(r + 24);
+            blk.maxValue = qFromLittleEndian<double>(r + 32);
+            blk.sum = qFromLittleEndian<double>(r + 40);
+            store.appendBlock(blk);
+            pos += SessionFormat::recordSize + bytes;
+        }
+    }
+    file.unmap(base);
+    return pos;
+}
+
+bool SessionSnapshot::restore(SessionState &state, LoopTrace &loop1, LoopTrace &loop2)
+{
+    QFile file(dir + '/' + stateFile);
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+        return false;
+    uchar *base = file.map(0, file.size());
+    if (!base)
+        return false;
+    const QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char *>(base), file.size());
+    QDataStream in(raw);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    char magic[8];
+    quint32 version = 0;
+    if (in.readRawData(magic, 8) != 8 || std::memcmp(magic, SessionFormat::magic, 8) != 0)
+        return false;
+    in >> version;
+    if (version != SessionFormat::version)
+        return false;
+
+    SessionState s;
+    in >> s.port >> s.baud >> s.geometry >> s.windowState >> s.timeAxis >> s.dialogs;
+
+    // Parse everything before touching the traces
+    struct Pending {
+        SampleStore store;
+        QVector<int> breaks;
+        QVector<DetectionEvent> events;
+        quint64 token = 0;
+        qint32 blocks = 0;
+        qint64 bytes = -1;
+    };
+    Pending pending[2];
+    for (int i = 0; i < 2; ++i) {
+        SessionLoop &l = s.loops[i];
+        Pending &p = pending[i];
+        qint32 scroll = 0;
+        qint32 eventCount = 0;
+        QVector<qint64> times;
+        QVector<double> values;
+        in >> l.minX >> l.maxX >> l.minY >> l.maxY >> scroll >> l.sourceFile;
+        in >> p.token >> p.blocks >> times >> values >> p.breaks >> eventCount;
+        l.scroll = scroll;
+        if (in.status() != QDataStream::Ok || times.size() != values.size()
+            || times.size() >= SampleStore::blockSize || p.blocks < 0 || eventCount < 0)
+            return false;
+        p.events.reserve(eventCount);
+        for (int k = 0; k < eventCount; ++k) {
+            qint32 kind, first, last;
+            double startS, endS;
+            in >> kind >> first >> last >> startS >> endS;
+            if (kind < 0 || kind >= EventKindCount)
+                return false;
+            p.events.append({EventKind(kind), first, last, startS, endS});
+        }
+        if (in.status() != QDataStream::Ok)
+            return false;
+
+        // A missing or replaced trace file leaves this loop empty
+        p.bytes = mapTrace(i, p.token, p.blocks, p.store);
+        if (p.bytes >= 0) {
+            for (int k = 0; k < times.size(); ++k)
+                p.store.append(times[k], values[k]);
+        }
+    }
+
+    LoopTrace *loops[2] = {&loop1, &loop2};
+    for (int i = 0; i < 2; ++i) {
+        Pending &p = pending[i];
+        if (p.bytes < 0)
+            continue;
+        loops[i]->restore(std::move(p.store), p.breaks, p.events);
+        traces[i].token = p.token;
+        traces[i].generation = loops[i]->generation();
+        traces[i].blocks = p.blocks;
+        traces[i].bytes = p.bytes;
+    }
+    state = s;
+    return true;
+}
+
+void SessionSnapshot::discard()
+{
+    QFile::remove(dir + '/' + stateFile);
+    for (int i = 0; i < 2; ++i) {
+        QFile::remove(traceFileName(i));
+        traces[i] = TraceFile();
+    }
+}
@@ -0,0 +1,80 @@
+// sessionsnapshot.h
+#ifndef SESSIONSNAPSHOT_H
+#define SESSIONSNAPSHOT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include "looptrace.h"
+
+// View of one loop chart at the time of the snapshot
+struct SessionLoop {
+    double minX = 0.0;
+    double maxX = 0.0;
+    double minY = 0.0;
+    double maxY = 1.0;
+    int    scroll = 0;
+    QString sourceFile;     // capture the trace was loaded from, empty for live data
+};
+
+struct SessionState {
+    QString     port;
+    qint32      baud = 0;
+    QByteArray  geometry;       // QMainWindow::saveGeometry / saveState
+    QByteArray  windowState;
+    bool        timeAxis = false;
+    QStringList dialogs;        // object names of the actions that open them
+    SessionLoop loops[2];
+};
+
+// Crash-safe session snapshot in a directory of three files:
+//   loop1.trace, loop2.trace  "LOOPSESS" quint64 token, then the sealed
+//                             SampleStore blocks, each a 48 byte record
+//                             (quint32 bytes, quint32 0, qint64 first/last
+//                             time, double min/max/sum) and its data
+//   session.state             QDataStream: SessionState, and per loop the
+//                             token, the number of valid blocks, the open
+//                             block, gaps and event intervals
+// Sealed blocks never change, so a save only appends the blocks sealed
+// since the previous one and rewrites the small state file atomically.
+// A trace file is only trusted up to the block count and token recorded
+// in the state, which makes a crash in the middle of a save harmless.
+// Restoring maps the files and copies the encoded blocks and their
+// summaries without decoding a sample, so it takes milliseconds even
+// for captures of tens of millions of samples.
+namespace SessionFormat {
+const char magic[8] = {'L', 'O', 'O', 'P', 'S', 'E', 'S', 'S'};
+const quint32 version = 1;
+const int headerSize = 16;
+const int recordSize = 48;
+}
+
+class SessionSnapshot {
+public:
+    static QString defaultDirectory();
+
+    explicit SessionSnapshot(const QString &directory = defaultDirectory());
+
+    QString directory() const { return dir; }
+
+    bool save(const SessionState &state, const LoopTrace &loop1, const LoopTrace &loop2);
+    bool restore(SessionState &state, LoopTrace &loop1, LoopTrace &loop2);
+    void discard();
+
+private:
+    struct TraceFile {
+        quint64 token = 0;
+        int generation = -1;    // LoopTrace::generation() the file holds
+        int blocks = 0;
+        qint64 bytes = 0;       // end of the last block
+    };
+    QString traceFileName(int loop) const;
+    bool syncTrace(int loop, const LoopTrace &trace);
+    qint64 mapTrace(int loop, quint64 token, int blocks, SampleStore &store) const;
+
+    QString   dir;
+    TraceFile traces[2];
+};
+
+#endif // SESSIONSNAPSHOT_H
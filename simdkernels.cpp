@@ -0,0 +1,95 @@
+// simdkernels.cpp
+#include "simdkernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOOP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace SimdKernels {
+
+double dot(const float *a, const float *b, int n)
+{
+    int i = 0;
+    double sum = 0.0;
+#ifdef LOOP_SSE2
+    // Products in single precision, sums widened to double so a million
+    // terms do not lose the small ones
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        const __m128 p = _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        acc0 = _mm_add_pd(acc0, _mm_cvtps_pd(p));
+        acc1 = _mm_add_pd(acc1, _mm_cvtps_pd(_mm_movehl_ps(p, p)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < n; ++i)
+        sum += double(a[i]) * b[i];
+    return sum;
+}
+
+void subtract(const float *a, const float *b, float *out, int n)
+{
+    int i = 0;
+#ifdef LOOP_SSE2
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(out + i, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+#endif
+    for (; i < n; ++i)
+        out[i] = a[i] - b[i];
+}
+
+void divide(const float *a, const float *b, float *out, int n)
+{
+    int i = 0;
+#ifdef LOOP_SSE2
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(out + i, _mm_div_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+#endif
+    for (; i < n; ++i)
+        out[i] = a[i] / b[i];
+}
+
+void decimate(const float *in, int n, int factor, float *out)
+{
+    const int count = n / factor;
+    const float scale = 1.0f / factor;
+#ifdef LOOP_SSE2
+    if (factor == 4) {
+        // Transpose four groups of four and add the columns
+        int o = 0;
+        for (; o + 4 <= count; o += 4) {
+            __m128 r0 = _mm_loadu_ps(in + o * 4);
+            __m128 r1 = _mm_loadu_ps(in + o * 4 + 4);
+            __m128 r2 = _mm_loadu_ps(in + o * 4 + 8);
+            __m128 r3 = _mm_loadu_ps(in + o * 4 + 12);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            const __m128 s = _mm_add_ps(_mm_add_ps(r0, r1), _mm_add_ps(r2, r3));
+            _mm_storeu_ps(out + o, _mm_mul_ps(s, _mm_set1_ps(scale)));
+        }
+        for (; o < count; ++o)
+            out[o] = (in[o * 4] + in[o * 4 + 1] + in[o * 4 + 2] + in[o * 4 + 3]) * scale;
+        return;
+    }
+#endif
+    for (int o = 0; o < count; ++o) {
+        float s = 0.0f;
+        for (int k = 0; k < factor; ++k)
+            s += in[o * factor + k];
+        out[o] = s * scale;
+    }
+}
+
+bool usingSse2()
+{
+#ifdef LOOP_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace SimdKernels
@@ -0,0 +1,26 @@
+// simdkernels.h
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+// Float array kernels for the hot loops of capture alignment and
+// comparison. SSE2 is used where the compiler targets it (always on
+// x86-64); other targets get the plain loops.
+namespace SimdKernels {
+
+// Sum of a[i] * b[i], accumulated in double
+double dot(const float *a, const float *b, int n);
+
+// out[i] = a[i] - b[i]
+void subtract(const float *a, const float *b, float *out, int n);
+
+// out[i] = a[i] / b[i]
+void divide(const float *a, const float *b, float *out, int n);
+
+// out[i] = mean of in[i * factor .. i * factor + factor), n / factor outputs
+void decimate(const float *in, int n, int factor, float *out);
+
+bool usingSse2();
+
+} // namespace SimdKernels
+
+#endif // SIMDKERNELS_H
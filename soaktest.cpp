@@ -0,0 +1,238 @@
+// soaktest.cpp
+#include "soaktest.h"
+#include "allocationhook.h"
+#include "mainwindow.h"
+#include "ui_mainwindow.h"
+#include <QCoreApplication>
+#include <QTextStream>
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+qint64 SoakTest::residentBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return qint64(counters.WorkingSetSize);
+    return -1;
+#elif defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        return -1;
+    const QList<QByteArray> parts = statm.readAll().split(' ');
+    if (parts.size() < 2)
+        return -1;
+    return parts[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+SoakTest::SoakTest(MainWindow *window, const SoakOptions &options, QObject *parent)
+    : QObject(parent), window(window), opt(options)
+{
+    pumpTimer = new QTimer(this);
+    pumpTimer->setInterval(10);
+    connect(pumpTimer, &QTimer::timeout, this, &SoakTest::pump);
+
+    latencyTimer = new QTimer(this);
+    latencyTimer->setTimerType(Qt::PreciseTimer);
+    latencyTimer->setInterval(20);
+    connect(latencyTimer, &QTimer::timeout, this, &SoakTest::measureLatency);
+
+    exerciseTimer = new QTimer(this);
+    exerciseTimer->setInterval(5000);
+    connect(exerciseTimer, &QTimer::timeout, this, &SoakTest::exercise);
+
+    sampleTimer = new QTimer(this);
+    sampleTimer->setInterval(opt.sampleSeconds * 1000);
+    connect(sampleTimer, &QTimer::timeout, this, &SoakTest::sample);
+}
+
+void SoakTest::start()
+{
+    report.setFileName(opt.reportFile);
+    if (!opt.reportFile.isEmpty() && report.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        report.write("elapsed_s,frames_sent,frames_received,lost_frames,rss_mb,"
+                     "allocs_per_frame,latency_p99_ms,latency_max_ms\n");
+    }
+
+    // What LIVE ON does, without a port to poll
+    window->frameTiming.reset();
+    window->frameTiming.setNominalInterval(qint64(1e6 / opt.frameRate));
+    window->pendingBreak = true;
+    window->timingTimer->start();
+    window->autoScroll = true;
+    window->scrollBar1->setEnabled(false);
+    window->scrollBar2->setEnabled(false);
+    window->liveDataLabel->setText(tr("Soak test"));
+
+    countingAllocations = AllocationHook::install();
+    clock.start();
+    lastAllocations = AllocationHook::count();
+    pumpTimer->start();
+    latencyTimer->start();
+    exerciseTimer->start();
+    sampleTimer->start();
+    QTimer::singleShot(qint64(opt.minutes) * 60000, this, &SoakTest::finish);
+}
+
+void SoakTest::pump()
+{
+    // Catch up to the frames due by now, in one chunk like a serial read
+    const qint64 due = qint64(clock.nsecsElapsed() / 1e9 * opt.frameRate);
+    if (due <= framesSent)
+        return;
+    QByteArray chunk;
+    for (; framesSent < due; ++framesSent)
+        chunk += device.nextChunk(opt.binary);
+    window->processIncoming(chunk, window->frameClock.nsecsElapsed() / 1000);
+}
+
+void SoakTest::measureLatency()
+{
+    const qint64 now = clock.nsecsElapsed() / 1000;
+    if (lastLatencyUs >= 0)
+        lateness.append(qMax<qint64>(0, now - lastLatencyUs - latencyTimer->interval() * 1000) / 1000.0);
+    lastLatencyUs = now;
+}
+
+void SoakTest::exercise()
+{
+    // One step every few seconds, cycling through the GUI paths that
+    // allocate: dialogs with refresh timers, parameter replies, resets
+    switch (step++ % 8) {
+    case 0:
+        window->on_actionSTATISTICS_triggered();
+        break;
+    case 1:
+        window->on_actionEVENT_LIST_triggered();
+        break;
+    case 2:
+        window->on_actionOPEN_PARAMETERS_triggered();
+        window->processIncoming(device.parametersLine(), window->frameClock.nsecsElapsed() / 1000);
+        break;
+    case 3:
+        window->processIncoming(device.parametersLine(), window->frameClock.nsecsElapsed() / 1000);
+        editParameter();
+        window->on_btnRESET1_clicked();
+        break;
+    case 4:
+        window->ui->actionTIME_AXIS->toggle();
+        break;
+    case 5:
+        window->on_btnRESET2_clicked();
+        break;
+    case 6:
+        window->ui->actionTIME_AXIS->toggle();
+        break;
+    case 7:
+        for (QDialog *dialog : window->findChildren<QDialog *>())
+            dialog->hide();
+        break;
+    }
+}
+
+void SoakTest::editParameter()
+{
+    // Edit a value cell the way a user would, so onCellChanged() and the
+    // item churn of the table run; values stay within the limits, an
+    // invalid one would open a message box
+    if (!window->parametersDialog)
+        return;
+    auto *table = window->parametersDialog->findChild<QTableWidget *>();
+    if (!table || table->rowCount() == 0)
+        return;
+    const int row = editedRow++ % table->rowCount();
+    QTableWidgetItem *item = table->item(row, 1);
+    const int limit = ParametersDialog::parameterLimits().value(row);
+    if (item)
+        item->setText(QString::number((item->text().toInt() + 1) % (limit + 1)));
+}
+
+void SoakTest::sample()
+{
+    Sample s;
+    s.elapsedS = clock.elapsed() / 1000.0;
+    s.framesSent = framesSent;
+    s.framesReceived = window->frameTiming.frames();
+    s.lostFrames = window->frameTiming.lostFrames() + (framesSent - s.framesReceived);
+    const qint64 rss = residentBytes();
+    s.rssMb = rss < 0 ? -1.0 : rss / 1048576.0;
+    const quint64 allocs = AllocationHook::count();
+    s.allocsPerFrame = countingAllocations
+                           ? double(allocs - lastAllocations) / qMax<qint64>(1, framesSent - lastFramesSent)
+                           : -1.0;
+    lastAllocations = allocs;
+    lastFramesSent = framesSent;
+    std::sort(lateness.begin(), lateness.end());
+    s.latencyP99Ms = lateness.isEmpty() ? 0.0 : lateness[int((lateness.size() - 1) * 0.99)];
+    s.latencyMaxMs = lateness.isEmpty() ? 0.0 : lateness.last();
+    lateness.clear();
+
+    samples.append(s);
+    if (baseline < 0 && s.elapsedS >= opt.warmupSeconds)
+        baseline = samples.size() - 1;
+
+    if (report.isOpen()) {
+        QTextStream out(&report);
+        out << s.elapsedS << ',' << s.framesSent << ',' << s.framesReceived << ','
+            << s.lostFrames << ',' << s.rssMb << ',' << s.allocsPerFrame << ','
+            << s.latencyP99Ms << ',' << s.latencyMaxMs << '\n';
+        out.flush();
+    }
+    // A bound already broken will not recover; stop early
+    if (!finished && !checkBounds(s).isEmpty())
+        finish();
+}
+
+QStringList SoakTest::checkBounds(const Sample &last) const
+{
+    QStringList failures;
+    if (last.lostFrames > opt.maxLostFrames)
+        failures << QString("%1 frames lost").arg(last.lostFrames);
+    if (baseline < 0)
+        return failures;
+    const Sample &base = samples[baseline];
+    if (last.latencyP99Ms > opt.maxLatencyMs)
+        failures << QString("event loop p99 latency %1 ms").arg(last.latencyP99Ms, 0, 'f', 1);
+    if (base.rssMb >= 0.0 && last.rssMb - base.rssMb > opt.maxRssGrowthMb)
+        failures << QString("RSS grew %1 MB").arg(last.rssMb - base.rssMb, 0, 'f', 1);
+    if (countingAllocations && last.allocsPerFrame > base.allocsPerFrame * opt.maxAllocGrowth + 1.0)
+        failures << QString("allocations per frame grew from %1 to %2")
+                        .arg(base.allocsPerFrame, 0, 'f', 1).arg(last.allocsPerFrame, 0, 'f', 1);
+    return failures;
+}
+
+void SoakTest::finish()
+{
+    if (finished)
+        return;
+    finished = true;
+    pumpTimer->stop();
+    latencyTimer->stop();
+    exerciseTimer->stop();
+    sampleTimer->stop();
+    if (samples.isEmpty() || samples.last().elapsedS < clock.elapsed() / 1000.0 - 1.0)
+        sample();
+
+    const QStringList failures = checkBounds(samples.last());
+    QTextStream err(stderr);
+    err << QString("soak: %1 s, %2 frames, baseline %3\n")
+               .arg(samples.last().elapsedS, 0, 'f', 0).arg(framesSent)
+               .arg(baseline < 0 ? QString("not reached")
+                                 : QString("at %1 s").arg(samples[baseline].elapsedS, 0, 'f', 0));
+    for (const QString &f : failures)
+        err << "soak: FAIL " << f << '\n';
+    if (failures.isEmpty())
+        err << "soak: PASS\n";
+    err.flush();
+    report.close();
+    QCoreApplication::exit(failures.isEmpty() ? 0 : 1);
+}
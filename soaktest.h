@@ -0,0 +1,89 @@
+// soaktest.h
+#ifndef SOAKTEST_H
+#define SOAKTEST_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include "syntheticdevice.h"
+
+class MainWindow;
+
+struct SoakOptions {
+    int     minutes = 60;
+    double  frameRate = 100.0;      // frames/s; the firmware sends 10
+    bool    binary = true;
+    QString reportFile;             // CSV of the samples, empty for none
+    int     sampleSeconds = 10;
+    int     warmupSeconds = 60;     // the first sample after this is the baseline
+    // Bounds, checked against the baseline sample
+    double  maxRssGrowthMb = 64.0;
+    double  maxAllocGrowth = 1.5;   // allocations per frame, last window / baseline
+    double  maxLatencyMs = 250.0;   // 99th percentile of event loop lateness
+    qint64  maxLostFrames = 0;
+};
+
+// Drives a MainWindow for a long run against a SyntheticDevice: frames
+// go through the same processIncoming() path as serial data, at an
+// accelerated rate, while dialogs are opened and closed, parameter
+// replies arrive, parameter cells are edited and the loops are reset.
+// RSS, heap allocations (see AllocationHook), event loop latency and
+// lost frames are sampled over time; the application exits with 1 if
+// any of them grew beyond its bound. Built with CONFIG+=soak only.
+class SoakTest : public QObject {
+    Q_OBJECT
+
+public:
+    SoakTest(MainWindow *window, const SoakOptions &options, QObject *parent = nullptr);
+
+    void start();
+
+    static qint64 residentBytes();          // -1 where unsupported
+
+private slots:
+    void pump();
+    void measureLatency();
+    void exercise();
+    void sample();
+    void finish();
+
+private:
+    struct Sample {
+        double  elapsedS;
+        qint64  framesSent;
+        qint64  framesReceived;
+        qint64  lostFrames;
+        double  rssMb;
+        double  allocsPerFrame;
+        double  latencyP99Ms;
+        double  latencyMaxMs;
+    };
+    QStringList checkBounds(const Sample &last) const;
+    void editParameter();
+
+    MainWindow     *window;
+    SoakOptions     opt;
+    SyntheticDevice device;
+    QElapsedTimer   clock;
+    QTimer         *pumpTimer;
+    QTimer         *latencyTimer;
+    QTimer         *exerciseTimer;
+    QTimer         *sampleTimer;
+    qint64          framesSent = 0;
+    qint64          lastLatencyUs = -1;
+    QVector<double> lateness;       // ms, since the last sample
+    bool            countingAllocations = false;
+    quint64         lastAllocations = 0;
+    qint64          lastFramesSent = 0;
+    int             step = 0;
+    int             editedRow = 0;
+    bool            finished = false;
+    QList<Sample>   samples;
+    int             baseline = -1;  // index into samples
+    QFile           report;
+};
+
+#endif // SOAKTEST_H
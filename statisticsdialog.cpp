@@ -0,0 +1,163 @@
+// statisticsdialog.cpp
+#include "statisticsdialog.h"
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <cmath>
+
+StatisticsDialog::StatisticsDialog(LiveStatistics *stats, QWidget *parent)
+    : QDialog(parent), stats(stats)
+{
+    setWindowTitle(tr("Live Statistics"));
+
+    table = new QTableWidget(LiveFieldCount, ColumnCount, this);
+    table->setHorizontalHeaderLabels({tr("Field"), tr("Last"), tr("Mean"), tr("Std"),
+                                      tr("EWMA"), tr("Win Min"), tr("Win Max"),
+                                      tr("P5"), tr("P50"), tr("P95"),
+                                      tr("Dev Base"), tr("Dev Std"),
+                                      tr("Δ Mean"), tr("Δ Std")});
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    // Items are created once and only their text is updated afterwards
+    for (int row = 0; row < LiveFieldCount; ++row) {
+        table->setItem(row, ColField, new QTableWidgetItem(liveFieldName(row)));
+        for (int col = ColLast; col < ColumnCount; ++col) {
+            auto *item = new QTableWidgetItem;
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            table->setItem(row, col, item);
+        }
+    }
+
+    windowSpin = new QSpinBox(this);
+    windowSpin->setRange(1, 3600);
+    windowSpin->setValue(10);
+    windowSpin->setSuffix(tr(" s"));
+    connect(windowSpin, &QSpinBox::valueChanged,
+            this, &StatisticsDialog::onWindowChanged);
+
+    alphaSpin = new QDoubleSpinBox(this);
+    alphaSpin->setRange(0.001, 1.0);
+    alphaSpin->setDecimals(3);
+    alphaSpin->setSingleStep(0.01);
+    alphaSpin->setValue(0.1);
+    connect(alphaSpin, &QDoubleSpinBox::valueChanged,
+            this, &StatisticsDialog::onAlphaChanged);
+
+    // Highlight the device std when it differs this much from ours; the
+    // baseline is flagged once it leaves one host std of our mean
+    toleranceSpin = new QSpinBox(this);
+    toleranceSpin->setRange(1, 1000);
+    toleranceSpin->setValue(20);
+    toleranceSpin->setSuffix(tr(" %"));
+
+    resetBtn = new QPushButton(tr("Reset"), this);
+    connect(resetBtn, &QPushButton::clicked,
+            this, &StatisticsDialog::onResetClicked);
+
+    auto *form = new QFormLayout;
+    form->addRow(tr("Min/Max window:"), windowSpin);
+    form->addRow(tr("EWMA alpha:"), alphaSpin);
+    form->addRow(tr("Std tolerance:"), toleranceSpin);
+
+    auto *btnLayout = new QHBoxLayout;
+    btnLayout->addLayout(form);
+    btnLayout->addStretch();
+    btnLayout->addWidget(resetBtn);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(table);
+    mainLayout->addLayout(btnLayout);
+
+    setMinimumSize(1000, 600);
+
+    // The table is repainted at a fixed rate, not per frame
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(250);
+    connect(refreshTimer, &QTimer::timeout, this, &StatisticsDialog::refresh);
+
+    stats->setWindow(qint64(windowSpin->value()) * 1000000);
+    stats->setEwmaAlpha(alphaSpin->value());
+}
+
+void StatisticsDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    refresh();
+    refreshTimer->start();
+}
+
+void StatisticsDialog::hideEvent(QHideEvent *event)
+{
+    refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
+
+void StatisticsDialog::onWindowChanged(int seconds)
+{
+    stats->setWindow(qint64(seconds) * 1000000);
+}
+
+void StatisticsDialog::onAlphaChanged(double alpha)
+{
+    stats->setEwmaAlpha(alpha);
+}
+
+void StatisticsDialog::onResetClicked()
+{
+    stats->reset();
+    refresh();
+}
+
+void StatisticsDialog::setCell(int row, int column, double value, const QColor &background)
+{
+    QTableWidgetItem *item = table->item(row, column);
+    item->setText(std::isfinite(value) ? QString::number(value, 'f', 2) : QString());
+    item->setBackground(background.isValid() ? QBrush(background) : QBrush());
+}
+
+void StatisticsDialog::refresh()
+{
+    for (int row = 0; row < LiveFieldCount; ++row) {
+        const RollingStats &s = stats->field(row);
+        if (s.count() == 0) {
+            for (int col = ColLast; col < ColumnCount; ++col)
+                table->item(row, col)->setText(QString());
+            continue;
+        }
+        setCell(row, ColLast, s.last());
+        setCell(row, ColMean, s.mean());
+        setCell(row, ColStd, s.stddev());
+        setCell(row, ColEwma, s.ewma());
+        setCell(row, ColMin, s.windowMin());
+        setCell(row, ColMax, s.windowMax());
+        setCell(row, ColP05, s.p05());
+        setCell(row, ColP50, s.p50());
+        setCell(row, ColP95, s.p95());
+    }
+
+    // Compare our own estimate of each loop against base/std reported by the device
+    const double tolerance = toleranceSpin->value() / 100.0;
+    const QColor drift(255, 180, 180);
+    const int loops[2][3] = {{FieldFreq0, FieldBase0, FieldStd0},
+                             {FieldFreq1, FieldBase1, FieldStd1}};
+    for (const auto &loop : loops) {
+        const RollingStats &freq = stats->field(loop[0]);
+        const RollingStats &base = stats->field(loop[1]);
+        const RollingStats &dstd = stats->field(loop[2]);
+        if (freq.count() == 0 || base.count() == 0 || dstd.count() == 0)
+            continue;
+
+        double deltaMean = freq.mean() - base.last();
+        double deltaStd = freq.stddev() - dstd.last();
+        bool meanDrift = std::abs(deltaMean) > freq.stddev();
+        bool stdDrift = std::abs(deltaStd) > tolerance * qMax(dstd.last(), 1e-9);
+
+        setCell(loop[0], ColDevBase, base.last());
+        setCell(loop[0], ColDevStd, dstd.last());
+        setCell(loop[0], ColDeltaMean, deltaMean, meanDrift ? drift : QColor());
+        setCell(loop[0], ColDeltaStd, deltaStd, stdDrift ? drift : QColor());
+    }
+}
@@ -0,0 +1,49 @@
+// statisticsdialog.h
+#ifndef STATISTICSDIALOG_H
+#define STATISTICSDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QTimer>
+
+#include "rollingstats.h"
+
+class StatisticsDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit StatisticsDialog(LiveStatistics *stats, QWidget *parent = nullptr);
+
+public slots:
+    void refresh();
+
+private slots:
+    void onWindowChanged(int seconds);
+    void onAlphaChanged(double alpha);
+    void onResetClicked();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    enum Column {
+        ColField, ColLast, ColMean, ColStd, ColEwma, ColMin, ColMax,
+        ColP05, ColP50, ColP95, ColDevBase, ColDevStd, ColDeltaMean,
+        ColDeltaStd, ColumnCount
+    };
+    void setCell(int row, int column, double value, const QColor &background = QColor());
+
+    LiveStatistics *stats;
+    QTableWidget   *table;
+    QSpinBox       *windowSpin;
+    QDoubleSpinBox *alphaSpin;
+    QSpinBox       *toleranceSpin;
+    QPushButton    *resetBtn;
+    QTimer         *refreshTimer;
+};
+
+#endif // STATISTICSDIALOG_H
@@ -0,0 +1,78 @@
+// syntheticdevice.cpp
+#include "syntheticdevice.h"
+#include "framedecoder.h"
+
+SyntheticDevice::SyntheticDevice(quint32 seed)
+    : rng(seed)
+{
+}
+
+LiveFrame SyntheticDevice::nextFrame()
+{
+    std::normal_distribution<double> noise(0.0, 3.0);
+    std::uniform_int_distribution<int> chance(0, 999);
+    LiveFrame f;
+    for (int loop = 0; loop < 2; ++loop) {
+        baseline[loop] += noise(rng) * 0.01;
+        if (presenceLeft[loop] == 0 && calLeft[loop] == 0) {
+            const int roll = chance(rng);
+            if (roll < 8)
+                presenceLeft[loop] = 20 + chance(rng) % 60;
+            else if (roll == 999)
+                calLeft[loop] = 15;
+        }
+        const bool present = presenceLeft[loop] > 0;
+        const bool cal = calLeft[loop] > 0;
+        if (present)
+            --presenceLeft[loop];
+        if (cal)
+            --calLeft[loop];
+        // Metal over the loop lowers its inductance and raises the frequency
+        const double freq = baseline[loop] + (present ? 400.0 : 0.0) + noise(rng);
+        f.values[FieldFreq0 + loop] = freq;
+        f.values[FieldState0 + loop] = present ? 1 : 0;
+        f.values[FieldBase0 + loop] = baseline[loop];
+        f.values[FieldStd0 + loop] = 3.0 + noise(rng) * 0.1;
+        f.values[FieldJump0 + loop] = freq - baseline[loop];
+        f.values[FieldOpen0 + loop] = 0.0;
+        f.values[FieldShort0 + loop] = 0.0;
+        f.values[FieldCal0 + loop] = cal ? 1 : 0;
+    }
+    f.values[FieldSens1] = 2;
+    f.values[FieldSens2] = 2;
+    f.values[FieldLoop2Event] = f.values[FieldState1];
+    f.values[FieldDetectMode] = 1;
+    f.validMask = (1u << LiveFieldCount) - 1;
+    f.deviceSeq = seq++;
+    return f;
+}
+
+QByteArray SyntheticDevice::nextChunk(bool binary)
+{
+    const LiveFrame f = nextFrame();
+    if (binary)
+        return BinaryFrame::encode(f, quint32(f.deviceSeq));
+    QByteArray line = "LIVE:";
+    for (int i = 0; i < LiveFieldCount; ++i) {
+        line += i <= FieldShort1 ? QByteArray::number(f.values[i], 'f', 1)
+                                 : QByteArray::number(qint64(f.values[i]));
+        line += ',';
+    }
+    line += QByteArray::number(f.deviceSeq);
+    line += "\r\n";
+    return line;
+}
+
+QByteArray SyntheticDevice::parametersLine()
+{
+    std::uniform_int_distribution<int> value(0, 1000);
+    parameters[value(rng) % parameterCount] = value(rng);
+    QByteArray line = "PARAMETERS:";
+    for (int i = 0; i < parameterCount; ++i) {
+        if (i)
+            line += ',';
+        line += QByteArray::number(parameters[i]);
+    }
+    line += "\r\n";
+    return line;
+}
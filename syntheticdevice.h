@@ -0,0 +1,34 @@
+// syntheticdevice.h
+#ifndef SYNTHETICDEVICE_H
+#define SYNTHETICDEVICE_H
+
+#include <QByteArray>
+#include <random>
+
+#include "liveframe.h"
+
+// Simulated detector for soak tests: two loops with noise and slow
+// baseline drift, vehicles passing over them and the occasional
+// calibration. Frames carry a sequence number, so lost ones are counted.
+class SyntheticDevice {
+public:
+    explicit SyntheticDevice(quint32 seed = 1);
+
+    LiveFrame nextFrame();
+    // One frame as the firmware sends it, binary or as a LIVE: line
+    QByteArray nextChunk(bool binary);
+    // A PARAMETERS: reply with some values changed since the last one
+    QByteArray parametersLine();
+
+private:
+    static const int parameterCount = 22;   // ParametersDialog::parameterNames()
+
+    std::mt19937 rng;
+    quint32 seq = 0;
+    double  baseline[2] = {52000.0, 48000.0};
+    int     presenceLeft[2] = {};
+    int     calLeft[2] = {};
+    int     parameters[parameterCount] = {};
+};
+
+#endif // SYNTHETICDEVICE_H
@@ -0,0 +1,251 @@
+// telemetrydock.cpp
+#include "telemetrydock.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPainter>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableView>
+#include <QVBoxLayout>
+
+namespace {
+
+bool isAnalog(int field)
+{
+    return field <= FieldShort1 && field != FieldState0 && field != FieldState1;
+}
+
+QString unitOf(int field)
+{
+    return isAnalog(field) ? QStringLiteral("Hz") : QString();
+}
+
+QString format(int field, double value)
+{
+    return isAnalog(field) ? QString::number(value, 'f', 1) : QString::number(qint64(value));
+}
+
+} // namespace
+
+TelemetryModel::TelemetryModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    publishTimer = new QTimer(this);
+    publishTimer->setInterval(250);
+    connect(publishTimer, &QTimer::timeout, this, &TelemetryModel::publish);
+    publishTimer->start();
+}
+
+int TelemetryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : LiveFieldCount;
+}
+
+int TelemetryModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TelemetryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+    const int row = index.row();
+    const Field &f = fields[row];
+    if (role == Qt::TextAlignmentRole && index.column() != ColField)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    switch (index.column()) {
+    case ColField: return liveFieldName(row);
+    case ColValue: return f.shownSeen ? format(row, f.shown) : QString();
+    case ColUnit:  return unitOf(row);
+    case ColMin:   return f.shownSeen ? format(row, f.shownMin) : QString();
+    case ColMax:   return f.shownSeen ? format(row, f.shownMax) : QString();
+    }
+    return QVariant();
+}
+
+QVariant TelemetryModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    static const char *const names[ColumnCount] = {
+        QT_TR_NOOP("Field"), QT_TR_NOOP("Value"), QT_TR_NOOP("Unit"),
+        QT_TR_NOOP("Min"), QT_TR_NOOP("Max"), QT_TR_NOOP("Trend")
+    };
+    return tr(names[section]);
+}
+
+void TelemetryModel::addFrame(const LiveFrame &frame)
+{
+    for (int i = 0; i < LiveFieldCount; ++i) {
+        if (!frame.isValid(LiveField(i)))
+            continue;
+        Field &f = fields[i];
+        const double v = frame.values[i];
+        f.latest = v;
+        if (!f.seen || v < f.min)
+            f.min = v;
+        if (!f.seen || v > f.max)
+            f.max = v;
+        f.seen = true;
+        f.fresh = true;
+    }
+}
+
+void TelemetryModel::history(int row, const float *&ring, int &head, int &count) const
+{
+    const Field &f = fields[row];
+    ring = f.ring;
+    head = f.head;
+    count = f.count;
+}
+
+void TelemetryModel::setRefreshInterval(int ms)
+{
+    publishTimer->setInterval(ms);
+}
+
+void TelemetryModel::resetMinMax()
+{
+    for (Field &f : fields) {
+        f.min = f.latest;
+        f.max = f.latest;
+    }
+    publish();
+}
+
+void TelemetryModel::publish()
+{
+    QVector<bool> value(LiveFieldCount, false);
+    QVector<bool> min(LiveFieldCount, false);
+    QVector<bool> max(LiveFieldCount, false);
+    QVector<bool> trend(LiveFieldCount, false);
+    for (int i = 0; i < LiveFieldCount; ++i) {
+        Field &f = fields[i];
+        if (!f.seen)
+            continue;
+        // Compare the text the cell would show, not the raw double
+        value[i] = !f.shownSeen || format(i, f.latest) != format(i, f.shown);
+        min[i] = !f.shownSeen || format(i, f.min) != format(i, f.shownMin);
+        max[i] = !f.shownSeen || format(i, f.max) != format(i, f.shownMax);
+        f.shown = f.latest;
+        f.shownMin = f.min;
+        f.shownMax = f.max;
+        f.shownSeen = true;
+
+        if (!f.fresh)
+            continue;
+        f.fresh = false;
+        const bool same = f.count > 0 && f.ring[(f.head + historySize - 1) % historySize] == float(f.latest);
+        f.flatRun = same ? f.flatRun + 1 : 0;
+        f.ring[f.head] = float(f.latest);
+        f.head = (f.head + 1) % historySize;
+        f.count = qMin(f.count + 1, historySize);
+        // A line that is flat across the whole sparkline looks the same shifted
+        trend[i] = f.flatRun < historySize;
+    }
+    emitChanged(ColValue, value);
+    emitChanged(ColMin, min);
+    emitChanged(ColMax, max);
+    emitChanged(ColTrend, trend);
+}
+
+void TelemetryModel::emitChanged(int column, const QVector<bool> &changed)
+{
+    // One signal per run of adjacent changed rows
+    for (int row = 0; row < changed.size(); ++row) {
+        if (!changed[row])
+            continue;
+        int last = row;
+        while (last + 1 < changed.size() && changed[last + 1])
+            ++last;
+        emit dataChanged(index(row, column), index(last, column), {Qt::DisplayRole});
+        row = last;
+    }
+}
+
+void SparklineDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                              const QModelIndex &index) const
+{
+    QStyledItemDelegate::paint(painter, option, index);
+    auto *model = qobject_cast<const TelemetryModel *>(index.model());
+    if (!model)
+        return;
+    const float *ring;
+    int head, count;
+    model->history(index.row(), ring, head, count);
+    if (count < 2)
+        return;
+
+    const int start = (head + TelemetryModel::historySize - count) % TelemetryModel::historySize;
+    float lo = ring[start], hi = ring[start];
+    for (int k = 1; k < count; ++k) {
+        const float v = ring[(start + k) % TelemetryModel::historySize];
+        lo = qMin(lo, v);
+        hi = qMax(hi, v);
+    }
+    const QRectF r = QRectF(option.rect).adjusted(3, 3, -3, -3);
+    const float range = hi > lo ? hi - lo : 1.0f;
+    QPolygonF line;
+    line.reserve(count);
+    for (int k = 0; k < count; ++k) {
+        const float v = ring[(start + k) % TelemetryModel::historySize];
+        line.append(QPointF(r.left() + r.width() * k / (TelemetryModel::historySize - 1),
+                            r.bottom() - r.height() * (v - lo) / range));
+    }
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(QPen(option.state & QStyle::State_Selected
+                             ? option.palette.highlightedText().color()
+                             : QColor(0, 90, 200), 1.2));
+    painter->drawPolyline(line);
+    painter->restore();
+}
+
+QSize SparklineDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    QSize size = QStyledItemDelegate::sizeHint(option, index);
+    size.setWidth(qMax(size.width(), 120));
+    return size;
+}
+
+TelemetryDock::TelemetryDock(QWidget *parent)
+    : QDockWidget(tr("Telemetry"), parent)
+{
+    setObjectName("telemetryDock");
+    auto *content = new QWidget(this);
+    telemetry = new TelemetryModel(this);
+
+    auto *view = new QTableView(content);
+    view->setModel(telemetry);
+    view->setItemDelegateForColumn(TelemetryModel::ColTrend, new SparklineDelegate(view));
+    view->verticalHeader()->setVisible(false);
+    view->verticalHeader()->setDefaultSectionSize(view->fontMetrics().height() + 6);
+    view->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    view->horizontalHeader()->setSectionResizeMode(TelemetryModel::ColTrend, QHeaderView::Stretch);
+    view->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    auto *rateSpin = new QSpinBox(content);
+    rateSpin->setRange(50, 5000);
+    rateSpin->setSingleStep(50);
+    rateSpin->setValue(250);
+    rateSpin->setSuffix(tr(" ms"));
+    connect(rateSpin, &QSpinBox::valueChanged, telemetry, &TelemetryModel::setRefreshInterval);
+
+    auto *resetBtn = new QPushButton(tr("Reset Min/Max"), content);
+    connect(resetBtn, &QPushButton::clicked, telemetry, &TelemetryModel::resetMinMax);
+
+    auto *controls = new QHBoxLayout;
+    controls->addWidget(new QLabel(tr("Refresh:"), content));
+    controls->addWidget(rateSpin);
+    controls->addStretch();
+    controls->addWidget(resetBtn);
+
+    auto *layout = new QVBoxLayout(content);
+    layout->addLayout(controls);
+    layout->addWidget(view, 1);
+    setWidget(content);
+}
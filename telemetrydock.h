@@ -0,0 +1,86 @@
+// telemetrydock.h
+#ifndef TELEMETRYDOCK_H
+#define TELEMETRYDOCK_H
+
+#include <QAbstractTableModel>
+#include <QDockWidget>
+#include <QStyledItemDelegate>
+#include <QTimer>
+#include <QVector>
+
+#include "liveframe.h"
+
+// Every LIVE field with its value, unit, min/max since reset and recent
+// history. Frames only update plain arrays; a timer publishes them and
+// emits dataChanged for the cells whose text or sparkline changed.
+class TelemetryModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column { ColField, ColValue, ColUnit, ColMin, ColMax, ColTrend, ColumnCount };
+    static const int historySize = 60;  // sparkline points, one per publish
+
+    explicit TelemetryModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    void addFrame(const LiveFrame &frame);
+
+    // Oldest first; count may be below historySize
+    void history(int row, const float *&ring, int &head, int &count) const;
+
+public slots:
+    void setRefreshInterval(int ms);
+    void resetMinMax();
+    void publish();
+
+private:
+    struct Field {
+        double latest = 0.0;    // written per frame
+        double min = 0.0;
+        double max = 0.0;
+        bool   seen = false;
+        bool   fresh = false;   // frame since the last publish
+        // Published state
+        double shown = 0.0;
+        double shownMin = 0.0;
+        double shownMax = 0.0;
+        bool   shownSeen = false;
+        float  ring[historySize] = {};
+        int    head = 0;
+        int    count = 0;
+        int    flatRun = 0;     // publishes in a row with an unchanged value
+    };
+    void emitChanged(int column, const QVector<bool> &changed);
+
+    Field   fields[LiveFieldCount];
+    QTimer *publishTimer;
+};
+
+// Draws the history of a TelemetryModel row as a polyline
+class SparklineDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+class TelemetryDock : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit TelemetryDock(QWidget *parent = nullptr);
+    TelemetryModel *model() const { return telemetry; }
+
+private:
+    TelemetryModel *telemetry;
+};
+
+#endif // TELEMETRYDOCK_H
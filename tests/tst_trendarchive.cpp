@@ -0,0 +1,81 @@
+// tst_trendarchive.cpp
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "trendarchive.h"
+
+class TestTrendArchive : public QObject {
+    Q_OBJECT
+
+private slots:
+    void fullRetention_data();
+    void fullRetention();
+    void restartContinuesStep();
+
+private:
+    static LiveFrame frame(double freq0)
+    {
+        LiveFrame f;
+        f.values[FieldFreq0] = freq0;
+        f.validMask = 1u << FieldFreq0;
+        return f;
+    }
+};
+
+void TestTrendArchive::fullRetention_data()
+{
+    QTest::addColumn<int>("level");
+    QTest::newRow("seconds") << 0;
+    QTest::newRow("minutes") << 1;
+    QTest::newRow("hours") << 2;
+}
+
+void TestTrendArchive::fullRetention()
+{
+    QFETCH(int, level);
+    QTemporaryDir dir;
+    TrendArchive archive;
+    QVERIFY(archive.open(dir.filePath("t.ltr"), true));
+
+    // One frame per step of the level over its whole retention, ending in
+    // the middle of an unaligned step like the dialog's "now"
+    const qint64 step = archive.levelStep(level);
+    const qint64 rows = archive.levelRows(level);
+    const qint64 toS = 1700000000 + step / 2 + 7;
+    const qint64 lastStep = toS - toS % step;
+    for (qint64 k = rows - 1; k >= 0; --k)
+        archive.addFrame(frame(double(k)), (lastStep - k * step) * 1000000);
+
+    const QVector<TrendPoint> points = archive.read(level, 0, toS - step * rows, toS);
+    QCOMPARE(points.size(), int(rows));
+    QCOMPARE(points.first().timeS, lastStep - (rows - 1) * step);
+    QCOMPARE(points.last().timeS, lastStep);
+    QCOMPARE(points.first().avg, float(rows - 1));
+    QCOMPARE(points.last().avg, 0.0f);
+}
+
+void TestTrendArchive::restartContinuesStep()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath("t.ltr");
+    const qint64 hourS = 1700000000 - 1700000000 % 3600;
+    {
+        TrendArchive archive;
+        QVERIFY(archive.open(fileName, true));
+        archive.addFrame(frame(10.0), hourS * 1000000);
+        archive.addFrame(frame(30.0), (hourS + 60) * 1000000);
+    }
+    TrendArchive archive;
+    QVERIFY(archive.open(fileName, true));
+    archive.addFrame(frame(20.0), (hourS + 120) * 1000000);
+
+    const QVector<TrendPoint> points = archive.read(2, 0, hourS, hourS + 120);
+    QCOMPARE(points.size(), 1);
+    QCOMPARE(points[0].min, 10.0f);
+    QCOMPARE(points[0].max, 30.0f);
+    QCOMPARE(points[0].avg, 20.0f);
+}
+
+QTEST_APPLESS_MAIN(TestTrendArchive)
+
+#include "tst_trendarchive.moc"
@@ -0,0 +1,18 @@
+QT       = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_trendarchive
+
+# The archive is compiled from the application directory
+INCLUDEPATH += ..
+
+SOURCES += \
+    ../liveframe.cpp \
+    ../trendarchive.cpp \
+    tst_trendarchive.cpp
+
+HEADERS += \
+    ../liveframe.h \
+    ../trendarchive.h
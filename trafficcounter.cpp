@@ -0,0 +1,239 @@
+// trafficcounter.cpp
+#include "trafficcounter.h"
+#include "looptrace.h"
+#include <QDateTime>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QTimeZone>
+#include <algorithm>
+#include <cmath>
+
+TrafficCounter::TrafficCounter(const TrafficSettings &settings)
+{
+    setSettings(settings);
+}
+
+void TrafficCounter::setSettings(const TrafficSettings &settings)
+{
+    cfg = settings;
+    cfg.binS = qMax(1.0, cfg.binS);
+    cfg.histogramStepS = qMax(0.01, cfg.histogramStepS);
+    cfg.histogramBuckets = qMax(1, cfg.histogramBuckets);
+    clear();
+}
+
+void TrafficCounter::clear()
+{
+    for (LoopState &s : loops)
+        s = LoopState();
+    origin = -1;
+    list.clear();
+    binList.clear();
+    firstBin = 0;
+    for (QVector<int> &h : histogram)
+        h.fill(0, cfg.histogramBuckets);
+    changedFrom = 0;
+    ++changes;
+}
+
+double TrafficCounter::seconds(qint64 timeUs)
+{
+    if (origin < 0) {
+        const qint64 binUs = qRound64(cfg.binS * 1e6);
+        origin = timeUs - (timeUs % binUs + binUs) % binUs;
+    }
+    return (timeUs - origin) / 1e6;
+}
+
+void TrafficCounter::addSample(int loop, qint64 timeUs, bool present)
+{
+    const double timeS = seconds(timeUs);
+    LoopState &s = loops[loop - 1];
+    switch (s.state) {
+    case Empty:
+        if (present) {
+            s.state = Entering;
+            s.entryS = timeS;
+        }
+        break;
+    case Entering:
+        // Confirmed once it lasted minPresenceS, whichever sample shows it
+        if (timeS - s.entryS >= cfg.minPresenceS) {
+            s.state = present ? Occupied : Leaving;
+            s.exitS = timeS;
+        } else if (!present) {
+            s.state = Empty;
+        }
+        break;
+    case Occupied:
+        if (!present) {
+            s.state = Leaving;
+            s.exitS = timeS;
+        }
+        break;
+    case Leaving:
+        if (present && timeS - s.exitS < cfg.minGapS) {
+            s.state = Occupied;
+        } else if (present) {
+            finish(loop, s.entryS, s.exitS);
+            s.state = Entering;
+            s.entryS = timeS;
+        } else if (timeS - s.exitS >= cfg.minGapS) {
+            finish(loop, s.entryS, s.exitS);
+            s.state = Empty;
+        }
+        break;
+    }
+}
+
+void TrafficCounter::count(const LoopTrace &loop1, qint64 originUs1,
+                           const LoopTrace &loop2, qint64 originUs2)
+{
+    clear();
+
+    // Presence intervals of both loops as one time-ordered transition list
+    struct Transition {
+        qint64 timeUs;
+        int    loop;
+        bool   present;
+    };
+    QVector<Transition> transitions;
+    const LoopTrace *traces[2] = {&loop1, &loop2};
+    const qint64 origins[2] = {originUs1, originUs2};
+    for (int l = 0; l < 2; ++l) {
+        const LoopTrace &trace = *traces[l];
+        const SampleStore &samples = trace.samples();
+        const qint64 originUs = origins[l];
+        const EventIndex &events = trace.events();
+        QVector<int> presences;
+        for (int i = 0; i < events.size(); ++i) {
+            if (events.at(i).kind == EventPresence)
+                presences.append(i);
+        }
+        for (int p = 0; p < presences.size(); ++p) {
+            const DetectionEvent &e = events.at(presences[p]);
+            transitions.append({originUs + samples.timeUs(e.firstSample), l + 1, true});
+            if (e.lastSample < 0 || e.lastSample >= trace.size())
+                continue;
+            const double exitS = trace.time(e.lastSample);
+            transitions.append({originUs + samples.timeUs(e.lastSample), l + 1, false});
+            // Live, the first absent sample at least minGapS after the exit
+            // ends the vehicle; add that sample unless the next presence
+            // starts before it
+            int k = qMax(e.lastSample,
+                         samples.lowerBoundTime(qRound64((exitS + cfg.minGapS) * 1e6)) - 1);
+            while (k < trace.size() && trace.time(k) - exitS < cfg.minGapS)
+                ++k;
+            const int next = p + 1 < presences.size() ? events.at(presences[p + 1]).firstSample
+                                                      : trace.size();
+            if (k < next)
+                transitions.append({originUs + samples.timeUs(k), l + 1, false});
+        }
+    }
+    std::stable_sort(transitions.begin(), transitions.end(),
+                     [](const Transition &a, const Transition &b) { return a.timeUs < b.timeUs; });
+    for (const Transition &t : transitions)
+        addSample(t.loop, t.timeUs, t.present);
+}
+
+qint64 TrafficCounter::binIndex(double timeS) const
+{
+    return qint64(std::floor(timeS / cfg.binS));
+}
+
+TrafficBin &TrafficCounter::binAt(qint64 index)
+{
+    if (binList.isEmpty())
+        firstBin = index;
+    if (index < firstBin) {
+        // Loops finish out of order; earlier bins shift the later ones
+        binList.insert(0, firstBin - index, TrafficBin());
+        firstBin = index;
+        markChanged(0);
+    }
+    const int i = int(index - firstBin);
+    if (i >= binList.size())
+        binList.resize(i + 1);
+    markChanged(i);
+    return binList[i];
+}
+
+void TrafficCounter::markChanged(int bin)
+{
+    changedFrom = changedFrom < 0 ? bin : qMin(changedFrom, bin);
+}
+
+void TrafficCounter::finish(int loop, double entryS, double exitS)
+{
+    LoopState &s = loops[loop - 1];
+    const int index = int(list.size());
+    Vehicle v{loop, entryS, exitS};
+
+    if (s.lastExitS >= 0.0) {
+        const int bucket = qBound(0, int((entryS - s.lastExitS) / cfg.histogramStepS),
+                                  cfg.histogramBuckets - 1);
+        ++histogram[loop - 1][bucket];
+    }
+    s.lastExitS = exitS;
+
+    // The same vehicle on the other loop: the first loop entered gives the direction
+    LoopState &other = loops[2 - loop];
+    if (other.unpaired >= 0 && qAbs(list[other.unpaired].entryS - entryS) <= cfg.pairWindowS) {
+        Vehicle &u = list[other.unpaired];
+        v.direction = (u.loop == 1) == (u.entryS <= entryS) ? Direction12 : Direction21;
+        u.direction = v.direction;
+        u.pair = index;
+        v.pair = other.unpaired;
+        other.unpaired = -1;
+        ++binAt(binIndex(qMin(u.entryS, entryS))).direction[v.direction - 1];
+    } else {
+        s.unpaired = index;
+    }
+    list.append(v);
+
+    TrafficBin &b = binAt(binIndex(entryS));
+    ++b.count[loop - 1];
+    b.dwellS[loop - 1] += exitS - entryS;
+
+    // Occupied time of every bin the presence overlaps
+    for (qint64 k = binIndex(entryS); k <= binIndex(exitS); ++k) {
+        const double from = qMax(entryS, k * cfg.binS);
+        const double to = qMin(exitS, (k + 1) * cfg.binS);
+        if (to > from)
+            binAt(k).occupiedS[loop - 1] += to - from;
+    }
+    ++changes;
+}
+
+int TrafficCounter::takeChangedFrom()
+{
+    const int from = changedFrom;
+    changedFrom = -1;
+    return from;
+}
+
+bool TrafficCounter::exportBins(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+    out << "bin_start,bin_s,count1,count2,occupancy1_pct,occupancy2_pct,"
+        << "mean_dwell1_s,mean_dwell2_s,direction_12,direction_21\n";
+    for (int i = 0; i < binList.size(); ++i) {
+        const TrafficBin &b = binList[i];
+        // ISO 8601 in UTC; bins of fractional seconds need the milliseconds
+        out << QDateTime::fromMSecsSinceEpoch(binStartUs(i) / 1000, QTimeZone::UTC)
+                   .toString(Qt::ISODateWithMs)
+            << ',' << cfg.binS;
+        for (int l = 0; l < 2; ++l)
+            out << ',' << b.count[l];
+        for (int l = 0; l < 2; ++l)
+            out << ',' << QString::number(100.0 * b.occupiedS[l] / cfg.binS, 'f', 2);
+        for (int l = 0; l < 2; ++l)
+            out << ',' << (b.count[l] ? QString::number(b.dwellS[l] / b.count[l], 'f', 3) : QString());
+        out << ',' << b.direction[0] << ',' << b.direction[1] << '\n';
+    }
+    out.flush();
+    return file.commit();
+}
@@ -0,0 +1,105 @@
+// trafficcounter.h
+#ifndef TRAFFICCOUNTER_H
+#define TRAFFICCOUNTER_H
+
+#include <QString>
+#include <QVector>
+
+class LoopTrace;
+
+struct TrafficSettings {
+    double binS = 60.0;             // length of a counting interval
+    double minPresenceS = 0.1;      // shorter presences are noise
+    double minGapS = 0.1;           // shorter gaps join two presences
+    double pairWindowS = 2.0;       // max entry offset of one vehicle on both loops
+    double histogramStepS = 0.5;    // gap histogram bucket width
+    int    histogramBuckets = 40;   // the last one also holds longer gaps
+};
+
+enum TrafficDirection {
+    DirectionUnknown,   // seen on one loop only
+    Direction12,        // loop 1 first
+    Direction21         // loop 2 first
+};
+
+struct Vehicle {
+    int    loop;            // 1 or 2
+    double entryS;          // seconds since TrafficCounter::originUs()
+    double exitS;
+    TrafficDirection direction = DirectionUnknown;
+    int    pair = -1;       // index of the same vehicle on the other loop
+
+    double dwellS() const { return exitS - entryS; }
+};
+
+struct TrafficBin {
+    int    count[2] = {};
+    double occupiedS[2] = {};
+    double dwellS[2] = {};          // sum over the vehicles counted
+    int    direction[2] = {};       // Direction12, Direction21
+};
+
+// Turns per-sample presence states of both loops into vehicles. Each loop
+// runs a small debounce state machine (empty, entering, occupied,
+// leaving); a vehicle is final once its exit has outlasted minGapS. Per
+// vehicle the engine updates the interval bins it covers, the gap
+// histogram of its loop and pairs it with an entry on the other loop
+// within pairWindowS to infer the direction. Every step is O(1), so it
+// keeps up with live frames and with captures replayed at disk speed.
+// Samples of both loops are timed on one clock, in microseconds since
+// the epoch; the counter keeps its own origin at the start of the first
+// bin, so bins line up with the clock.
+class TrafficCounter {
+public:
+    explicit TrafficCounter(const TrafficSettings &settings = TrafficSettings());
+
+    void setSettings(const TrafficSettings &settings);  // also clears
+    const TrafficSettings &settings() const { return cfg; }
+    void clear();
+
+    void addSample(int loop, qint64 timeUs, bool present);
+    // Recount from the presence intervals of two recorded traces; time 0
+    // of each trace is at originUs1/originUs2 on the counter's clock
+    void count(const LoopTrace &loop1, qint64 originUs1,
+               const LoopTrace &loop2, qint64 originUs2);
+
+    const QVector<Vehicle> &vehicles() const { return list; }
+    const QVector<TrafficBin> &bins() const { return binList; }
+    qint64 originUs() const { return origin; }     // -1 before the first sample
+    qint64 binStartUs(int bin) const { return origin + qRound64((firstBin + bin) * cfg.binS * 1e6); }
+    const QVector<int> &gapHistogram(int loop) const { return histogram[loop - 1]; }
+
+    // Lowest bin changed since the last call, -1 if none; changes after
+    // clear() report 0 with bins() possibly shorter than before
+    int takeChangedFrom();
+    int revision() const { return changes; }
+
+    bool exportBins(const QString &fileName) const;
+
+private:
+    enum State { Empty, Entering, Occupied, Leaving };
+    struct LoopState {
+        State  state = Empty;
+        double entryS = 0.0;
+        double exitS = 0.0;
+        double lastExitS = -1.0;    // of the previous vehicle, for gaps
+        int    unpaired = -1;       // last vehicle without a partner
+    };
+    double seconds(qint64 timeUs);
+    void finish(int loop, double entryS, double exitS);
+    TrafficBin &binAt(qint64 index);
+    qint64 binIndex(double timeS) const;
+    void markChanged(int bin);
+
+    TrafficSettings cfg;
+    qint64 origin = -1;
+    LoopState loops[2];
+    QVector<Vehicle> list;
+    QVector<TrafficBin> binList;
+    qint64 firstBin = 0;
+    QVector<int> histogram[2];
+    int changedFrom = -1;
+    int changes = 0;
+};
+
+#endif // TRAFFICCOUNTER_H
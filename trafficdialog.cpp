@@ -0,0 +1,272 @@
+// trafficdialog.cpp
+#include "trafficdialog.h"
+#include <QDateTime>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+TrafficBinModel::TrafficBinModel(const TrafficCounter *counter, QObject *parent)
+    : QAbstractTableModel(parent), counter(counter)
+{
+}
+
+int TrafficBinModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows;
+}
+
+int TrafficBinModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TrafficBinModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= counter->bins().size())
+        return QVariant();
+    if (role == Qt::TextAlignmentRole)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    const TrafficBin &b = counter->bins().at(index.row());
+    const double binS = counter->settings().binS;
+    switch (index.column()) {
+    case ColStart:
+        return QDateTime::fromMSecsSinceEpoch(counter->binStartUs(index.row()) / 1000)
+            .toString("yyyy-MM-dd HH:mm:ss");
+    case ColCount1:      return b.count[0];
+    case ColCount2:      return b.count[1];
+    case ColOccupancy1:  return QString::number(100.0 * b.occupiedS[0] / binS, 'f', 1);
+    case ColOccupancy2:  return QString::number(100.0 * b.occupiedS[1] / binS, 'f', 1);
+    case ColDwell1:      return b.count[0] ? QString::number(b.dwellS[0] / b.count[0], 'f', 2) : QString();
+    case ColDwell2:      return b.count[1] ? QString::number(b.dwellS[1] / b.count[1], 'f', 2) : QString();
+    case ColDirection12: return b.direction[0];
+    case ColDirection21: return b.direction[1];
+    }
+    return QVariant();
+}
+
+QVariant TrafficBinModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    static const char *const names[ColumnCount] = {
+        QT_TR_NOOP("Start"), QT_TR_NOOP("Count 1"), QT_TR_NOOP("Count 2"),
+        QT_TR_NOOP("Occ. 1 (%)"), QT_TR_NOOP("Occ. 2 (%)"),
+        QT_TR_NOOP("Dwell 1 (s)"), QT_TR_NOOP("Dwell 2 (s)"),
+        QT_TR_NOOP("1 first"), QT_TR_NOOP("2 first")
+    };
+    return tr(names[section]);
+}
+
+void TrafficBinModel::refresh(int changedFrom)
+{
+    const int count = counter->bins().size();
+    if (count < rows) {
+        // Cleared or recounted
+        beginResetModel();
+        rows = count;
+        endResetModel();
+        return;
+    }
+    if (changedFrom >= 0 && changedFrom < rows)
+        emit dataChanged(index(changedFrom, 0), index(rows - 1, ColumnCount - 1), {Qt::DisplayRole});
+    if (count > rows) {
+        beginInsertRows(QModelIndex(), rows, count - 1);
+        rows = count;
+        endInsertRows();
+    }
+}
+
+TrafficDialog::TrafficDialog(TrafficCounter *counter, QWidget *parent)
+    : QDialog(parent), counter(counter)
+{
+    setWindowTitle(tr("Traffic Count"));
+    const TrafficSettings &s = counter->settings();
+
+    auto makeSpin = [this](double min, double max, int decimals, double value) {
+        auto *spin = new QDoubleSpinBox(this);
+        spin->setRange(min, max);
+        spin->setDecimals(decimals);
+        spin->setSuffix(tr(" s"));
+        spin->setValue(value);
+        return spin;
+    };
+    binSpin = makeSpin(1.0, 86400.0, 0, s.binS);
+    presenceSpin = makeSpin(0.0, 60.0, 3, s.minPresenceS);
+    gapSpin = makeSpin(0.0, 60.0, 3, s.minGapS);
+    pairSpin = makeSpin(0.0, 60.0, 2, s.pairWindowS);
+    stepSpin = makeSpin(0.01, 600.0, 2, s.histogramStepS);
+    bucketSpin = new QSpinBox(this);
+    bucketSpin->setRange(1, 1000);
+    bucketSpin->setValue(s.histogramBuckets);
+
+    applyBtn = new QPushButton(tr("Apply && Recount"), this);
+    connect(applyBtn, &QPushButton::clicked, this, &TrafficDialog::onApplyClicked);
+    exportBtn = new QPushButton(tr("Export CSV..."), this);
+    connect(exportBtn, &QPushButton::clicked, this, &TrafficDialog::onExportClicked);
+
+    auto *form = new QFormLayout;
+    form->addRow(tr("Interval:"), binSpin);
+    form->addRow(tr("Min presence:"), presenceSpin);
+    form->addRow(tr("Min gap:"), gapSpin);
+    form->addRow(tr("Pair window:"), pairSpin);
+    form->addRow(tr("Histogram step:"), stepSpin);
+    form->addRow(tr("Histogram buckets:"), bucketSpin);
+    form->addRow(applyBtn);
+    form->addRow(exportBtn);
+
+    summaryLabel = new QLabel(this);
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    auto *side = new QVBoxLayout;
+    side->addLayout(form);
+    side->addWidget(summaryLabel);
+    side->addStretch();
+
+    model = new TrafficBinModel(counter, this);
+    binView = new QTableView(this);
+    binView->setModel(model);
+    binView->verticalHeader()->setVisible(false);
+    binView->verticalHeader()->setDefaultSectionSize(binView->fontMetrics().height() + 6);
+    binView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    binView->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    // Gap histogram, both loops side by side per bucket
+    auto *series = new QBarSeries;
+    for (int l = 0; l < 2; ++l) {
+        gapSets[l] = new QBarSet(tr("Loop %1").arg(l + 1));
+        series->append(gapSets[l]);
+    }
+    auto *chart = new QChart;
+    chart->setTitle(tr("Gaps between vehicles"));
+    chart->addSeries(series);
+    gapAxisX = new QBarCategoryAxis;
+    gapAxisY = new QValueAxis;
+    gapAxisY->setLabelFormat("%d");
+    chart->addAxis(gapAxisX, Qt::AlignBottom);
+    chart->addAxis(gapAxisY, Qt::AlignLeft);
+    series->attachAxis(gapAxisX);
+    series->attachAxis(gapAxisY);
+    auto *chartView = new QChartView(chart, this);
+    chartView->setRenderHint(QPainter::Antialiasing);
+
+    auto *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(binView);
+    splitter->addWidget(chartView);
+
+    auto *mainLayout = new QHBoxLayout(this);
+    mainLayout->addLayout(side);
+    mainLayout->addWidget(splitter, 1);
+
+    setMinimumSize(1000, 600);
+
+    // Live samples change the newest bin many times a second
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(500);
+    connect(refreshTimer, &QTimer::timeout, this, &TrafficDialog::refresh);
+}
+
+void TrafficDialog::refresh()
+{
+    if (counter->revision() == shownRevision)
+        return;
+    shownRevision = counter->revision();
+    model->refresh(counter->takeChangedFrom());
+    updateSummary();
+    updateHistogram();
+}
+
+void TrafficDialog::updateSummary()
+{
+    int total[2] = {};
+    double dwell[2] = {};
+    int direction[2] = {};
+    for (const Vehicle &v : counter->vehicles()) {
+        ++total[v.loop - 1];
+        dwell[v.loop - 1] += v.dwellS();
+    }
+    for (const TrafficBin &b : counter->bins()) {
+        direction[0] += b.direction[0];
+        direction[1] += b.direction[1];
+    }
+    QString text;
+    for (int l = 0; l < 2; ++l) {
+        text += tr("Loop %1: %2 vehicles, mean dwell %3 s\n")
+                    .arg(l + 1)
+                    .arg(total[l])
+                    .arg(total[l] ? QString::number(dwell[l] / total[l], 'f', 2) : QString("-"));
+    }
+    text += tr("Loop 1 first: %1\nLoop 2 first: %2")
+                .arg(direction[0])
+                .arg(direction[1]);
+    summaryLabel->setText(text);
+}
+
+void TrafficDialog::updateHistogram()
+{
+    const TrafficSettings &s = counter->settings();
+    const int buckets = counter->gapHistogram(1).size();
+    if (gapAxisX->count() != buckets) {
+        QStringList categories;
+        for (int i = 0; i < buckets; ++i)
+            categories.append(i + 1 < buckets ? QString::number(i * s.histogramStepS, 'g', 4)
+                                              : QString(">%1").arg(i * s.histogramStepS, 0, 'g', 4));
+        gapAxisX->clear();
+        gapAxisX->append(categories);
+    }
+    int peak = 1;
+    for (int l = 0; l < 2; ++l) {
+        const QVector<int> &h = counter->gapHistogram(l + 1);
+        QList<qreal> values;
+        values.reserve(h.size());
+        for (int n : h) {
+            values.append(n);
+            peak = qMax(peak, n);
+        }
+        gapSets[l]->remove(0, gapSets[l]->count());
+        gapSets[l]->append(values);
+    }
+    gapAxisY->setRange(0, peak);
+}
+
+void TrafficDialog::onApplyClicked()
+{
+    TrafficSettings s;
+    s.binS = binSpin->value();
+    s.minPresenceS = presenceSpin->value();
+    s.minGapS = gapSpin->value();
+    s.pairWindowS = pairSpin->value();
+    s.histogramStepS = stepSpin->value();
+    s.histogramBuckets = bucketSpin->value();
+    // Different bucket labels or bin starts; rebuild everything shown
+    gapAxisX->clear();
+    emit settingsChanged(s);
+    refresh();
+}
+
+void TrafficDialog::onExportClicked()
+{
+    QString fn = QFileDialog::getSaveFileName(this, tr("Export Traffic Bins"), QString(),
+                                              tr("CSV (*.csv)"));
+    if (fn.isEmpty())
+        return;
+    if (!counter->exportBins(fn))
+        summaryLabel->setText(tr("Cannot write %1").arg(fn));
+}
+
+void TrafficDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    refresh();
+    refreshTimer->start();
+}
+
+void TrafficDialog::hideEvent(QHideEvent *event)
+{
+    refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
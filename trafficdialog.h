@@ -0,0 +1,91 @@
+// trafficdialog.h
+#ifndef TRAFFICDIALOG_H
+#define TRAFFICDIALOG_H
+
+#include <QAbstractTableModel>
+#include <QDialog>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableView>
+#include <QTimer>
+#include <QtCharts/QBarCategoryAxis>
+#include <QtCharts/QBarSeries>
+#include <QtCharts/QBarSet>
+#include <QtCharts/QChartView>
+#include <QtCharts/QValueAxis>
+
+#include "trafficcounter.h"
+
+// The interval bins of a TrafficCounter, one row per bin. refresh() only
+// announces the rows from the lowest changed bin on.
+class TrafficBinModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column { ColStart, ColCount1, ColCount2, ColOccupancy1, ColOccupancy2,
+                  ColDwell1, ColDwell2, ColDirection12, ColDirection21, ColumnCount };
+
+    explicit TrafficBinModel(const TrafficCounter *counter, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    void refresh(int changedFrom);
+
+private:
+    const TrafficCounter *counter;
+    int rows = 0;
+};
+
+// Vehicle counts, occupancy and direction per interval with the gap
+// histogram of both loops. Apply changes the settings and recounts
+// everything recorded or loaded so far; live samples keep adding to it.
+class TrafficDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit TrafficDialog(TrafficCounter *counter, QWidget *parent = nullptr);
+
+signals:
+    void settingsChanged(const TrafficSettings &settings);
+
+public slots:
+    void refresh();
+
+private slots:
+    void onApplyClicked();
+    void onExportClicked();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void updateSummary();
+    void updateHistogram();
+
+    TrafficCounter  *counter;
+    TrafficBinModel *model;
+    int              shownRevision = -1;
+    QDoubleSpinBox  *binSpin;
+    QDoubleSpinBox  *presenceSpin;
+    QDoubleSpinBox  *gapSpin;
+    QDoubleSpinBox  *pairSpin;
+    QDoubleSpinBox  *stepSpin;
+    QSpinBox        *bucketSpin;
+    QPushButton     *applyBtn;
+    QPushButton     *exportBtn;
+    QLabel          *summaryLabel;
+    QTableView      *binView;
+    QBarSet         *gapSets[2];
+    QBarCategoryAxis *gapAxisX;
+    QValueAxis      *gapAxisY;
+    QTimer          *refreshTimer;
+};
+
+#endif // TRAFFICDIALOG_H
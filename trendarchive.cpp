@@ -0,0 +1,254 @@
+// trendarchive.cpp
+#include "trendarchive.h"
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const LiveField fields[TrendArchive::fieldCount] = {
+    FieldFreq0, FieldFreq1, FieldBase0, FieldBase1, FieldStd0, FieldStd1,
+    FieldOpen0, FieldOpen1, FieldShort0, FieldShort1
+};
+
+// 1 day of seconds, 31 days of minutes, 366 days of hours
+const quint32 levelSteps[TrendArchive::levelCount] = {1, 60, 3600};
+const quint32 levelRowCounts[TrendArchive::levelCount] = {86400, 44640, 8784};
+
+const int rowSize = 8 + TrendArchive::fieldCount * 4 * 4;
+
+qint64 archiveSize()
+{
+    qint64 size = TrendFormat::headerSize;
+    for (int l = 0; l < TrendArchive::levelCount; ++l)
+        size += qint64(levelRowCounts[l]) * rowSize;
+    return size;
+}
+
+} // namespace
+
+LiveField TrendArchive::field(int index)
+{
+    return fields[index];
+}
+
+TrendArchive::~TrendArchive()
+{
+    close();
+}
+
+bool TrendArchive::open(const QString &fileName, bool write)
+{
+    close();
+    file.setFileName(fileName);
+    const bool exists = file.exists() && file.size() > 0;
+    if (!exists && !write)
+        return false;
+    if (!file.open(write ? QIODevice::ReadWrite : QIODevice::ReadOnly))
+        return false;
+
+    const qint64 size = archiveSize();
+    if (!exists) {
+        // Zero-filled rows carry stamp 0 and read as empty
+        if (!file.resize(size)) {
+            file.close();
+            return false;
+        }
+        QByteArray header(TrendFormat::headerSize, '\0');
+        uchar *h = reinterpret_cast<uchar *>(header.data());
+        std::memcpy(h, TrendFormat::magic, 8);
+        qToLittleEndian<quint32>(TrendFormat::version, h + 8);
+        qToLittleEndian<quint32>(fieldCount, h + 12);
+        qToLittleEndian<quint32>(levelCount, h + 16);
+        for (int l = 0; l < levelCount; ++l) {
+            qToLittleEndian<quint32>(levelSteps[l], h + 20 + l * 8);
+            qToLittleEndian<quint32>(levelRowCounts[l], h + 24 + l * 8);
+        }
+        file.write(header);
+        file.flush();
+    }
+    if (file.size() != size) {
+        file.close();
+        return false;
+    }
+
+    base = file.map(0, size);
+    if (!base) {
+        file.close();
+        return false;
+    }
+    // Layouts written by other settings are refused, never reinterpreted
+    bool ok = std::memcmp(base, TrendFormat::magic, 8) == 0
+              && qFromLittleEndian<quint32>(base + 8) == TrendFormat::version
+              && qFromLittleEndian<quint32>(base + 12) == quint32(fieldCount)
+              && qFromLittleEndian<quint32>(base + 16) == quint32(levelCount);
+    for (int l = 0; ok && l < levelCount; ++l) {
+        ok = qFromLittleEndian<quint32>(base + 20 + l * 8) == levelSteps[l]
+             && qFromLittleEndian<quint32>(base + 24 + l * 8) == levelRowCounts[l];
+    }
+    if (!ok) {
+        file.unmap(base);
+        base = nullptr;
+        file.close();
+        return false;
+    }
+
+    writable = write;
+    qint64 offset = TrendFormat::headerSize;
+    for (int l = 0; l < levelCount; ++l) {
+        levelOffset[l] = offset;
+        offset += qint64(levelRowCounts[l]) * rowSize;
+        acc[l].stepStart = -1;
+    }
+    return true;
+}
+
+void TrendArchive::close()
+{
+    if (!base)
+        return;
+    // Keep the partial steps, a later frame of the same step continues them
+    if (writable) {
+        for (int l = 0; l < levelCount; ++l)
+            flush(l);
+    }
+    file.unmap(base);
+    base = nullptr;
+    file.close();
+}
+
+int TrendArchive::levelStep(int level) const
+{
+    return int(levelSteps[level]);
+}
+
+int TrendArchive::levelRows(int level) const
+{
+    return int(levelRowCounts[level]);
+}
+
+int TrendArchive::levelFor(qint64 spanS) const
+{
+    for (int l = 0; l < levelCount; ++l) {
+        if (spanS <= qint64(levelSteps[l]) * levelRowCounts[l] && spanS / levelSteps[l] <= 50000)
+            return l;
+    }
+    return levelCount - 1;
+}
+
+uchar *TrendArchive::row(int level, qint64 stepStart) const
+{
+    const qint64 index = (stepStart / levelSteps[level]) % levelRowCounts[level];
+    return base + levelOffset[level] + index * rowSize;
+}
+
+void TrendArchive::reset(Accumulator &a, qint64 stepStart)
+{
+    a.stepStart = stepStart;
+    for (int f = 0; f < fieldCount; ++f) {
+        a.min[f] = std::numeric_limits<float>::max();
+        a.max[f] = std::numeric_limits<float>::lowest();
+        a.sum[f] = 0.0;
+        a.count[f] = 0;
+    }
+}
+
+void TrendArchive::flush(int level)
+{
+    const Accumulator &a = acc[level];
+    if (a.stepStart < 0)
+        return;
+    uchar *r = row(level, a.stepStart);
+    qToLittleEndian<qint64>(a.stepStart, r);
+    float *values = reinterpret_cast<float *>(r + 8);
+    for (int f = 0; f < fieldCount; ++f) {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        float v[3] = {nan, nan, nan};
+        if (a.count[f]) {
+            v[0] = a.min[f];
+            v[1] = float(a.sum[f] / a.count[f]);
+            v[2] = a.max[f];
+        }
+        for (int k = 0; k < 3; ++k)
+            qToLittleEndian<float>(v[k], values + f * 4 + k);
+        qToLittleEndian<quint32>(a.count[f], values + f * 4 + 3);
+    }
+}
+
+void TrendArchive::resume(int level)
+{
+    // A row already stamped with the new step was written before a
+    // restart; carry on from it instead of overwriting it
+    Accumulator &a = acc[level];
+    const uchar *r = row(level, a.stepStart);
+    if (qFromLittleEndian<qint64>(r) != a.stepStart)
+        return;
+    const float *values = reinterpret_cast<const float *>(r + 8);
+    for (int f = 0; f < fieldCount; ++f) {
+        const quint32 count = qFromLittleEndian<quint32>(values + f * 4 + 3);
+        if (!count)
+            continue;
+        a.min[f] = qFromLittleEndian<float>(values + f * 4);
+        a.sum[f] = double(qFromLittleEndian<float>(values + f * 4 + 1)) * count;
+        a.max[f] = qFromLittleEndian<float>(values + f * 4 + 2);
+        a.count[f] = count;
+    }
+}
+
+void TrendArchive::addFrame(const LiveFrame &frame, qint64 epochUs)
+{
+    if (!base || !writable)
+        return;
+    const qint64 epochS = epochUs / 1000000;
+    for (int l = 0; l < levelCount; ++l) {
+        Accumulator &a = acc[l];
+        const qint64 stepStart = epochS - epochS % levelSteps[l];
+        if (stepStart != a.stepStart) {
+            flush(l);
+            reset(a, stepStart);
+            resume(l);
+        }
+        for (int f = 0; f < fieldCount; ++f) {
+            if (!frame.isValid(fields[f]))
+                continue;
+            const float v = float(frame.value(fields[f]));
+            a.min[f] = qMin(a.min[f], v);
+            a.max[f] = qMax(a.max[f], v);
+            a.sum[f] += v;
+            ++a.count[f];
+        }
+    }
+}
+
+QVector<TrendPoint> TrendArchive::read(int level, int fieldIndex, qint64 fromS, qint64 toS) const
+{
+    QVector<TrendPoint> points;
+    if (!base || level < 0 || level >= levelCount || fieldIndex < 0 || fieldIndex >= fieldCount)
+        return points;
+    const qint64 step = levelSteps[level];
+    // Both ends on step starts, or no stamp in the walk would ever match
+    const qint64 last = toS - toS % step;
+    fromS = qMax(fromS - fromS % step, last - step * (levelRowCounts[level] - 1));
+    points.reserve(int((toS - fromS) / step + 1));
+    for (qint64 t = fromS; t <= toS; t += step) {
+        const Accumulator &a = acc[level];
+        if (writable && t == a.stepStart) {
+            // Step still being filled
+            if (a.count[fieldIndex]) {
+                points.append({t, a.min[fieldIndex], float(a.sum[fieldIndex] / a.count[fieldIndex]),
+                               a.max[fieldIndex]});
+            }
+            continue;
+        }
+        const uchar *r = row(level, t);
+        if (qFromLittleEndian<qint64>(r) != t)
+            continue;
+        const float *values = reinterpret_cast<const float *>(r + 8) + fieldIndex * 4;
+        const TrendPoint p{t, qFromLittleEndian<float>(values), qFromLittleEndian<float>(values + 1),
+                           qFromLittleEndian<float>(values + 2)};
+        if (!std::isnan(p.avg))
+            points.append(p);
+    }
+    return points;
+}
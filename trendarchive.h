@@ -0,0 +1,75 @@
+// trendarchive.h
+#ifndef TRENDARCHIVE_H
+#define TRENDARCHIVE_H
+
+#include <QFile>
+#include <QVector>
+
+#include "liveframe.h"
+
+// Round-robin trend archive (RRD style). The file has a fixed size and
+// is memory-mapped; all little-endian:
+//   "LOOPTRND" quint32 version, quint32 fields, quint32 levels,
+//   per level: quint32 stepS, quint32 rows; padded to headerSize
+//   per level, rows of: qint64 stepStartS, per field float min, avg, max
+//   and quint32 count
+// The row of a step is (stepStart / stepS) % rows; a row whose stamp
+// does not match the step being read is from an older cycle and unused.
+// The count lets a restart continue a step written before it.
+namespace TrendFormat {
+const char magic[8] = {'L', 'O', 'O', 'P', 'T', 'R', 'N', 'D'};
+const quint32 version = 2;
+const int headerSize = 64;
+}
+
+struct TrendPoint {
+    qint64 timeS;
+    float  min;
+    float  avg;
+    float  max;
+};
+
+// Consolidates LIVE frames into 1 s, 1 min and 1 h min/avg/max rows of
+// the loop health fields. Each frame only updates running accumulators;
+// a row is written when its step is complete.
+class TrendArchive {
+public:
+    static const int fieldCount = 10;
+    static const int levelCount = 3;
+    static LiveField field(int index);
+
+    ~TrendArchive();
+
+    bool open(const QString &fileName, bool writable);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+    QString fileName() const { return file.fileName(); }
+
+    void addFrame(const LiveFrame &frame, qint64 epochUs);
+
+    int levelStep(int level) const;
+    int levelRows(int level) const;
+    int levelFor(qint64 spanS) const;   // finest level covering spanS in <= 50000 rows
+    QVector<TrendPoint> read(int level, int fieldIndex, qint64 fromS, qint64 toS) const;
+
+private:
+    struct Accumulator {
+        qint64  stepStart = -1;
+        float   min[fieldCount];
+        float   max[fieldCount];
+        double  sum[fieldCount];
+        quint32 count[fieldCount];
+    };
+    void reset(Accumulator &acc, qint64 stepStart);
+    void flush(int level);
+    void resume(int level);
+    uchar *row(int level, qint64 stepStart) const;
+
+    QFile  file;
+    uchar *base = nullptr;
+    bool   writable = false;
+    qint64 levelOffset[levelCount] = {};
+    Accumulator acc[levelCount];
+};
+
+#endif // TRENDARCHIVE_H
@@ -0,0 +1,167 @@
+// trenddialog.cpp
+#include "trenddialog.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <limits>
+
+TrendDialog::TrendDialog(TrendArchive *recording, QWidget *parent)
+    : QDialog(parent), recording(recording)
+{
+    setWindowTitle(tr("Loop Health Trends"));
+
+    fieldCombo = new QComboBox(this);
+    for (int f = 0; f < TrendArchive::fieldCount; ++f)
+        fieldCombo->addItem(liveFieldName(TrendArchive::field(f)));
+    connect(fieldCombo, &QComboBox::currentIndexChanged, this, &TrendDialog::refresh);
+
+    spanCombo = new QComboBox(this);
+    spanCombo->addItem(tr("Last hour"), 3600);
+    spanCombo->addItem(tr("Last day"), 86400);
+    spanCombo->addItem(tr("Last week"), 7 * 86400);
+    spanCombo->addItem(tr("Last month"), 31 * 86400);
+    spanCombo->addItem(tr("Last year"), 366 * 86400);
+    spanCombo->setCurrentIndex(1);
+    connect(spanCombo, &QComboBox::currentIndexChanged, this, &TrendDialog::refresh);
+
+    openBtn = new QPushButton(tr("Open..."), this);
+    connect(openBtn, &QPushButton::clicked, this, &TrendDialog::onOpenClicked);
+
+    infoLabel = new QLabel(this);
+
+    // The min..max band is drawn as an area between two line series
+    minSeries = new QLineSeries(this);
+    maxSeries = new QLineSeries(this);
+    auto *band = new QAreaSeries(maxSeries, minSeries);
+    band->setName(tr("Min..Max"));
+    band->setColor(QColor(100, 150, 255, 80));
+    band->setBorderColor(QColor(100, 150, 255, 120));
+    avgSeries = new QLineSeries;
+    avgSeries->setName(tr("Avg"));
+    avgSeries->setColor(QColor(0, 60, 200));
+
+    auto *chart = new QChart;
+    chart->addSeries(band);
+    chart->addSeries(avgSeries);
+    axisX = new QDateTimeAxis;
+    axisX->setFormat("dd.MM hh:mm");
+    axisY = new QValueAxis;
+    chart->addAxis(axisX, Qt::AlignBottom);
+    chart->addAxis(axisY, Qt::AlignLeft);
+    for (QAbstractSeries *series : chart->series()) {
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+    }
+    chartView = new QChartView(chart, this);
+    chartView->setRenderHint(QPainter::Antialiasing);
+
+    auto *controls = new QHBoxLayout;
+    controls->addWidget(new QLabel(tr("Field:"), this));
+    controls->addWidget(fieldCombo);
+    controls->addWidget(new QLabel(tr("Span:"), this));
+    controls->addWidget(spanCombo);
+    controls->addStretch();
+    controls->addWidget(infoLabel);
+    controls->addWidget(openBtn);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(controls);
+    mainLayout->addWidget(chartView);
+
+    setMinimumSize(900, 500);
+
+    // New steps only complete once a second
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(1000);
+    connect(refreshTimer, &QTimer::timeout, this, &TrendDialog::refresh);
+}
+
+const TrendArchive *TrendDialog::source() const
+{
+    if (opened.isOpen())
+        return &opened;
+    return recording->isOpen() ? recording : nullptr;
+}
+
+void TrendDialog::refresh()
+{
+    const TrendArchive *archive = source();
+    if (!archive) {
+        infoLabel->setText(tr("No archive"));
+        minSeries->clear();
+        maxSeries->clear();
+        avgSeries->clear();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 spanS = spanCombo->currentData().toLongLong();
+    const qint64 toS = QDateTime::currentSecsSinceEpoch();
+    const int level = archive->levelFor(spanS);
+    const QVector<TrendPoint> points = archive->read(level, fieldCombo->currentIndex(),
+                                                     toS - spanS, toS);
+
+    QList<QPointF> mins, maxs, avgs;
+    mins.reserve(points.size());
+    maxs.reserve(points.size());
+    avgs.reserve(points.size());
+    double lo = std::numeric_limits<double>::max();
+    double hi = std::numeric_limits<double>::lowest();
+    for (const TrendPoint &p : points) {
+        const double x = double(p.timeS) * 1000.0;
+        mins.append(QPointF(x, p.min));
+        maxs.append(QPointF(x, p.max));
+        avgs.append(QPointF(x, p.avg));
+        lo = qMin(lo, double(p.min));
+        hi = qMax(hi, double(p.max));
+    }
+    // replace() hands the series one block instead of a signal per point
+    minSeries->replace(mins);
+    maxSeries->replace(maxs);
+    avgSeries->replace(avgs);
+
+    axisX->setRange(QDateTime::fromSecsSinceEpoch(toS - spanS), QDateTime::fromSecsSinceEpoch(toS));
+    axisX->setFormat(spanS <= 86400 ? "hh:mm" : "dd.MM hh:mm");
+    if (points.isEmpty()) {
+        lo = 0.0;
+        hi = 1.0;
+    }
+    const double pad = qMax(1e-6, (hi - lo) * 0.05);
+    axisY->setRange(lo - pad, hi + pad);
+
+    const int step = archive->levelStep(level);
+    infoLabel->setText(tr("%1 | %2 points at %3 | %4 ms")
+                           .arg(archive == recording ? tr("recording") : archive->fileName())
+                           .arg(points.size())
+                           .arg(step < 60 ? tr("%1 s").arg(step)
+                                          : step < 3600 ? tr("%1 min").arg(step / 60)
+                                                        : tr("%1 h").arg(step / 3600))
+                           .arg(timer.elapsed()));
+}
+
+void TrendDialog::onOpenClicked()
+{
+    QString fn = QFileDialog::getOpenFileName(this, tr("Open Trend Archive"), QString(),
+                                              tr("Trend Archive (*.ltr)"));
+    if (fn.isEmpty())
+        return;
+    if (!opened.open(fn, false))
+        infoLabel->setText(tr("Not a trend archive: %1").arg(fn));
+    refresh();
+}
+
+void TrendDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    refresh();
+    refreshTimer->start();
+}
+
+void TrendDialog::hideEvent(QHideEvent *event)
+{
+    refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
@@ -0,0 +1,54 @@
+// trenddialog.h
+#ifndef TRENDDIALOG_H
+#define TRENDDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+#include <QtCharts/QAreaSeries>
+#include <QtCharts/QChartView>
+#include <QtCharts/QDateTimeAxis>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
+
+#include "trendarchive.h"
+
+// Min/avg/max trend of one field from a round-robin archive. Shows the
+// archive being recorded, or one opened read-only from disk.
+class TrendDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit TrendDialog(TrendArchive *recording, QWidget *parent = nullptr);
+
+public slots:
+    void refresh();
+
+private slots:
+    void onOpenClicked();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    const TrendArchive *source() const;
+
+    TrendArchive *recording;
+    TrendArchive  opened;       // read-only archive picked with Open
+    QComboBox    *fieldCombo;
+    QComboBox    *spanCombo;
+    QPushButton  *openBtn;
+    QLabel       *infoLabel;
+    QChartView   *chartView;
+    QLineSeries  *minSeries;
+    QLineSeries  *maxSeries;
+    QLineSeries  *avgSeries;
+    QDateTimeAxis *axisX;
+    QValueAxis   *axisY;
+    QTimer       *refreshTimer;
+};
+
+#endif // TRENDDIALOG_H
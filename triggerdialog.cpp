@@ -0,0 +1,204 @@
+// triggerdialog.cpp
+#include "triggerdialog.h"
+#include <QComboBox>
+#include <QDir>
+#include <QDoubleSpinBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <limits>
+
+TriggerDialog::TriggerDialog(TriggerEngine *engine, QWidget *parent)
+    : QDialog(parent), engine(engine)
+{
+    setWindowTitle(tr("Triggers"));
+
+    table = new QTableWidget(0, ColumnCount, this);
+    table->setHorizontalHeaderLabels({tr("On"), tr("Field"), tr("Condition"), tr("Level")});
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->horizontalHeader()->setSectionResizeMode(ColEnabled, QHeaderView::ResizeToContents);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    connect(table, &QTableWidget::itemChanged, this, &TriggerDialog::applyRules);
+
+    addBtn = new QPushButton(tr("Add"), this);
+    removeBtn = new QPushButton(tr("Remove"), this);
+    connect(addBtn, &QPushButton::clicked, this, &TriggerDialog::onAddClicked);
+    connect(removeBtn, &QPushButton::clicked, this, &TriggerDialog::onRemoveClicked);
+
+    preSpin = new QSpinBox(this);
+    preSpin->setRange(0, 100000);
+    preSpin->setValue(engine->preFrames());
+    preSpin->setSuffix(tr(" frames"));
+    postSpin = new QSpinBox(this);
+    postSpin->setRange(0, 100000);
+    postSpin->setValue(engine->postFrames());
+    postSpin->setSuffix(tr(" frames"));
+    // A new window reallocates the ring and drops a capture in progress,
+    // so it is applied once editing is done, not on every step
+    connect(preSpin, &QSpinBox::editingFinished, this, &TriggerDialog::applyWindow);
+    connect(postSpin, &QSpinBox::editingFinished, this, &TriggerDialog::applyWindow);
+
+    dirEdit = new QLineEdit(engine->outputDirectory(), this);
+    dirEdit->setPlaceholderText(QDir::currentPath());
+    connect(dirEdit, &QLineEdit::editingFinished, this, &TriggerDialog::applyRules);
+    browseBtn = new QPushButton(tr("Browse..."), this);
+    connect(browseBtn, &QPushButton::clicked, this, &TriggerDialog::onBrowseClicked);
+
+    armCheck = new QCheckBox(tr("Armed"), this);
+    armCheck->setChecked(engine->isArmed());
+    connect(armCheck, &QCheckBox::toggled, this, &TriggerDialog::onArmToggled);
+
+    statusLabel = new QLabel(this);
+
+    auto *dirLayout = new QHBoxLayout;
+    dirLayout->addWidget(dirEdit);
+    dirLayout->addWidget(browseBtn);
+
+    auto *form = new QFormLayout;
+    form->addRow(tr("Pre-trigger:"), preSpin);
+    form->addRow(tr("Post-trigger:"), postSpin);
+    form->addRow(tr("Capture folder:"), dirLayout);
+
+    auto *btnLayout = new QHBoxLayout;
+    btnLayout->addWidget(addBtn);
+    btnLayout->addWidget(removeBtn);
+    btnLayout->addStretch();
+    btnLayout->addWidget(statusLabel);
+    btnLayout->addWidget(armCheck);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(table);
+    mainLayout->addLayout(form);
+    mainLayout->addLayout(btnLayout);
+
+    setMinimumSize(700, 450);
+
+    connect(engine, &TriggerEngine::triggered, this, &TriggerDialog::onTriggered);
+    connect(engine, &TriggerEngine::captureSaved, this, &TriggerDialog::onCaptureSaved);
+
+    QVector<TriggerRule> rules = engine->rules();
+    if (rules.isEmpty()) {
+        // Typical intermittent faults; only the error flags start enabled
+        rules = {{false, FieldJump0, TriggerRising, 100.0},
+                 {false, FieldFreq0, TriggerRate, 1000.0},
+                 {false, FieldState0, TriggerChange, 0.0},
+                 {true, FieldOpen0, TriggerNonZero, 0.0},
+                 {true, FieldShort0, TriggerNonZero, 0.0}};
+    }
+    for (const TriggerRule &rule : rules)
+        addRow(rule);
+    applyRules();
+}
+
+void TriggerDialog::addRow(const TriggerRule &rule)
+{
+    const QSignalBlocker block(table);
+    const int row = table->rowCount();
+    table->insertRow(row);
+
+    auto *on = new QTableWidgetItem;
+    on->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable | Qt::ItemIsSelectable);
+    on->setCheckState(rule.enabled ? Qt::Checked : Qt::Unchecked);
+    table->setItem(row, ColEnabled, on);
+
+    auto *field = new QComboBox(table);
+    for (int i = 0; i < LiveFieldCount; ++i)
+        field->addItem(liveFieldName(i));
+    field->setCurrentIndex(rule.field);
+    connect(field, &QComboBox::currentIndexChanged, this, &TriggerDialog::applyRules);
+    table->setCellWidget(row, ColField, field);
+
+    auto *type = new QComboBox(table);
+    for (int i = 0; i < TriggerTypeCount; ++i)
+        type->addItem(triggerTypeName(i));
+    type->setCurrentIndex(rule.type);
+    connect(type, &QComboBox::currentIndexChanged, this, &TriggerDialog::applyRules);
+    table->setCellWidget(row, ColType, type);
+
+    auto *level = new QDoubleSpinBox(table);
+    level->setRange(-std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    level->setDecimals(2);
+    level->setValue(rule.level);
+    connect(level, &QDoubleSpinBox::valueChanged, this, &TriggerDialog::applyRules);
+    table->setCellWidget(row, ColLevel, level);
+}
+
+void TriggerDialog::applyRules()
+{
+    QVector<TriggerRule> rules;
+    for (int row = 0; row < table->rowCount(); ++row) {
+        TriggerRule rule;
+        rule.enabled = table->item(row, ColEnabled)->checkState() == Qt::Checked;
+        rule.field = static_cast<QComboBox *>(table->cellWidget(row, ColField))->currentIndex();
+        rule.type = TriggerType(static_cast<QComboBox *>(table->cellWidget(row, ColType))->currentIndex());
+        rule.level = static_cast<QDoubleSpinBox *>(table->cellWidget(row, ColLevel))->value();
+        rules.append(rule);
+    }
+    engine->setRules(rules);
+    engine->setOutputDirectory(dirEdit->text().trimmed());
+    updateStatus();
+}
+
+void TriggerDialog::applyWindow()
+{
+    if (preSpin->value() == engine->preFrames() && postSpin->value() == engine->postFrames())
+        return;
+    engine->setWindow(preSpin->value(), postSpin->value());
+    updateStatus();
+}
+
+void TriggerDialog::onAddClicked()
+{
+    addRow(TriggerRule());
+    applyRules();
+}
+
+void TriggerDialog::onRemoveClicked()
+{
+    const int row = table->currentRow();
+    if (row < 0)
+        return;
+    table->removeRow(row);
+    applyRules();
+}
+
+void TriggerDialog::onBrowseClicked()
+{
+    QString dir = QFileDialog::getExistingDirectory(this, tr("Capture Folder"), dirEdit->text());
+    if (dir.isEmpty())
+        return;
+    dirEdit->setText(dir);
+    applyRules();
+}
+
+void TriggerDialog::onArmToggled(bool checked)
+{
+    engine->setArmed(checked);
+    updateStatus();
+}
+
+void TriggerDialog::onTriggered(const QString &description)
+{
+    updateStatus(tr("triggered: %1").arg(description));
+}
+
+void TriggerDialog::onCaptureSaved(const QString &fileName, bool ok)
+{
+    updateStatus(ok ? tr("saved %1").arg(QFileInfo(fileName).fileName())
+                    : tr("failed to write %1").arg(fileName));
+}
+
+void TriggerDialog::updateStatus(const QString &last)
+{
+    QString text = tr("%1  captures %2  suppressed %3")
+                       .arg(engine->isArmed() ? tr("ARMED") : tr("off"))
+                       .arg(engine->captures())
+                       .arg(engine->suppressed());
+    if (!last.isEmpty())
+        text += "  " + last;
+    statusLabel->setText(text);
+}
@@ -0,0 +1,49 @@
+// triggerdialog.h
+#ifndef TRIGGERDIALOG_H
+#define TRIGGERDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QLabel>
+
+#include "triggerengine.h"
+
+// Edits the trigger rules and capture window and arms the engine
+class TriggerDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit TriggerDialog(TriggerEngine *engine, QWidget *parent = nullptr);
+
+private slots:
+    void onAddClicked();
+    void onRemoveClicked();
+    void onBrowseClicked();
+    void onArmToggled(bool checked);
+    void applyRules();
+    void applyWindow();
+    void onTriggered(const QString &description);
+    void onCaptureSaved(const QString &fileName, bool ok);
+
+private:
+    enum Column { ColEnabled, ColField, ColType, ColLevel, ColumnCount };
+    void addRow(const TriggerRule &rule);
+    void updateStatus(const QString &last = QString());
+
+    TriggerEngine *engine;
+    QTableWidget  *table;
+    QPushButton   *addBtn;
+    QPushButton   *removeBtn;
+    QSpinBox      *preSpin;
+    QSpinBox      *postSpin;
+    QLineEdit     *dirEdit;
+    QPushButton   *browseBtn;
+    QCheckBox     *armCheck;
+    QLabel        *statusLabel;
+};
+
+#endif // TRIGGERDIALOG_H
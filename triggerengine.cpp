@@ -0,0 +1,158 @@
+// triggerengine.cpp
+#include "triggerengine.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QtConcurrent>
+#include <cmath>
+
+QString triggerTypeName(int type)
+{
+    switch (type) {
+    case TriggerRising:  return QObject::tr("rises above");
+    case TriggerFalling: return QObject::tr("falls below");
+    case TriggerRate:    return QObject::tr("rate above (1/s)");
+    case TriggerChange:  return QObject::tr("changes");
+    case TriggerNonZero: return QObject::tr("becomes non-zero");
+    }
+    return QString();
+}
+
+QString describeTrigger(const TriggerRule &rule)
+{
+    QString text = liveFieldName(rule.field) + ' ' + triggerTypeName(rule.type);
+    if (rule.type <= TriggerRate)
+        text += ' ' + QString::number(rule.level);
+    return text;
+}
+
+TriggerEngine::TriggerEngine(QObject *parent)
+    : QObject(parent)
+{
+    setWindow(pre, post);
+}
+
+void TriggerEngine::setRules(const QVector<TriggerRule> &rules)
+{
+    ruleList = rules;
+}
+
+void TriggerEngine::setWindow(int preFrames, int postFrames)
+{
+    pre = qMax(0, preFrames);
+    post = qMax(0, postFrames);
+    quint64 size = 1;
+    while (size < quint64(pre + post + 1))
+        size <<= 1;
+    ring = QVector<LiveFrame>(int(size));
+    mask = size - 1;
+    written = 0;
+    triggerAt = -1;
+    havePrevious = false;
+}
+
+void TriggerEngine::setArmed(bool on)
+{
+    armed = on;
+    triggerAt = -1;
+    havePrevious = false;
+}
+
+bool TriggerEngine::evaluate(const TriggerRule &rule, const LiveFrame &frame) const
+{
+    const LiveField field = LiveField(rule.field);
+    if (!frame.isValid(field) || !previous.isValid(field))
+        return false;
+    const double cur = frame.value(field);
+    const double prev = previous.value(field);
+    switch (rule.type) {
+    case TriggerRising:
+        return prev < rule.level && cur >= rule.level;
+    case TriggerFalling:
+        return prev > rule.level && cur <= rule.level;
+    case TriggerRate: {
+        const double dt = (frame.hostTimeUs - previous.hostTimeUs) / 1e6;
+        return dt > 0 && std::abs(cur - prev) / dt >= rule.level;
+    }
+    case TriggerChange:
+        return cur != prev;
+    case TriggerNonZero:
+        return prev == 0 && cur != 0;
+    default:
+        return false;
+    }
+}
+
+void TriggerEngine::addFrame(const LiveFrame &frame)
+{
+    if (!armed)
+        return;
+    ring[int(written & mask)] = frame;
+    const qint64 index = qint64(written++);
+
+    if (havePrevious) {
+        for (const TriggerRule &rule : ruleList) {
+            if (!rule.enabled || !evaluate(rule, frame))
+                continue;
+            if (triggerAt >= 0) {
+                ++suppressedCount;
+            } else {
+                triggerAt = index;
+                triggerText = describeTrigger(rule);
+                emit triggered(triggerText);
+            }
+            break;
+        }
+    }
+    previous = frame;
+    havePrevious = true;
+
+    if (triggerAt >= 0 && index - triggerAt >= post)
+        finishCapture();
+}
+
+static bool writeCapture(const QString &fileName, const QString &description,
+                         const QVector<LiveFrame> &frames, int triggerIndex)
+{
+    QFile f(fileName);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream o(&f);
+    o << "#Trigger " << description << "\n";
+    o << "time_s,offset";
+    for (int i = 0; i < LiveFieldCount; ++i)
+        o << "," << liveFieldName(i);
+    o << ",seq\n";
+    const qint64 t0 = frames[triggerIndex].hostTimeUs;
+    for (int k = 0; k < frames.size(); ++k) {
+        const LiveFrame &fr = frames[k];
+        o << QString::number((fr.hostTimeUs - t0) / 1e6, 'f', 6) << "," << (k - triggerIndex);
+        for (int i = 0; i < LiveFieldCount; ++i)
+            o << "," << QString::number(fr.values[i], 'g', 12);
+        o << "," << fr.deviceSeq << "\n";
+    }
+    return true;
+}
+
+void TriggerEngine::finishCapture()
+{
+    // Copy the window out of the ring; the file is written off this thread
+    const qint64 first = qMax<qint64>(0, qMax<qint64>(triggerAt - pre, qint64(written) - ring.size()));
+    const qint64 last = qint64(written);
+    QVector<LiveFrame> frames;
+    frames.reserve(int(last - first));
+    for (qint64 i = first; i < last; ++i)
+        frames.append(ring[int(quint64(i) & mask)]);
+    const int triggerIndex = int(triggerAt - first);
+    triggerAt = -1;
+    ++captureCount;
+
+    const QString fileName = QDir(outputDir.isEmpty() ? QDir::currentPath() : outputDir)
+        .filePath(QString("trigger_%1_%2.csv")
+                      .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz"))
+                      .arg(captureCount));
+    const QString description = triggerText;
+    QtConcurrent::run(writeCapture, fileName, description, frames, triggerIndex)
+        .then(this, [this, fileName](bool ok) { emit captureSaved(fileName, ok); });
+}
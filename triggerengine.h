@@ -0,0 +1,83 @@
+// triggerengine.h
+#ifndef TRIGGERENGINE_H
+#define TRIGGERENGINE_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+
+#include "liveframe.h"
+
+enum TriggerType {
+    TriggerRising,      // crosses level upwards
+    TriggerFalling,     // crosses level downwards
+    TriggerRate,        // |change| per second reaches level
+    TriggerChange,      // any change of value (state transitions)
+    TriggerNonZero,     // becomes non-zero (open/short flags)
+    TriggerTypeCount
+};
+
+struct TriggerRule {
+    bool        enabled = true;
+    int         field = FieldFreq0;
+    TriggerType type = TriggerRising;
+    double      level = 0.0;
+};
+
+QString triggerTypeName(int type);
+QString describeTrigger(const TriggerRule &rule);
+
+// Oscilloscope-style capture of LIVE frames. Every frame goes into a
+// fixed ring written only by addFrame(), so no locking is needed. When a
+// rule fires, postFrames more frames are collected; the window around
+// the trigger is then copied out of the ring and written to its own CSV
+// file by a worker thread. Triggers during a running capture are counted
+// but do not start a new one.
+class TriggerEngine : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TriggerEngine(QObject *parent = nullptr);
+
+    void setRules(const QVector<TriggerRule> &rules);
+    const QVector<TriggerRule> &rules() const { return ruleList; }
+    void setWindow(int preFrames, int postFrames);
+    int preFrames() const { return pre; }
+    int postFrames() const { return post; }
+    void setOutputDirectory(const QString &dir) { outputDir = dir; }
+    QString outputDirectory() const { return outputDir; }
+
+    void setArmed(bool on);
+    bool isArmed() const { return armed; }
+    void addFrame(const LiveFrame &frame);
+
+    int captures() const { return captureCount; }
+    int suppressed() const { return suppressedCount; }
+
+signals:
+    void triggered(const QString &description);
+    void captureSaved(const QString &fileName, bool ok);
+
+private:
+    bool evaluate(const TriggerRule &rule, const LiveFrame &frame) const;
+    void finishCapture();
+
+    QVector<TriggerRule> ruleList;
+    QVector<LiveFrame> ring;        // power-of-two size
+    quint64 mask = 0;
+    quint64 written = 0;            // frames ever added
+    LiveFrame previous;
+    bool    havePrevious = false;
+
+    int     pre = 200;
+    int     post = 200;
+    QString outputDir;
+    bool    armed = false;
+
+    qint64  triggerAt = -1;         // frame number of a pending capture
+    QString triggerText;
+    int     captureCount = 0;
+    int     suppressedCount = 0;
+};
+
+#endif // TRIGGERENGINE_H
@@ -0,0 +1,222 @@
+// waterfallview.cpp
+#include "waterfallview.h"
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPainter>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+#include <cmath>
+
+WaterfallView::WaterfallView(QWidget *parent)
+    : QWidget(parent), image(columns, bins, QImage::Format_RGB32),
+      column(bins, 0), total(bins, 0)
+{
+    // Black - blue - red - yellow - white, indexed by log count
+    const QColor stops[] = {Qt::black, QColor(0, 0, 200), QColor(220, 0, 0),
+                            QColor(255, 220, 0), Qt::white};
+    for (int i = 0; i < 256; ++i) {
+        const double pos = i / 255.0 * 4.0;
+        const int s = qMin(3, int(pos));
+        const double f = pos - s;
+        const QColor &a = stops[s], &b = stops[s + 1];
+        palette[i] = qRgb(int(a.red() + (b.red() - a.red()) * f),
+                          int(a.green() + (b.green() - a.green()) * f),
+                          int(a.blue() + (b.blue() - a.blue()) * f));
+    }
+    image.fill(palette[0]);
+    setMinimumSize(400, 200);
+}
+
+void WaterfallView::clear()
+{
+    image.fill(palette[0]);
+    writeColumn = 0;
+    filledColumns = 0;
+    column.fill(0);
+    total.fill(0);
+    totalMax = 0;
+    seen = 0;
+    columnStartUs = -1;
+    update();
+}
+
+void WaterfallView::setLoop(int l)
+{
+    if (l == loop)
+        return;
+    loop = l;
+    clear();
+}
+
+void WaterfallView::setSpan(double hz)
+{
+    span = qMax(1.0, hz);
+    recenter();
+}
+
+void WaterfallView::setColumnSeconds(int seconds)
+{
+    columnUs = qint64(qMax(1, seconds)) * 1000000;
+}
+
+void WaterfallView::recenter()
+{
+    // Bins change meaning, so the history is no longer comparable
+    const double center = recent;
+    const int keep = seen;
+    clear();
+    if (keep >= warmupSamples) {
+        low = center - span / 2;
+        seen = warmupSamples;
+        recent = center;
+    }
+}
+
+int WaterfallView::binOf(double value) const
+{
+    // Values outside the range pile up in the edge bins
+    return qBound(0, int(std::floor((value - low) / span * bins)), bins - 1);
+}
+
+void WaterfallView::addFrame(const LiveFrame &frame)
+{
+    const LiveField field = loop == 0 ? FieldFreq0 : FieldFreq1;
+    if (frame.isValid(field))
+        addSample(frame.value(field), frame.hostTimeUs);
+}
+
+void WaterfallView::addSample(double value, qint64 timeUs)
+{
+    recent = seen == 0 ? value : recent + 0.05 * (value - recent);
+    if (++seen < warmupSamples)
+        return;
+    if (seen == warmupSamples)
+        low = recent - span / 2;
+
+    if (columnStartUs < 0)
+        columnStartUs = timeUs;
+    if (timeUs - columnStartUs >= columnUs) {
+        // Next slice: advance the ring instead of scrolling pixels. Slices
+        // without samples are left empty so gaps keep their length.
+        const qint64 elapsed = (timeUs - columnStartUs) / columnUs;
+        column.fill(0);
+        for (qint64 k = qMin<qint64>(elapsed, columns); k > 0; --k) {
+            writeColumn = (writeColumn + 1) % columns;
+            renderColumn();
+        }
+        filledColumns = int(qMin<qint64>(filledColumns + elapsed, columns - 1));
+        columnStartUs += columnUs * elapsed;
+    }
+
+    const int bin = binOf(value);
+    ++column[bin];
+    totalMax = qMax(totalMax, ++total[bin]);
+    renderColumn();
+    update();
+}
+
+void WaterfallView::renderColumn()
+{
+    quint32 max = 1;
+    for (quint32 c : column)
+        max = qMax(max, c);
+    const double scale = 255.0 / std::log1p(double(max));
+    for (int b = 0; b < bins; ++b) {
+        const int level = column[b] ? qMax(1, int(std::log1p(double(column[b])) * scale)) : 0;
+        // Row 0 is the top of the image, i.e. the highest bin
+        image.setPixel(writeColumn, bins - 1 - b, palette[level]);
+    }
+}
+
+void WaterfallView::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.fillRect(rect(), palette[0]);
+
+    const int histWidth = qMin(120, width() / 5);
+    const QRect area(50, 5, width() - histWidth - 55, height() - 25);
+    const QRect hist(area.right() + 5, area.top(), histWidth - 5, area.height());
+
+    // Oldest column on the left. Once the ring has wrapped, the older
+    // part sits at its end and the newer part runs up to writeColumn.
+    const int shown = filledColumns + 1;    // never more than the ring holds
+    const double colWidth = double(area.width()) / columns;
+    const int older = qMax(0, shown - (writeColumn + 1));
+    double x = area.right() + 1 - shown * colWidth;
+    if (older > 0) {
+        const QRectF src(columns - older, 0, older, bins);
+        p.drawImage(QRectF(x, area.top(), older * colWidth, area.height()), image, src);
+        x += older * colWidth;
+    }
+    const int newer = shown - older;
+    p.drawImage(QRectF(x, area.top(), newer * colWidth, area.height()), image,
+                QRectF(writeColumn + 1 - newer, 0, newer, bins));
+
+    // Session histogram
+    p.setPen(Qt::NoPen);
+    p.setBrush(QColor(0, 170, 0));
+    const double rowHeight = double(hist.height()) / bins;
+    for (int b = 0; b < bins && totalMax > 0; ++b) {
+        const double w = double(total[b]) / totalMax * hist.width();
+        p.drawRect(QRectF(hist.left(), hist.bottom() + 1 - (b + 1) * rowHeight, w, rowHeight));
+    }
+
+    p.setPen(Qt::white);
+    p.setBrush(Qt::NoBrush);
+    p.drawRect(area.adjusted(0, 0, -1, -1));
+    if (seen >= warmupSamples) {
+        p.drawText(QRect(0, area.top(), 48, 20), Qt::AlignRight | Qt::AlignTop,
+                   QString::number(low + span, 'f', 0));
+        p.drawText(QRect(0, area.bottom() - 20, 48, 20), Qt::AlignRight | Qt::AlignBottom,
+                   QString::number(low, 'f', 0));
+    }
+    p.drawText(QRect(area.left(), area.bottom() + 2, area.width(), 18), Qt::AlignLeft,
+               tr("-%1 s").arg(shown * columnUs / 1000000));
+    p.drawText(QRect(area.left(), area.bottom() + 2, area.width(), 18), Qt::AlignRight,
+               tr("now"));
+}
+
+WaterfallDock::WaterfallDock(QWidget *parent)
+    : QDockWidget(tr("Waterfall"), parent)
+{
+    setObjectName("waterfallDock");
+    auto *content = new QWidget(this);
+    waterfall = new WaterfallView(content);
+
+    auto *loopCombo = new QComboBox(content);
+    loopCombo->addItems({tr("Loop 1"), tr("Loop 2")});
+    connect(loopCombo, &QComboBox::currentIndexChanged, waterfall, &WaterfallView::setLoop);
+
+    auto *spanSpin = new QDoubleSpinBox(content);
+    spanSpin->setRange(1, 100000);
+    spanSpin->setDecimals(0);
+    spanSpin->setValue(200);
+    spanSpin->setSuffix(tr(" Hz"));
+    connect(spanSpin, &QDoubleSpinBox::valueChanged, waterfall, &WaterfallView::setSpan);
+
+    auto *sliceSpin = new QSpinBox(content);
+    sliceSpin->setRange(1, 3600);
+    sliceSpin->setValue(1);
+    sliceSpin->setSuffix(tr(" s"));
+    connect(sliceSpin, &QSpinBox::valueChanged, waterfall, &WaterfallView::setColumnSeconds);
+
+    auto *recenterBtn = new QPushButton(tr("Recenter"), content);
+    connect(recenterBtn, &QPushButton::clicked, waterfall, &WaterfallView::recenter);
+
+    auto *controls = new QHBoxLayout;
+    controls->addWidget(loopCombo);
+    controls->addWidget(new QLabel(tr("Span:"), content));
+    controls->addWidget(spanSpin);
+    controls->addWidget(new QLabel(tr("Slice:"), content));
+    controls->addWidget(sliceSpin);
+    controls->addWidget(recenterBtn);
+    controls->addStretch();
+
+    auto *layout = new QVBoxLayout(content);
+    layout->addLayout(controls);
+    layout->addWidget(waterfall, 1);
+    setWidget(content);
+}
@@ -0,0 +1,73 @@
+// waterfallview.h
+#ifndef WATERFALLVIEW_H
+#define WATERFALLVIEW_H
+
+#include <QWidget>
+#include <QDockWidget>
+#include <QImage>
+#include <QVector>
+
+#include "liveframe.h"
+
+// Frequency distribution of one loop over time. Each column of the
+// waterfall is the histogram of one time slice, coloured by count; the
+// bar chart on the right is the histogram of the whole session. Both are
+// updated per sample and the column is drawn into a ring QImage, so the
+// cost per frame is constant no matter how long the capture runs.
+class WaterfallView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit WaterfallView(QWidget *parent = nullptr);
+
+    void addFrame(const LiveFrame &frame);
+    void clear();
+
+public slots:
+    void setLoop(int loop);                 // 0 or 1
+    void setSpan(double hz);
+    void setColumnSeconds(int seconds);
+    void recenter();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void addSample(double value, qint64 timeUs);
+    void renderColumn();
+    int binOf(double value) const;
+
+    static const int bins = 128;
+    static const int columns = 600;
+    static const int warmupSamples = 20;
+
+    QImage image;               // columns x bins, used as a ring
+    int    writeColumn = 0;
+    int    filledColumns = 0;     // completed slices before writeColumn, < columns
+    QVector<quint32> column;    // counts of the slice being filled
+    QVector<quint64> total;     // counts of the whole session
+    quint64 totalMax = 0;
+    QRgb   palette[256];
+
+    int    loop = 0;
+    double span = 200.0;        // Hz covered by all bins
+    double low = 0.0;           // lower edge of bin 0
+    double recent = 0.0;        // EWMA of the value, for recentering
+    int    seen = 0;
+    qint64 columnUs = 1000000;
+    qint64 columnStartUs = -1;
+};
+
+// Dock holding a WaterfallView and its controls
+class WaterfallDock : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit WaterfallDock(QWidget *parent = nullptr);
+    WaterfallView *view() const { return waterfall; }
+
+private:
+    WaterfallView *waterfall;
+};
+
+#endif // WATERFALLVIEW_H